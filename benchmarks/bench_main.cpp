@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <jsoncpp/json/json.h>
+#include "benchmarks/bench_utils.h"
+#include "benchmarks/decode_bench.h"
+#include "benchmarks/render_bench.h"
+#include "src/common/buffers.h"
+#include "src/vstream/video_stream.h"
+
+namespace {
+
+const int kBENCHMARK_VERSION = 1;
+
+void usage() {
+    std::cerr <<
+        "usage: vcutter_bench [options]\n"
+        "  --suite NAME      decode, render or all (default all)\n"
+        "  --video PATH      benchmark an existing video instead of a synthetic clip\n"
+        "  --codec NAME      codec of the synthetic clip: webm, mp4-x264, mp4-x265 or mjpeg (default webm)\n"
+        "  --width N         width of the synthetic clip (default 1280)\n"
+        "  --height N        height of the synthetic clip (default 720)\n"
+        "  --frames N        frames of the synthetic clip (default 300)\n"
+        "  --gop N           key frame interval of the synthetic clip (default 30)\n"
+        "  --fps N           frame rate of the synthetic clip (default 30)\n"
+        "  --seeks N         random seeks (default 100)\n"
+        "  --priors N        prior() steps (default 60)\n"
+        "  --threads N       decoder threads (default 0, one by core)\n"
+        "  --thread-type T   decoder threading: auto, frame, slice or none (default auto)\n"
+        "  --convert-threads N  bands converted to rgb in parallel (default 1, 0 = one by core)\n"
+        "  --renders N       renders timed by render case (default 50)\n"
+        "  --output PATH     write the json results to PATH instead of the standard output\n";
+}
+
+bool parse_thread_type(const char *value, vs::decoder_thread_type *thread_type) {
+    const vs::decoder_thread_type types[] = {
+        vs::decoder_threads_auto, vs::decoder_threads_frame, vs::decoder_threads_slice, vs::decoder_threads_none
+    };
+    for (vs::decoder_thread_type type : types) {
+        if (strcmp(value, vs::decoder_thread_type_name(type)) == 0) {
+            *thread_type = type;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    vcutter::bench::clip_options_t clip;
+    clip.codec = "webm";
+    clip.w = 1280;
+    clip.h = 720;
+    clip.frames = 300;
+    clip.gop = 30;
+    clip.fps = 30;
+
+    vcutter::bench::decode_options_t decode;
+    decode.opens = 10;
+    decode.sequential = 0;
+    decode.seeks = 100;
+    decode.priors = 60;
+    decode.seed = 1;
+    decode.decoder = vs::default_decoder_options();
+
+    vcutter::bench::render_options_t render;
+    render.iterations = 50;
+    render.min_psnr = 45;
+    render.min_resized_psnr = 35;
+
+    std::string suite = "all";
+    std::string video_path;
+    std::string output_path;
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char *name = argv[i];
+        const char *value = argv[++i];
+        if (strcmp(name, "--suite") == 0) {
+            suite = value;
+        } else if (strcmp(name, "--video") == 0) {
+            video_path = value;
+        } else if (strcmp(name, "--codec") == 0) {
+            clip.codec = value;
+        } else if (strcmp(name, "--width") == 0) {
+            clip.w = atoi(value);
+        } else if (strcmp(name, "--height") == 0) {
+            clip.h = atoi(value);
+        } else if (strcmp(name, "--frames") == 0) {
+            clip.frames = atoi(value);
+        } else if (strcmp(name, "--gop") == 0) {
+            clip.gop = atoi(value);
+        } else if (strcmp(name, "--fps") == 0) {
+            clip.fps = atof(value);
+        } else if (strcmp(name, "--seeks") == 0) {
+            decode.seeks = atoi(value);
+        } else if (strcmp(name, "--priors") == 0) {
+            decode.priors = atoi(value);
+        } else if (strcmp(name, "--threads") == 0) {
+            decode.decoder.thread_count = atoi(value);
+        } else if (strcmp(name, "--convert-threads") == 0) {
+            decode.decoder.convert_threads = atoi(value);
+        } else if (strcmp(name, "--thread-type") == 0) {
+            if (!parse_thread_type(value, &decode.decoder.thread_type)) {
+                usage();
+                return 2;
+            }
+        } else if (strcmp(name, "--renders") == 0) {
+            render.iterations = atoi(value);
+        } else if (strcmp(name, "--output") == 0) {
+            output_path = value;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    bool run_decode = suite == "all" || suite == "decode";
+    bool run_render = suite == "all" || suite == "render";
+    if ((!run_decode && !run_render) || render.iterations < 1) {
+        usage();
+        return 2;
+    }
+
+    vs::initialize();
+
+    Json::Value results;
+    results["version"] = kBENCHMARK_VERSION;
+
+    bool synthetic = run_decode && video_path.empty();
+    if (synthetic) {
+        video_path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(
+            clip.codec == "webm" ? "vcutter-bench-%%%%%%.webm" : "vcutter-bench-%%%%%%.mp4")).string();
+
+        std::string error;
+        vcutter::bench::Stopwatch watch;
+        if (!vcutter::bench::generate_clip(clip, video_path, &error)) {
+            std::cerr << "could not generate the synthetic clip: " << error << "\n";
+            return 1;
+        }
+        results["clip"] = vcutter::bench::clip_options_json(clip);
+        results["clip"]["encoding_ms"] = watch.elapsed_ms();
+    } else if (run_decode) {
+        results["video"] = video_path;
+    }
+
+    if (run_decode) {
+        results["decode"] = vcutter::bench::decode_benchmark(video_path, decode);
+    }
+
+    if (run_render) {
+        results["render"] = vcutter::bench::render_benchmark(render);
+    }
+
+    vcutter::buffer_pool_stats_t pool = vcutter::buffer_pool()->stats();
+    results["buffer_pool"]["peak_bytes"] = Json::UInt64(pool.peak_bytes);
+    results["buffer_pool"]["allocations"] = Json::UInt64(pool.allocations);
+    results["buffer_pool"]["reuses"] = Json::UInt64(pool.reuses);
+
+    if (synthetic) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(video_path, ec);
+    }
+
+    Json::StyledWriter writer;
+    if (output_path.empty()) {
+        std::cout << writer.write(results);
+    } else {
+        std::ofstream output(output_path.c_str());
+        output << writer.write(results);
+        if (!output.good()) {
+            std::cerr << "could not write " << output_path << "\n";
+            return 1;
+        }
+    }
+
+    bool failed = run_decode && results["decode"].isMember("error");
+    for (const Json::Value& source : results["render"]) {
+        failed = failed || source.isMember("error");
+        for (const Json::Value& render_case : source["cases"]) {
+            failed = failed || !render_case["passed"].asBool();
+        }
+    }
+
+    return failed ? 1 : 0;
+}
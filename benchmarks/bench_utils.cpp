@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <algorithm>
+#include <numeric>
+#include "benchmarks/bench_utils.h"
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+namespace bench {
+
+namespace {
+
+double percentile(const samples_t& sorted, double rank) {
+    size_t index = static_cast<size_t>(rank * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+void fill_frame(uint32_t frame, uint32_t w, uint32_t h, std::vector<unsigned char> *buffer) {
+    // the pattern moves every frame, so the encoder can not skip the inter frames
+    unsigned char *pixel = &(*buffer)[0];
+    for (uint32_t y = 0; y < h; ++y) {
+        for (uint32_t x = 0; x < w; ++x) {
+            pixel[0] = (x + frame * 4) & 0xFF;
+            pixel[1] = (y + frame * 2) & 0xFF;
+            pixel[2] = ((x ^ y) + frame) & 0xFF;
+            pixel += 3;
+        }
+    }
+}
+
+}  // namespace
+
+Stopwatch::Stopwatch() {
+    restart();
+}
+
+void Stopwatch::restart() {
+    start_ = boost::chrono::steady_clock::now();
+}
+
+double Stopwatch::elapsed_ms() const {
+    return boost::chrono::duration<double, boost::milli>(boost::chrono::steady_clock::now() - start_).count();
+}
+
+Json::Value summarize(samples_t samples) {
+    Json::Value result;
+    result["count"] = static_cast<Json::UInt>(samples.size());
+
+    if (samples.empty()) {
+        return result;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    result["mean"] = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    result["min"] = samples.front();
+    result["p50"] = percentile(samples, 0.5);
+    result["p90"] = percentile(samples, 0.9);
+    result["p99"] = percentile(samples, 0.99);
+    result["max"] = samples.back();
+
+    return result;
+}
+
+Json::Value clip_options_json(const clip_options_t& options) {
+    Json::Value result;
+    result["codec"] = options.codec;
+    result["width"] = options.w;
+    result["height"] = options.h;
+    result["frames"] = options.frames;
+    result["gop"] = options.gop;
+    result["fps"] = options.fps;
+    return result;
+}
+
+bool generate_clip(const clip_options_t& options, const std::string& path, std::string *error) {
+    std::shared_ptr<vs::Encoder> encoder = vs::encoder(
+        options.codec.c_str(),
+        path.c_str(),
+        options.w,
+        options.h,
+        1000,
+        options.fps * 1000,
+        vs::Encoder::default_bitrate(options.codec.c_str(), options.w, options.h, options.fps),
+        NULL,
+        NULL,
+        NULL,
+        options.gop);
+
+    if (encoder->error()) {
+        *error = encoder->error();
+        return false;
+    }
+
+    std::vector<unsigned char> buffer(options.w * options.h * 3);
+    for (uint32_t i = 0; i < options.frames; ++i) {
+        fill_frame(i, options.w, options.h, &buffer);
+        if (!encoder->frame(&buffer[0])) {
+            *error = encoder->error() ? encoder->error() : "Could not encode the synthetic clip";
+            return false;
+        }
+    }
+
+    if (!encoder->finish()) {
+        *error = "Could not finish the synthetic clip";
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace bench
+}  // namespace vcutter
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef BENCHMARKS_BENCH_UTILS_H_
+#define BENCHMARKS_BENCH_UTILS_H_
+
+#include <inttypes.h>
+#include <string>
+#include <vector>
+#include <boost/chrono.hpp>
+#include <jsoncpp/json/json.h>
+
+namespace vcutter {
+namespace bench {
+
+typedef std::vector<double> samples_t;
+
+class Stopwatch {
+ public:
+    Stopwatch();
+    void restart();
+    double elapsed_ms() const;
+ private:
+    boost::chrono::steady_clock::time_point start_;
+};
+
+typedef struct {
+    std::string codec;  // one of vs::Encoder::format_names()
+    uint32_t w;
+    uint32_t h;
+    uint32_t frames;
+    uint32_t gop;       // key frame interval
+    double fps;
+} clip_options_t;
+
+// count, mean, min, max and the percentiles 50, 90 and 99 of the samples
+Json::Value summarize(samples_t samples);
+
+Json::Value clip_options_json(const clip_options_t& options);
+
+// encode a synthetic clip (moving gradients) with vs::encoder
+bool generate_clip(const clip_options_t& options, const std::string& path, std::string *error);
+
+}  // namespace bench
+}  // namespace vcutter
+
+#endif  // BENCHMARKS_BENCH_UTILS_H_
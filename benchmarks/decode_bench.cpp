@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <random>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include "benchmarks/bench_utils.h"
+#include "benchmarks/decode_bench.h"
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+namespace bench {
+
+namespace {
+
+const int kINDEX_WAIT_MS = 10000;
+
+Json::Value open_latency(const std::string& path, uint32_t opens, const vs::decoder_options_t& options) {
+    samples_t samples;
+    for (uint32_t i = 0; i < opens; ++i) {
+        Stopwatch watch;
+        std::shared_ptr<vs::Decoder> decoder = vs::open_file(path.c_str(), NULL, options);
+        samples.push_back(watch.elapsed_ms());
+    }
+    return summarize(samples);
+}
+
+Json::Value sequential(vs::Decoder *decoder, uint32_t frames, Json::Value *conversion, Json::Value *partial_conversion) {
+    samples_t conversion_samples;
+    samples_t partial_samples;
+    // a centered quarter of the frame, like a crop of a clipping
+    vs::frame_area_t area = {
+        static_cast<int>(decoder->w() / 4), static_cast<int>(decoder->h() / 4),
+        static_cast<int>(decoder->w() / 2), static_cast<int>(decoder->h() / 2)};
+    double decoding_ms = 0;
+    uint32_t decoded = 0;
+
+    decoder->seek_frame(1);
+    while (decoded < frames && decoder->position() < decoder->count()) {
+        uint32_t position = decoder->position();
+
+        Stopwatch watch;
+        decoder->next();
+        decoding_ms += watch.elapsed_ms();
+
+        if (decoder->position() == position) {
+            break;  // end of the video
+        }
+
+        watch.restart();
+        decoder->partial_frame(area);
+        partial_samples.push_back(watch.elapsed_ms());
+
+        watch.restart();
+        decoder->buffer();
+        conversion_samples.push_back(watch.elapsed_ms());
+
+        ++decoded;
+    }
+
+    *conversion = summarize(conversion_samples);
+    *partial_conversion = summarize(partial_samples);
+
+    Json::Value result;
+    result["frames"] = decoded;
+    result["milliseconds"] = decoding_ms;
+    result["fps"] = decoding_ms > 0 ? decoded * 1000.0 / decoding_ms : 0;
+    return result;
+}
+
+bool wait_keyframe_index(vs::Decoder *decoder, const std::string& index_path) {
+    for (int waited = 0; waited < kINDEX_WAIT_MS; waited += 50) {
+        if (decoder->save_keyframe_index(index_path.c_str())) {
+            return true;
+        }
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+Json::Value random_seeks(vs::Decoder *decoder, uint32_t seeks, uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<uint32_t> distribution(1, decoder->count() > 0 ? decoder->count() : 1);
+    samples_t samples;
+    uint32_t misses = 0;
+
+    for (uint32_t i = 0; i < seeks; ++i) {
+        uint32_t target = distribution(generator);
+        Stopwatch watch;
+        decoder->seek_frame(target);
+        samples.push_back(watch.elapsed_ms());
+        if (decoder->position() != target) {
+            ++misses;
+        }
+    }
+
+    Json::Value result = summarize(samples);
+    result["inaccurate"] = misses;  // seeks that did not reach the target frame
+    return result;
+}
+
+Json::Value prior_steps(vs::Decoder *decoder, uint32_t priors) {
+    samples_t samples;
+    decoder->seek_frame(decoder->count());
+
+    for (uint32_t i = 0; i < priors && decoder->position() > 1; ++i) {
+        Stopwatch watch;
+        decoder->prior();
+        samples.push_back(watch.elapsed_ms());
+    }
+
+    return summarize(samples);
+}
+
+}  // namespace
+
+Json::Value decode_benchmark(const std::string& path, const decode_options_t& options) {
+    Json::Value result;
+
+    result["open_ms"] = open_latency(path, options.opens, options.decoder);
+
+    // the seeks use the keyframe index, so it's built (and stored) before measuring them
+    std::string index_path = (boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("vcutter-bench-%%%%%%.keyframes")).string();
+
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(path.c_str(), index_path.c_str(), options.decoder);
+    if (decoder->error()) {
+        result["error"] = decoder->error();
+        return result;
+    }
+
+    result["frame_count"] = decoder->count();
+    result["width"] = decoder->w();
+    result["height"] = decoder->h();
+    result["thread_type"] = vs::decoder_thread_type_name(decoder->thread_type());
+    result["thread_count"] = decoder->thread_count();
+    result["convert_threads"] = options.decoder.convert_threads;
+
+    Json::Value conversion;
+    Json::Value partial_conversion;
+    result["sequential"] = sequential(
+        decoder.get(), options.sequential ? options.sequential : decoder->count(), &conversion, &partial_conversion);
+    result["conversion_ms"] = conversion;
+    result["partial_conversion_ms"] = partial_conversion;
+    result["keyframe_index"] = wait_keyframe_index(decoder.get(), index_path);
+    result["seek_ms"] = random_seeks(decoder.get(), options.seeks, options.seed);
+    result["prior_ms"] = prior_steps(decoder.get(), options.priors);
+
+    decoder.reset();
+    boost::system::error_code ec;
+    boost::filesystem::remove(index_path, ec);
+
+    return result;
+}
+
+}  // namespace bench
+}  // namespace vcutter
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef BENCHMARKS_DECODE_BENCH_H_
+#define BENCHMARKS_DECODE_BENCH_H_
+
+#include <inttypes.h>
+#include <string>
+#include <jsoncpp/json/json.h>
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+namespace bench {
+
+typedef struct {
+    uint32_t opens;       // how many times the video is opened
+    uint32_t sequential;  // frames decoded with next() (0 = the whole video)
+    uint32_t seeks;       // random frame accurate seeks
+    uint32_t priors;      // steps backwards from the end of the video
+    uint32_t seed;        // of the random seek targets
+    vs::decoder_options_t decoder;
+} decode_options_t;
+
+/*
+ * Measures the vs::Decoder operations: open latency, sequential decoding, random seeks,
+ * prior() steps and the color conversion done by buffer() (get_picture) after each next().
+ * The conversion of a centered quarter of the frame (partial_frame) is measured too.
+ */
+Json::Value decode_benchmark(const std::string& path, const decode_options_t& options);
+
+}  // namespace bench
+}  // namespace vcutter
+
+#endif  // BENCHMARKS_DECODE_BENCH_H_
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "benchmarks/mat_allocations.h"
+
+namespace vcutter {
+namespace bench {
+
+MatAllocationCounter::MatAllocationCounter() : allocations_(0) {
+    previous_ = cv::Mat::getDefaultAllocator();
+    cv::Mat::setDefaultAllocator(this);
+}
+
+MatAllocationCounter::~MatAllocationCounter() {
+    cv::Mat::setDefaultAllocator(previous_);
+}
+
+uint64_t MatAllocationCounter::allocations() const {
+    return allocations_.load();
+}
+
+void MatAllocationCounter::reset() {
+    allocations_ = 0;
+}
+
+cv::UMatData* MatAllocationCounter::allocate(
+    int dims, const int* sizes, int type, void* data, size_t* step, int flags, cv::UMatUsageFlags usage_flags
+) const {
+    // the mats that wrap an existing buffer do not allocate
+    if (!data) {
+        ++allocations_;
+    }
+    return previous_->allocate(dims, sizes, type, data, step, flags, usage_flags);
+}
+
+bool MatAllocationCounter::allocate(cv::UMatData* data, int access_flags, cv::UMatUsageFlags usage_flags) const {
+    return previous_->allocate(data, access_flags, usage_flags);
+}
+
+void MatAllocationCounter::deallocate(cv::UMatData* data) const {
+    previous_->deallocate(data);
+}
+
+}  // namespace bench
+}  // namespace vcutter
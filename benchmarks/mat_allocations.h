@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef BENCHMARKS_MAT_ALLOCATIONS_H_
+#define BENCHMARKS_MAT_ALLOCATIONS_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <opencv2/opencv.hpp>
+
+namespace vcutter {
+namespace bench {
+
+/*
+ * Counts the buffers cv::Mat allocates while it's alive (it replaces the default allocator).
+ */
+class MatAllocationCounter: public cv::MatAllocator {
+    MatAllocationCounter(const MatAllocationCounter&) = delete;
+    MatAllocationCounter& operator=(const MatAllocationCounter&) = delete;
+ public:
+    MatAllocationCounter();
+    virtual ~MatAllocationCounter();
+    uint64_t allocations() const;
+    void reset();
+
+    cv::UMatData* allocate(
+        int dims, const int* sizes, int type, void* data, size_t* step,
+        int flags, cv::UMatUsageFlags usage_flags) const override;
+    bool allocate(cv::UMatData* data, int access_flags, cv::UMatUsageFlags usage_flags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+ private:
+    cv::MatAllocator *previous_;
+    mutable std::atomic<uint64_t> allocations_;
+};
+
+}  // namespace bench
+}  // namespace vcutter
+
+#endif  // BENCHMARKS_MAT_ALLOCATIONS_H_
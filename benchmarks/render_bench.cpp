@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "benchmarks/bench_utils.h"
+#include "benchmarks/mat_allocations.h"
+#include "benchmarks/render_bench.h"
+#include "benchmarks/render_reference.h"
+#include "src/clippings/clipping_render.h"
+
+namespace vcutter {
+namespace bench {
+
+namespace {
+
+typedef struct {
+    uint32_t w;
+    uint32_t h;
+} frame_size_t;
+
+const frame_size_t kSOURCE_SIZES[] = {{640, 360}, {1280, 720}, {1920, 1080}};
+const frame_size_t kOUTPUT_SIZES[] = {{320, 240}, {640, 360}, {1080, 1080}};
+const double kANGLES[] = {0, 15, 90};
+const float kSCALES[] = {1.0, 0.5};
+const uint32_t kWARMUP_RENDERS = 3;
+
+Json::Value render_case(
+    ClippingRender *clipping, uint8_t *source, const frame_size_t& output_size, double angle, float scale,
+    const render_options_t& options
+) {
+    clipping->wh(output_size.w, output_size.h);
+
+    ClippingKey key;
+    key.frame = 1;
+    key.px = clipping->player()->info()->w() / 2;
+    key.py = clipping->player()->info()->h() / 2;
+    key.scale = scale;
+    key.angle(angle);
+
+    std::vector<uint8_t> expected(output_size.w * output_size.h * 3);
+    std::vector<uint8_t> buffer(expected.size());
+
+    reference_render(clipping, key, source, &expected[0]);
+
+    for (uint32_t i = 0; i < kWARMUP_RENDERS; ++i) {
+        clipping->render(key, source, &buffer[0]);
+    }
+
+    Json::Value result;
+    result["output_w"] = output_size.w;
+    result["output_h"] = output_size.h;
+    result["angle"] = angle;
+    result["scale"] = scale;
+    double min_psnr = angle != 0 && scale != 1 ? options.min_resized_psnr : options.min_psnr;
+    result["psnr"] = render_psnr(key, &expected[0], &buffer[0], output_size.w, output_size.h);
+    result["passed"] = result["psnr"].asDouble() >= min_psnr;
+
+    MatAllocationCounter counter;
+    Stopwatch watch;
+    for (uint32_t i = 0; i < options.iterations; ++i) {
+        clipping->render(key, source, &buffer[0]);
+    }
+    double elapsed_ms = watch.elapsed_ms();
+
+    result["ns_per_frame"] = elapsed_ms * 1000000.0 / options.iterations;
+    result["allocations_per_frame"] = static_cast<double>(counter.allocations()) / options.iterations;
+
+    return result;
+}
+
+}  // namespace
+
+Json::Value render_benchmark(const render_options_t& options) {
+    Json::Value results(Json::arrayValue);
+
+    for (const frame_size_t& source_size : kSOURCE_SIZES) {
+        clip_options_t clip;
+        clip.codec = "webm";
+        clip.w = source_size.w;
+        clip.h = source_size.h;
+        clip.frames = 2;
+        clip.gop = 1;
+        clip.fps = 30;
+
+        std::string path = (boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("vcutter-render-bench-%%%%%%.webm")).string();
+
+        Json::Value source;
+        source["source_w"] = source_size.w;
+        source["source_h"] = source_size.h;
+
+        std::string error;
+        if (!generate_clip(clip, path, &error)) {
+            source["error"] = error;
+            results.append(source);
+            continue;
+        }
+
+        {
+            std::unique_ptr<ClippingRender> clipping(new ClippingRender(path.c_str(), true, frame_callback_t()));
+            std::vector<uint8_t> frame = source_frame(clipping.get());
+            if (frame.empty()) {
+                source["error"] = "Could not decode the clip";
+            } else {
+                source["cases"] = Json::Value(Json::arrayValue);
+                for (const frame_size_t& output_size : kOUTPUT_SIZES) {
+                    for (double angle : kANGLES) {
+                        for (float scale : kSCALES) {
+                            source["cases"].append(render_case(
+                                clipping.get(), &frame[0], output_size, angle, scale, options));
+                        }
+                    }
+                }
+            }
+        }
+
+        boost::system::error_code ec;
+        boost::filesystem::remove(path, ec);
+
+        results.append(source);
+    }
+
+    return results;
+}
+
+}  // namespace bench
+}  // namespace vcutter
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef BENCHMARKS_RENDER_BENCH_H_
+#define BENCHMARKS_RENDER_BENCH_H_
+
+#include <inttypes.h>
+#include <jsoncpp/json/json.h>
+
+namespace vcutter {
+namespace bench {
+
+typedef struct {
+    uint32_t iterations;      // renders timed by case
+    double min_psnr;          // cases below it (dB) against the reference render are reported as failed
+    double min_resized_psnr;  // the same for the rotated and resized cases (the render interpolates once, the reference twice)
+} render_options_t;
+
+/*
+ * Renders a matrix of source sizes, output sizes, angles and scales with ClippingRender
+ * and reports the time and the cv::Mat allocations by frame of each case, and its psnr
+ * against reference_render.
+ */
+Json::Value render_benchmark(const render_options_t& options);
+
+}  // namespace bench
+}  // namespace vcutter
+
+#endif  // BENCHMARKS_RENDER_BENCH_H_
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <boost/thread.hpp>
+#include <opencv2/opencv.hpp>
+#include "benchmarks/render_reference.h"
+
+namespace vcutter {
+namespace bench {
+
+namespace {
+
+const int kLANCZOS_RADIUS = 4;
+
+void adjust_regions_of_interest(double scale, const cv::Mat& source, const cv::Mat& target, cv::Rect *roi_in,  cv::Rect *roi_out) {
+    if (roi_in->x < 0) {
+        roi_in->width += roi_in->x;
+        int x = scale * -roi_in->x;
+        roi_out->x = x;
+        roi_out->width -= x;
+        roi_in->x = 0;
+    }
+
+    if (roi_in->y < 0) {
+        roi_in->height += roi_in->y;
+        int y = scale * -roi_in->y;
+        roi_out->y = y;
+        roi_out->height -= y;
+        roi_in->y = 0;
+    }
+
+    if (roi_in->x + roi_in->width > source.cols) {
+        int pass_x = roi_in->x + roi_in->width - source.cols;
+        roi_in->width -= pass_x;
+        pass_x *= scale;
+        roi_out->width -= pass_x;
+    }
+
+    if (roi_in->y + roi_in->height > source.rows) {
+        int pass_y = roi_in->y + roi_in->height - source.rows;
+        roi_in->height -= pass_y;
+        pass_y *= scale;
+        roi_out->height -= pass_y;
+    }
+}
+
+void copy_center(cv::Mat& source, cv::Mat& target) {
+    int dx = source.cols - target.cols;
+    int dy = source.rows - target.rows;
+    cv::Rect roi_in(dx / 2, dy / 2, target.cols, target.rows);
+    cv::Rect roi_out(0, 0, target.cols, target.rows);
+    adjust_regions_of_interest(1.0, source, target, &roi_in, &roi_out);
+    if (roi_in.width < 1 || roi_in.height < 1 || roi_out.width < 1 || roi_out.height < 1)
+        return;
+    cv::Mat roi_img_in(source(roi_in));
+    cv::Mat roi_img_out(target(roi_out));
+    roi_img_in.copyTo(roi_img_out);
+}
+
+}  // namespace
+
+void reference_render(ClippingRender *clipping, ClippingKey key, uint8_t *source_buffer, uint8_t *buffer) {
+    int source_w = clipping->player()->info()->w();
+    int source_h = clipping->player()->info()->h();
+    int target_w = clipping->w();
+    int target_h = clipping->h();
+
+    key = key.constrained(clipping);
+
+    box_t bbox = key.clipping_box(clipping).occupied_area();
+
+    int bbox_w = bbox[1].x - bbox[0].x;
+    int bbox_h = bbox[2].y - bbox[0].y;
+
+    cv::Mat frame(source_h, source_w, CV_8UC3, source_buffer);
+    cv::Mat output(target_h, target_w, CV_8UC3, buffer);
+    if (key.angle() == 0) {
+        cv::Rect roi_input(bbox[0].x, bbox[0].y, bbox_w, bbox_h);
+        cv::Mat roi_img_in(frame(roi_input));
+
+        cv::resize(roi_img_in, output, output.size(), CV_INTER_LANCZOS4);
+        return;
+    }
+
+    int hypo = sqrt(bbox_w * bbox_w + bbox_h * bbox_h);
+    // zeros (the kernel leaves it uninitialized) keep the golden image deterministic
+    cv::Mat rotated = cv::Mat::zeros(hypo + 2, hypo + 2, CV_8UC3);
+
+    int half_w = bbox_w / 2;
+    int half_h = bbox_h / 2;
+    cv::Rect roi_input(key.px - half_w, key.py - half_h, bbox_w, bbox_h);
+
+    half_w = rotated.cols / 2;
+    half_h = rotated.rows / 2;
+    cv::Rect roi_output(half_w - bbox_w / 2, half_h - bbox_h / 2, bbox_w, bbox_h);
+
+    cv::Mat roi_img_in(frame(roi_input));
+    cv::Mat roi_img_out(rotated(roi_output));
+    roi_img_in.copyTo(roi_img_out);
+
+    cv::Point2f src_center(half_w, half_h);
+
+    cv::Mat rot_mat = cv::getRotationMatrix2D(src_center, key.angle() - 360, 1.0);
+    cv::Mat temp;
+    cv::warpAffine(rotated, temp, rot_mat, rotated.size(), CV_INTER_LANCZOS4);
+    rotated = cv::Mat(target_h * key.scale, target_w * key.scale, CV_8UC3);
+
+    copy_center(temp, rotated);
+
+    cv::resize(rotated, output, output.size(), CV_INTER_LANCZOS4);
+}
+
+double psnr(const uint8_t *buffer1, const uint8_t *buffer2, uint32_t w, uint32_t h) {
+    cv::Mat image1(h, w, CV_8UC3, const_cast<uint8_t *>(buffer1));
+    cv::Mat image2(h, w, CV_8UC3, const_cast<uint8_t *>(buffer2));
+    return cv::PSNR(image1, image2);
+}
+
+double render_psnr(ClippingKey key, const uint8_t *expected, const uint8_t *rendered, uint32_t w, uint32_t h) {
+    if (key.angle() == 0 || w <= 4 * kLANCZOS_RADIUS || h <= 4 * kLANCZOS_RADIUS) {
+        return psnr(expected, rendered, w, h);
+    }
+    cv::Mat image1(h, w, CV_8UC3, const_cast<uint8_t *>(expected));
+    cv::Mat image2(h, w, CV_8UC3, const_cast<uint8_t *>(rendered));
+    cv::Rect inner(kLANCZOS_RADIUS, kLANCZOS_RADIUS, w - 2 * kLANCZOS_RADIUS, h - 2 * kLANCZOS_RADIUS);
+    return cv::PSNR(image1(inner), image2(inner));
+}
+
+std::vector<uint8_t> source_frame(ClippingRender *clipping) {
+    // the player thread presents the frame once the video is open, at full size while the display size is not set
+    vs::frame_ref_t frame = clipping->player()->display_frame();
+    for (int i = 0; i < 5000 && !frame; ++i) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+        frame = clipping->player()->display_frame();
+    }
+    if (!frame) {
+        return std::vector<uint8_t>();
+    }
+    return std::vector<uint8_t>(frame->data(), frame->data() + frame->w() * frame->h() * 3);
+}
+
+}  // namespace bench
+}  // namespace vcutter
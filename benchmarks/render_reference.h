@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef BENCHMARKS_RENDER_REFERENCE_H_
+#define BENCHMARKS_RENDER_REFERENCE_H_
+
+#include <inttypes.h>
+#include <vector>
+#include "src/clippings/clipping_render.h"
+
+namespace vcutter {
+namespace bench {
+
+/*
+ * The render kernel as it was before any optimization (crop + resize, or copy to a square,
+ * warpAffine, copy to the center and resize). Its output is the golden image of the render checks.
+ * Do not optimize it.
+ */
+void reference_render(ClippingRender *clipping, ClippingKey key, uint8_t *source_buffer, uint8_t *buffer);
+
+// peak signal-to-noise ratio (dB) of two w x h rgb buffers
+double psnr(const uint8_t *buffer1, const uint8_t *buffer2, uint32_t w, uint32_t h);
+
+// psnr of a render against reference_render. the border the lanczos kernel reaches is ignored when the key is rotated:
+// the reference pads the bounding box with black and the render samples the frame around it
+double render_psnr(ClippingKey key, const uint8_t *expected, const uint8_t *rendered, uint32_t w, uint32_t h);
+
+// a copy of the first frame of the video in rgb (empty when the player does not present it)
+std::vector<uint8_t> source_frame(ClippingRender *clipping);
+
+}  // namespace bench
+}  // namespace vcutter
+
+#endif  // BENCHMARKS_RENDER_REFERENCE_H_
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <boost/chrono.hpp>
+#include "src/cli/batch_converter.h"
+#include "src/cli/console_progress.h"
+#include "src/clippings/clipping.h"
+#include "src/clippings/clipping_conversion.h"
+#include "src/data/json_file.h"
+
+namespace vcutter {
+
+namespace {
+
+const uint32_t kMAX_CONVERSION_MEMORY = 419430400;
+
+}  // namespace
+
+const char *job_status_name(job_status_t status) {
+    switch (status) {
+        case job_status_ok:
+            return "ok";
+        case job_status_canceled:
+            return "canceled";
+        default:
+            return "failed";
+    }
+}
+
+BatchConverter::BatchConverter(uint32_t workers, std::atomic_bool *canceled) {
+    workers_ = workers > 0 ? workers : 1;
+    canceled_ = canceled;
+    render_threads_ = ClippingPipeline::default_render_threads() / workers_;
+    if (render_threads_ < 1) {
+        render_threads_ = 1;
+    }
+    // a single worker lets the codec and the rgb conversion pick their threads
+    encoder_threads_ = workers_ > 1 ? std::max(1u, boost::thread::hardware_concurrency() / workers_) : 0;
+    convert_threads_ = encoder_threads_;
+}
+
+void BatchConverter::on_job_finished(std::function<void(const conversion_job_t& job, const job_result_t& result)> cb) {
+    finished_cb_ = cb;
+}
+
+boost::mutex *BatchConverter::output_mutex() {
+    return &output_mtx_;
+}
+
+std::vector<job_result_t> BatchConverter::run(const std::vector<conversion_job_t>& jobs) {
+    std::vector<job_result_t> results(jobs.size());
+    std::atomic<uint32_t> next_job(0);
+    std::vector<std::shared_ptr<boost::thread> > threads;
+
+    for (uint32_t i = 0; i < workers_ && i < jobs.size(); ++i) {
+        threads.push_back(std::shared_ptr<boost::thread>(new boost::thread([this, &jobs, &results, &next_job] () {
+            for (uint32_t job = next_job++; job < jobs.size(); job = next_job++) {
+                results[job] = convert(jobs[job]);
+                if (finished_cb_) {
+                    boost::lock_guard<boost::mutex> lock(output_mtx_);
+                    finished_cb_(jobs[job], results[job]);
+                }
+            }
+        })));
+    }
+
+    for (auto & t : threads) {
+        t->join();
+    }
+
+    return results;
+}
+
+job_result_t BatchConverter::convert(const conversion_job_t& job) {
+    auto start = boost::chrono::steady_clock::now();
+
+    job_result_t result;
+    result.status = job_status_failed;
+    result.frames = 0;
+    result.seconds = 0;
+    memset(&result.stats, 0, sizeof(result.stats));
+
+    if (canceled_->load()) {
+        result.status = job_status_canceled;
+        return result;
+    }
+
+    std::shared_ptr<ClippingRender> clipping;
+    if (JsonFile(job.project_path.c_str()).loaded()) {
+        clipping.reset(new Clipping(job.project_path.c_str(), false, frame_callback_t()));
+    }
+
+    if (!clipping) {
+        result.error = "Could not load the project";
+    } else if (!clipping->good()) {
+        result.error = "Could not open the video of the project";
+    } else {
+        double fps = job.fps > 0 ? job.fps : clipping->player()->info()->fps();
+        uint32_t bitrate = job.bitrate;
+        if (bitrate == 0) {
+            bitrate = vs::Encoder::default_bitrate(job.format.c_str(), clipping->w(), clipping->h(), fps);
+        }
+
+        clipping->player()->convert_threads(convert_threads_);
+
+        std::shared_ptr<ProgressHandler> progress(new ConsoleProgress(job.project_path, canceled_, &output_mtx_));
+        ClippingConversion conversion(progress, clipping, kMAX_CONVERSION_MEMORY);
+        conversion.render_threads(render_threads_);
+        conversion.spill_compression(job.spill_compression);
+
+        vs::encoder_options_t encoder_options;
+        encoder_options.profile = job.profile;
+        encoder_options.thread_count = encoder_threads_;
+        conversion.encoder_options(encoder_options);
+
+        bool converted = conversion.convert(job.format.c_str(), job.output_path.c_str(), bitrate, fps);
+
+        result.frames = clipping->duration_frames();
+        result.stats = conversion.stats();
+        if (canceled_->load()) {
+            result.status = job_status_canceled;
+        } else if (!converted || conversion.error()) {
+            result.error = conversion.error() ? conversion.error() : "The conversion failed";
+        } else {
+            result.status = job_status_ok;
+        }
+    }
+
+    result.seconds = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+}  // namespace vcutter
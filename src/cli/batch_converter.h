@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_CLI_BATCH_CONVERTER_H_
+#define SRC_CLI_BATCH_CONVERTER_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "src/clippings/clipping_pipeline.h"
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+typedef struct {
+    std::string project_path;
+    std::string output_path;
+    std::string format;
+    uint32_t bitrate;  // 0 = estimated from the format
+    double fps;        // 0 = the frame rate of the video
+    vs::encoder_profile profile;
+    bool spill_compression;  // compress the frames the reverse exports spill to disk
+} conversion_job_t;
+
+typedef enum {
+    job_status_ok = 0,
+    job_status_failed = 1,
+    job_status_canceled = 2
+} job_status_t;
+
+typedef struct {
+    job_status_t status;
+    std::string error;
+    uint32_t frames;
+    double seconds;
+    pipeline_stats_t stats;  // the time each stage of the conversion took
+} job_result_t;
+
+const char *job_status_name(job_status_t status);
+
+/*
+ * Converts the projects in a pool of workers. Each worker owns the player and the
+ * conversion of its current project, the render, the rgb conversion and the encoder threads are shared among the workers.
+ */
+class BatchConverter {
+    BatchConverter(const BatchConverter&) = delete;
+    BatchConverter& operator=(const BatchConverter&) = delete;
+ public:
+    BatchConverter(uint32_t workers, std::atomic_bool *canceled);
+    virtual ~BatchConverter() {}
+    // the results follow the order of the jobs
+    std::vector<job_result_t> run(const std::vector<conversion_job_t>& jobs);
+    // called (under the output lock) as soon as a job finishes
+    void on_job_finished(std::function<void(const conversion_job_t& job, const job_result_t& result)> cb);
+    boost::mutex *output_mutex();
+ private:
+    job_result_t convert(const conversion_job_t& job);
+ private:
+    uint32_t workers_;
+    uint32_t render_threads_;
+    int encoder_threads_;
+    int convert_threads_;
+    std::atomic_bool *canceled_;
+    boost::mutex output_mtx_;
+    std::function<void(const conversion_job_t& job, const job_result_t& result)> finished_cb_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_CLI_BATCH_CONVERTER_H_
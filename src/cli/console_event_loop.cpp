@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <boost/thread.hpp>
+#include "src/common/event_loop.h"
+
+namespace vcutter {
+
+void wait_events(double timeout) {
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(static_cast<int64_t>(timeout * 1000)));
+}
+
+// there is no ui to refresh: the players of the command line tool have no frame callbacks
+// and it does not keep clipping sessions.
+
+void add_timeout(double timeout, timeout_handler_t handler, void *data) {
+}
+
+void repeat_timeout(double timeout, timeout_handler_t handler, void *data) {
+}
+
+void remove_timeout(timeout_handler_t handler, void *data) {
+}
+
+void add_check(timeout_handler_t handler, void *data) {
+}
+
+void remove_check(timeout_handler_t handler, void *data) {
+}
+
+void awake() {
+}
+
+}  // namespace vcutter
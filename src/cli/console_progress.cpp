@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <iostream>
+#include <jsoncpp/json/json.h>
+#include "src/cli/console_progress.h"
+
+namespace vcutter {
+
+namespace {
+
+const int kREPORT_STEP = 10;
+
+}  // namespace
+
+ConsoleProgress::ConsoleProgress(const std::string& name, std::atomic_bool *canceled, boost::mutex *output_mtx) {
+    name_ = name;
+    canceled_ = canceled;
+    output_mtx_ = output_mtx;
+    last_percent_ = -kREPORT_STEP;
+}
+
+bool ConsoleProgress::wait(progress_task_t task) {
+    last_percent_ = -kREPORT_STEP;
+    return task();
+}
+
+bool ConsoleProgress::canceled() {
+    return canceled_->load();
+}
+
+void ConsoleProgress::set_buffer(uint8_t *buffer, uint32_t w, uint32_t h) {
+}
+
+void ConsoleProgress::set_progress(uint32_t progress, uint32_t max_progress) {
+    if (max_progress < 1) {
+        return;
+    }
+
+    int percent = (static_cast<uint64_t>(progress) * 100) / max_progress;
+    if (percent < last_percent_ + kREPORT_STEP) {
+        return;
+    }
+
+    last_percent_ = percent - percent % kREPORT_STEP;
+
+    Json::Value line;
+    line["project"] = name_;
+    line["progress"] = percent;
+
+    Json::FastWriter writer;
+    boost::lock_guard<boost::mutex> lock(*output_mtx_);
+    std::cerr << writer.write(line) << std::flush;
+}
+
+}  // namespace vcutter
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_CLI_CONSOLE_PROGRESS_H_
+#define SRC_CLI_CONSOLE_PROGRESS_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <string>
+#include <boost/thread.hpp>
+#include "src/clippings/clipping_conversion.h"
+
+namespace vcutter {
+
+/*
+ * Reports the progress of a conversion to the standard error as json lines (every 10%).
+ */
+class ConsoleProgress: public ProgressHandler {
+ public:
+    ConsoleProgress(const std::string& name, std::atomic_bool *canceled, boost::mutex *output_mtx);
+    virtual ~ConsoleProgress() {}
+    bool wait(progress_task_t task) override;
+    bool canceled() override;
+    void set_buffer(uint8_t *buffer, uint32_t w, uint32_t h) override;
+    void set_progress(uint32_t progress, uint32_t max_progress) override;
+ private:
+    std::string name_;
+    std::atomic_bool *canceled_;
+    boost::mutex *output_mtx_;
+    int last_percent_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_CLI_CONSOLE_PROGRESS_H_
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <jsoncpp/json/json.h>
+#include "src/cli/batch_converter.h"
+#include "src/vstream/video_stream.h"
+
+namespace {
+
+const int kEXIT_SUCCESS = 0;
+const int kEXIT_JOB_FAILED = 1;
+const int kEXIT_USAGE = 2;
+
+std::atomic_bool canceled(false);
+
+void cancel_handler(int signal) {
+    canceled = true;
+}
+
+void usage() {
+    std::cerr <<
+        "usage: vcutter-cli [options] project.vcutter [project.vcutter ...]\n"
+        "  --workers N       projects converted at the same time (default 1)\n"
+        "  --format NAME     webm, mp4-x264, mp4-x265 or mjpeg (default webm)\n"
+        "  --fps N           frame rate of the videos (default: the frame rate of the source)\n"
+        "  --bitrate N       bitrate in Mbit/s (default: estimated from the format)\n"
+        "  --profile NAME    encoder speed: draft, balanced or archival (default archival)\n"
+        "  --output-dir DIR  where the videos are written (default: next to the projects)\n"
+        "  --compress-spill  compress the frames the reverse exports spill to disk\n"
+        "one json line is written to the standard output for each project.\n"
+        "the exit code is 0 when every project was converted, 1 when some failed and 2 on invalid arguments.\n";
+}
+
+Json::Value stage_json(const vcutter::stage_stats_t& stats) {
+    Json::Value stage;
+    stage["frames"] = stats.frames;
+    stage["busy_seconds"] = stats.busy_seconds;
+    stage["fps"] = vcutter::stage_fps(stats);
+    return stage;
+}
+
+bool valid_format(const std::string& format) {
+    for (const char **name = vs::Encoder::format_names(); *name; ++name) {
+        if (format == *name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_profile(const std::string& name, vs::encoder_profile *profile) {
+    const char **names = vs::encoder_profile_names();
+    for (int i = 0; names[i]; ++i) {
+        if (name == names[i]) {
+            *profile = static_cast<vs::encoder_profile>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string output_path(const std::string& project_path, const std::string& output_dir, const std::string& format) {
+    boost::filesystem::path path(project_path);
+    path.replace_extension(format == "webm" ? ".webm" : ".mp4");
+    if (!output_dir.empty()) {
+        path = boost::filesystem::path(output_dir) / path.filename();
+    }
+    return path.string();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    uint32_t workers = 1;
+    std::string format = "webm";
+    std::string output_dir;
+    double fps = 0;
+    double bitrate = 0;
+    vs::encoder_profile profile = vs::default_encoder_options().profile;
+    bool spill_compression = false;
+    std::vector<std::string> projects;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--workers") == 0 && has_value) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && has_value) {
+            format = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && has_value) {
+            fps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--bitrate") == 0 && has_value) {
+            bitrate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0 && has_value) {
+            if (!parse_profile(argv[++i], &profile)) {
+                usage();
+                return kEXIT_USAGE;
+            }
+        } else if (strcmp(argv[i], "--output-dir") == 0 && has_value) {
+            output_dir = argv[++i];
+        } else if (strcmp(argv[i], "--compress-spill") == 0) {
+            spill_compression = true;
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            usage();
+            return kEXIT_USAGE;
+        } else {
+            projects.push_back(argv[i]);
+        }
+    }
+
+    if (projects.empty() || workers < 1 || fps < 0 || bitrate < 0 || !valid_format(format)) {
+        usage();
+        return kEXIT_USAGE;
+    }
+
+    vs::initialize();
+
+    signal(SIGINT, cancel_handler);
+    signal(SIGTERM, cancel_handler);
+
+    std::vector<vcutter::conversion_job_t> jobs;
+    for (const auto & project : projects) {
+        vcutter::conversion_job_t job;
+        job.project_path = project;
+        job.output_path = output_path(project, output_dir, format);
+        job.format = format;
+        job.bitrate = bitrate * 1048576;
+        job.fps = fps;
+        job.profile = profile;
+        job.spill_compression = spill_compression;
+        jobs.push_back(job);
+    }
+
+    vcutter::BatchConverter converter(workers, &canceled);
+
+    converter.on_job_finished([] (const vcutter::conversion_job_t& job, const vcutter::job_result_t& result) {
+        Json::Value line;
+        line["project"] = job.project_path;
+        line["output"] = job.output_path;
+        line["status"] = vcutter::job_status_name(result.status);
+        line["frames"] = result.frames;
+        line["seconds"] = result.seconds;
+        // the frames a single thread of each stage handles by second: the slowest one limits the conversion
+        line["decode"] = stage_json(result.stats.decode);
+        line["render"] = stage_json(result.stats.render);
+        line["encode"] = stage_json(result.stats.encode);
+        if (!result.error.empty()) {
+            line["error"] = result.error;
+        }
+
+        Json::FastWriter writer;
+        std::cout << writer.write(line) << std::flush;
+    });
+
+    std::vector<vcutter::job_result_t> results = converter.run(jobs);
+
+    for (const auto & result : results) {
+        if (result.status != vcutter::job_status_ok) {
+            return kEXIT_JOB_FAILED;
+        }
+    }
+
+    return kEXIT_SUCCESS;
+}
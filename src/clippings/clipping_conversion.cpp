@@ -1,12 +1,13 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <math.h>
 #include <string.h>
+#include <boost/thread.hpp>
 #include <opencv2/opencv.hpp>
 #include <opencv2/video/video.hpp>
-#include <Fl/Fl.H>
 #include "src/clippings/clipping_conversion.h"
-#include "src/wnd_common/common_dialogs.h"
+#include "src/common/event_loop.h"
 #include "src/common/utils.h"
 
 namespace vcutter {
@@ -25,12 +26,16 @@ ClippingConversion::ClippingConversion(
     prog_handler_ = prog_handler;
     current_position_.store(0);
     max_position_ = 1;
-    last_encoded_buffer_.store(NULL);
+    preview_published_ = false;
     current_alpha_ = 1.0;
     alpha_increment_ = 0;
     author_ = author ? author : "";
     title_ = title ? title : "";
     tags_ = tags ? tags : "";
+    render_threads_ = ClippingPipeline::default_render_threads();
+    spill_compression_ = false;
+    encoder_options_ = vs::default_encoder_options();
+    memset(&stats_, 0, sizeof(stats_));
 }
 
 
@@ -44,22 +49,38 @@ bool ClippingConversion::prepare_conversion(
     current_position_.store(0);
     max_position_ = clipping_->duration_frames() * (append_reverse ? 2 : 1);
     transitions_.clear();
-    last_encoded_buffer_.store(NULL);
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_preview_);
+        preview_published_ = false;
+    }
+    preview_.reset();
+    memset(&stats_, 0, sizeof(stats_));
 
     encoder_ = vs::encoder(codec, path, clipping_->w(), clipping_->h(), 1000, fps * 1000, bitrate,
-                           title_.c_str(), author_.c_str(), tags_.c_str());
+                           title_.c_str(), author_.c_str(), tags_.c_str(), 0, encoder_options_);
 
     if (encoder_->error()) {
         error_ = encoder_->error();
         return false;
     } else {
-        clip_iter_.reset(new ClippingIterator(clipping_.get(), max_memory_));
+        clip_iter_.reset(new ClippingIterator(clipping_.get(), max_memory_, render_threads_));
+        clip_iter_->yuv_output(encoder_->accepts_yuv());
+        clip_iter_->spill_compression(spill_compression_);
     }
 
     return true;
 }
 
 void ClippingConversion::unprepare_conversion() {
+    if (clip_iter_) {
+        stats_ = clip_iter_->stats();
+        if (clip_iter_->error()) {
+            error_ = clip_iter_->error();
+        }
+    }
+    if (encoder_ && encoder_->error() && error_.empty()) {
+        error_ = encoder_->error();
+    }
     encoder_.reset();
     clip_iter_.reset();
 }
@@ -77,6 +98,15 @@ bool ClippingConversion::convert(
         transition_frames = 0;
     }
 
+    if (from_start && !append_reverse && transition_frames == 0 && is_plain_trim(fps)) {
+        // the groups of pictures inside the range are copied without decoding them
+        bool remuxed = false;
+        bool result = remux(codec, path, &remuxed);
+        if (remuxed || prog_handler_->canceled()) {
+            return result;
+        }
+    }
+
     if (prepare_conversion(codec, path, bitrate, fps, append_reverse)) {
         start_conversion(from_start, append_reverse, transition_frames);
 
@@ -89,7 +119,16 @@ bool ClippingConversion::convert(
 void ClippingConversion::start_conversion(bool from_start, bool append_reverse, uint8_t transition_frames) {
     define_transition_settings(&transition_frames);
 
-    auto frame_handler_function = [this, transition_frames] (uint8_t *buffer) -> bool {
+    if (transition_frames) {
+        // the transitions are blended in rgb
+        clip_iter_->yuv_output(false);
+    }
+
+    auto frame_handler_function = [this, transition_frames] (uint8_t *buffer, frame_format_t format) -> bool {
+        if (format == frame_format_yuv420p) {
+            return encode_yuv_frame(buffer) && !prog_handler_->canceled();
+        }
+
         if (transitions_.size() < transition_frames) {
             transitions_.push_back(std::shared_ptr<CharBuffer>(new CharBuffer(clipping_->req_buffer_size())));
             memcpy((*transitions_.rbegin())->data, buffer, clipping_->req_buffer_size());
@@ -101,8 +140,7 @@ void ClippingConversion::start_conversion(bool from_start, bool append_reverse,
             combine_buffers(buffer, (*it)->data);
         }
 
-        encode_frame(buffer);
-        return !prog_handler_->canceled();
+        return encode_frame(buffer) && !prog_handler_->canceled();
     };
 
     clip_iter_->iterate(from_start, append_reverse, frame_handler_function);
@@ -111,16 +149,86 @@ void ClippingConversion::start_conversion(bool from_start, bool append_reverse,
 bool ClippingConversion::wait_conversion() {
     bool result = prog_handler_->wait([this] () -> bool {
         while (!clip_iter_->finished()) {
-            prog_handler_->set_buffer(last_encoded_buffer_.load(), clipping_->w(), clipping_->h());
+            update_preview();
             prog_handler_->set_progress(current_position_.load(), max_position_);
-            Fl::wait(0.1);
+            wait_events(0.1);
         }
         return true;
     });
 
+    bool iterated = clip_iter_->error() == NULL && encoder_->error() == NULL;
+
     unprepare_conversion();
 
-    return result;
+    return result && iterated;
+}
+
+bool ClippingConversion::is_plain_trim(double fps) {
+    vs::Decoder *info = clipping_->player()->info();
+
+    if (fabs(fps - info->fps()) > 0.001 || clipping_->w() != info->w() || clipping_->h() != info->h()) {
+        return false;
+    }
+
+    int x = 0;
+    int y = 0;
+    for (const auto & k : clipping_->keys()) {
+        if (!clipping_->crop_area(k, &x, &y) || x != 0 || y != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ClippingConversion::remux(const char *codec, const char *path, bool *remuxed) {
+    current_position_.store(0);
+    max_position_ = clipping_->duration_frames();
+    memset(&stats_, 0, sizeof(stats_));
+
+    std::atomic_bool finished(false);
+    std::atomic_bool can_remux(false);
+    bool success = false;
+    uint32_t first_frame = clipping_->first_frame();
+    uint32_t last_frame = clipping_->last_frame();
+    std::string video_path = clipping_->video_path();
+    std::string keyframe_index_path = clipping_->keyframe_index_path();
+    std::string codec_name = codec;
+    std::string output_path = path;
+    std::shared_ptr<vs::Remuxer> remuxer;
+
+    // opening the remuxer waits for the key frame index, it must not block the ui
+    boost::thread remux_thread([&] () {
+        remuxer = vs::remuxer(
+            codec_name.c_str(), video_path.c_str(), output_path.c_str(), keyframe_index_path.c_str(),
+            title_.c_str(), author_.c_str(), tags_.c_str());
+        can_remux = remuxer->can_remux(first_frame, last_frame);
+        if (can_remux && !prog_handler_->canceled()) {
+            success = remuxer->remux(first_frame, last_frame, [this] (uint32_t copied_frames) -> bool {
+                current_position_.store(copied_frames);
+                return !prog_handler_->canceled();
+            });
+        }
+        finished = true;
+    });
+
+    bool result = prog_handler_->wait([this, &finished] () -> bool {
+        while (!finished) {
+            prog_handler_->set_progress(current_position_.load(), max_position_);
+            wait_events(0.1);
+        }
+        return true;
+    });
+
+    remux_thread.join();
+
+    *remuxed = can_remux;
+
+    if (can_remux && !success && remuxer->error() && !prog_handler_->canceled()) {
+        error_ = remuxer->error();
+    }
+
+    return result && success;
 }
 
 void ClippingConversion::define_transition_settings(uint8_t *transition_frames) {
@@ -147,10 +255,92 @@ void ClippingConversion::combine_buffers(uint8_t *primary_buffer, uint8_t *secon
     }
 }
 
-void ClippingConversion::encode_frame(uint8_t *buffer) {
-    last_encoded_buffer_.store(buffer); // the clipping iterator does not release any buffer before it destroys itself.
-    encoder_->frame(buffer);
+void ClippingConversion::publish_preview(const uint8_t *buffer, frame_format_t format) {
+    boost::lock_guard<boost::mutex> lock(mtx_preview_);
+    // the pipeline reuses its buffers once the frame is encoded, the preview is a copy
+    if (preview_published_) {
+        return;
+    }
+    uint32_t size = clipping_->req_buffer_size();
+    if (!encoded_preview_) {
+        encoded_preview_.reset(new CharBuffer(size));
+    }
+    encoded_preview_->resize(size);
+    if (format == frame_format_yuv420p) {
+        // converted only when the ui takes it, not for every frame encoded
+        cv::Mat yuv(clipping_->h() * 3 / 2, clipping_->w(), CV_8UC1, const_cast<uint8_t *>(buffer));
+        cv::Mat rgb(clipping_->h(), clipping_->w(), CV_8UC3, encoded_preview_->data);
+        cv::cvtColor(yuv, rgb, cv::COLOR_YUV2RGB_I420);
+    } else {
+        memcpy(encoded_preview_->data, buffer, size);
+    }
+    preview_published_ = true;
+}
+
+void ClippingConversion::update_preview() {
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_preview_);
+        if (preview_published_) {
+            // the progress handler draws from preview_ later, the encoding thread never writes to it
+            if (!preview_) {
+                preview_.reset(new CharBuffer(encoded_preview_->size()));
+            }
+            preview_->resize(encoded_preview_->size());
+            memcpy(preview_->data, encoded_preview_->data, encoded_preview_->size());
+            preview_published_ = false;
+        }
+    }
+
+    if (preview_) {
+        prog_handler_->set_buffer(preview_->data, clipping_->w(), clipping_->h());
+    } else {
+        prog_handler_->set_buffer(NULL, 0, 0);
+    }
+}
+
+bool ClippingConversion::encode_frame(uint8_t *buffer) {
+    publish_preview(buffer, frame_format_rgb24);
+    if (!encoder_->frame(buffer)) {
+        return false;
+    }
+    ++current_position_;
+    return true;
+}
+
+bool ClippingConversion::encode_yuv_frame(uint8_t *buffer) {
+    int w = clipping_->w();
+    int h = clipping_->h();
+
+    vs::yuv_planes_t planes;
+    planes.data[0] = buffer;
+    planes.data[1] = buffer + w * h;
+    planes.data[2] = planes.data[1] + (w / 2) * (h / 2);
+    planes.linesize[0] = w;
+    planes.linesize[1] = w / 2;
+    planes.linesize[2] = w / 2;
+
+    publish_preview(buffer, frame_format_yuv420p);
+    if (!encoder_->yuv_frame(planes)) {
+        return false;
+    }
     ++current_position_;
+    return true;
+}
+
+pipeline_stats_t ClippingConversion::stats() const {
+    return stats_;
+}
+
+void ClippingConversion::render_threads(uint32_t count) {
+    render_threads_ = count > 0 ? count : 1;
+}
+
+void ClippingConversion::spill_compression(bool enabled) {
+    spill_compression_ = enabled;
+}
+
+void ClippingConversion::encoder_options(const vs::encoder_options_t& options) {
+    encoder_options_ = options;
 }
 
 const char * ClippingConversion::error() const {
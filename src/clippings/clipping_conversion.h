@@ -10,6 +10,7 @@
 #include <list>
 #include <atomic>
 #include <string>
+#include <boost/thread.hpp>
 #include "src/clippings/clipping_iterator.h"
 #include "src/clippings/clipping.h"
 #include "src/common/buffers.h"
@@ -50,8 +51,21 @@ class ClippingConversion {
         uint8_t transition_frames=0);
 
     const char * error() const;
+
+    // statistics of the last conversion
+    pipeline_stats_t stats() const;
+    void render_threads(uint32_t count);
+    // compress the frames the reverse exports spill to disk (less disk, more cpu)
+    void spill_compression(bool enabled);
+    void encoder_options(const vs::encoder_options_t& options);
  private:
-    void encode_frame(uint8_t *buffer);
+    // return false when the encoder fails
+    bool encode_frame(uint8_t *buffer);
+    bool encode_yuv_frame(uint8_t *buffer);
+    // the encoding thread: keep an rgb copy of the frame for the preview when the ui took the former one
+    void publish_preview(const uint8_t *buffer, frame_format_t format);
+    // the ui thread: hand the last frame published to the progress handler
+    void update_preview();
     void copy_buffer(vs::Decoder *player, uint8_t *buffer);
     float transparency_increment();
     void combine_buffers(uint8_t *primary_buffer, uint8_t *secondary_buffer);
@@ -64,12 +78,18 @@ class ClippingConversion {
         bool append_reverse
     );
     void start_conversion(bool from_start, bool append_reverse, uint8_t transition_frames);
+    bool is_plain_trim(double fps);
+    // remuxed is false when the range must be encoded again
+    bool remux(const char *codec, const char *path, bool *remuxed);
     void unprepare_conversion();
     bool wait_conversion();
 
  private:
     std::atomic<uint32_t> current_position_;
-    std::atomic<uint8_t*> last_encoded_buffer_;
+    boost::mutex mtx_preview_;
+    std::unique_ptr<CharBuffer> encoded_preview_;  // the last frame published (protected by mtx_preview_)
+    bool preview_published_;  // protected by mtx_preview_
+    std::unique_ptr<CharBuffer> preview_;  // the copy the progress handler shows, written by the ui thread only
     uint32_t max_position_;
     std::shared_ptr<vs::Encoder> encoder_;
     std::shared_ptr<ClippingRender> clipping_;
@@ -83,6 +103,10 @@ class ClippingConversion {
     float current_alpha_;
     float alpha_increment_;
     uint32_t max_memory_;
+    uint32_t render_threads_;
+    bool spill_compression_;
+    vs::encoder_options_t encoder_options_;
+    pipeline_stats_t stats_;
 };
 
 }  // namespace vcutter
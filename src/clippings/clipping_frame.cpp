@@ -1,10 +1,33 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <stdio.h>
+#include <functional>
+#include <boost/filesystem.hpp>
 #include "src/clippings/clipping_frame.h"
+#include "src/common/utils.h"
 
 namespace vcutter {
 
+namespace {
+
+const char *kKEYFRAME_INDEX_EXTENSION = ".keyframes";
+const char *kPROXY_EXTENSION = ".proxy.mp4";
+const char *kTHUMBNAILS_EXTENSION = ".thumbnails";
+
+// the hash of the full path keeps apart the files of videos with the same name
+std::string video_temp_filepath(const std::string& video_path, const char *extension) {
+    boost::filesystem::path video(video_path);
+    char hash[32] = "";
+    snprintf(hash, sizeof(hash), "-%08zx", std::hash<std::string>()(boost::filesystem::absolute(video).string()));
+
+    std::string filename = video.filename().string() + hash + extension;
+
+    return temp_filepath(filename.c_str());
+}
+
+}  // namespace
+
 ClippingFrame::ClippingFrame(const char *path, bool path_is_video, frame_callback_t frame_cb) : ClippingData(path_is_video ? "" : path) {
     frame_cb_ = frame_cb;
     if (path_is_video) {
@@ -25,7 +48,7 @@ void ClippingFrame::video_open() {
         return;
     }
 
-    player_.reset(new Player(video_path().c_str(), frame_cb_));
+    player_.reset(new Player(video_path().c_str(), frame_cb_, keyframe_index_path().c_str()));
 
     if (!good()){
         return;
@@ -40,6 +63,39 @@ void ClippingFrame::video_open() {
     }
 }
 
+std::string ClippingFrame::keyframe_index_path() {
+    if (!saved_path().empty()) {
+        return saved_path() + kKEYFRAME_INDEX_EXTENSION;
+    }
+
+    // the index stores the size and the modification time of the video, so a file of another video is not loaded
+    std::string filename = boost::filesystem::path(video_path()).filename().string() + kKEYFRAME_INDEX_EXTENSION;
+
+    return temp_filepath(filename.c_str());
+}
+
+std::string ClippingFrame::proxy_path() {
+    return video_temp_filepath(video_path(), kPROXY_EXTENSION);
+}
+
+std::string ClippingFrame::thumbnails_path() {
+    return video_temp_filepath(video_path(), kTHUMBNAILS_EXTENSION);
+}
+
+void ClippingFrame::edit_with_proxy() {
+    if (player_ && good()) {
+        player_->use_proxy(proxy_path().c_str());
+    }
+}
+
+void ClippingFrame::save(const char *path, bool preserve_path) {
+    ClippingData::save(path, preserve_path);
+
+    if (preserve_path && player_) {
+        player_->save_keyframe_index(keyframe_index_path().c_str());
+    }
+}
+
 uint32_t ClippingFrame::default_w() {
     return player_->info()->w();
 }
@@ -35,6 +35,15 @@ class ClippingFrame: public ClippingData {
     void fit_all(uint32_t frame);
     void fit_vertical(uint32_t frame);
     void fit_horizontal(uint32_t frame);
+    void save(const char *path, bool preserve_path=true) override;
+    // where the keyframe index of the video is cached
+    std::string keyframe_index_path();
+    // where the reduced copy of the video used for editing is cached
+    std::string proxy_path();
+    // where the thumbnails of the seek bar are cached
+    std::string thumbnails_path();
+    // build (or reuse) the proxy of a large video and let the player edit on it
+    void edit_with_proxy();
  protected:
     uint32_t default_w() override;
     uint32_t default_h() override;
@@ -6,193 +6,199 @@
 
 namespace vcutter {
 
-ClippingIterator::ClippingIterator(ClippingRender *clipping, uint32_t max_memory) {
+ClippingIterator::ClippingIterator(ClippingRender *clipping, uint32_t max_memory, uint32_t render_threads) {
     max_memory_ = max_memory;
     clipping_ = clipping;
-    render_buffer_.reset(new CharBuffer(clipping_->req_buffer_size()));
+    render_threads_ = render_threads;
+    sequence_ = 0;
+    stored_frames_ = 0;
+    withheld_frames_ = 0;
+    yuv_output_ = false;
+    spill_compression_ = false;
 }
 
+void ClippingIterator::iterate(bool from_start, bool append_reverse, frame_iteration_cb_t cb) {
+    uint32_t first_frame = clipping_->first_frame();
+    uint32_t last_frame = clipping_->last_frame();
+    uint32_t frame_count = last_frame > first_frame ? (last_frame - first_frame) + 1 : 0;
+    uint32_t source_size = clipping_->player()->info()->w() * clipping_->player()->info()->h() * 3;
+    uint32_t output_size = clipping_->req_buffer_size();
+    uint32_t pipeline_memory = max_memory_;
+    frame_output_cb_t output_cb = cb;
+
+    sequence_ = 0;
+    stored_frames_ = 0;
+    withheld_frames_ = 0;
+    error_.clear();
+    store_.reset();
+
+    if ((!from_start || append_reverse) && frame_count) {
+        // the frames are decoded once (forward) and the ones delivered out of order come back
+        // from the store. the pipeline only needs enough buffers to keep its stages busy.
+        uint64_t busy_memory = static_cast<uint64_t>(render_threads_ + 1) * source_size +
+            static_cast<uint64_t>(render_threads_ * 2 + 2) * output_size;
+        if (busy_memory < pipeline_memory) {
+            pipeline_memory = busy_memory;
+        }
 
-uint32_t ClippingIterator::buffer_count(uint32_t frame_count) {
-    uint32_t result =  max_memory_ / clipping_->req_buffer_size();
-
-    if (result > frame_count) {
-        return frame_count;
-    }
-
-    if (result < 0) {
-        return 1;
+        store_.reset(new FrameStore(output_size, frame_count, max_memory_ - pipeline_memory, NULL, spill_compression_));
+
+        output_cb = [this, cb, from_start, frame_count] (uint8_t *buffer, frame_format_t format) -> bool {
+            if (stored_frames_ < frame_count) {
+                if (!store_frame(buffer, format)) {
+                    return false;
+                }
+                if (!from_start) {
+                    ++withheld_frames_;
+                    return true;
+                }
+            }
+            return cb(buffer, format);
+        };
     }
 
-    return result;
-}
-
-void ClippingIterator::iterate(bool from_start, bool append_reverse, frame_iteration_cb_t cb) {
-    uint32_t from_frame = from_start ? clipping_->first_frame() : clipping_->last_frame();
-    uint32_t to_frame = from_start ? clipping_->last_frame() : clipping_->first_frame();
+    pipeline_.reset(new ClippingPipeline(
+        source_size,
+        output_size,
+        pipeline_memory,
+        render_threads_,
+        [this] (const ClippingKey& key, uint8_t *source_buffer, uint8_t *output_buffer) {
+            clipping_->render(key, source_buffer, output_buffer);
+        },
+        output_cb));
 
     clipping_->player()->execute([
         this,
-        from_frame,
-        to_frame,
-        append_reverse,
-        cb
+        first_frame,
+        last_frame,
+        from_start,
+        append_reverse
     ] (vs::Decoder *player) {
-        uint32_t frame_count = (from_frame > to_frame) ? from_frame - to_frame : to_frame - from_frame;
-
-        if (frame_count < 1) {
+        if (last_frame <= first_frame) {
+            pipeline_->finish();
             return;
         }
 
-        if (from_frame > to_frame || append_reverse) {
-            uint32_t count = buffer_count(frame_count);
+        uint32_t last_index = last_frame - first_frame;
 
-            if (count == frame_count) {
-                grab_all(player, from_frame, to_frame, append_reverse, cb);
-                return;
+        if (from_begin(player, first_frame, last_frame) && store_ && pipeline_->wait_delivered()) {
+            if (!from_start) {
+                if (replay(last_index, 0) && append_reverse && last_index >= 2) {
+                    replay(1, last_index - 1);
+                }
+            } else if (last_index >= 2) {
+                replay(last_index - 1, 1);
             }
-
-            buffers_.reset(new StackBuffer(clipping_->req_buffer_size(), count));
         }
 
-        render_buffer_.reset(new CharBuffer(clipping_->req_buffer_size()));
-
-        if (from_frame > to_frame) {
-            from_end(player, append_reverse, to_frame, from_frame, cb);
-        } else {
-            from_begin(player, append_reverse, from_frame, to_frame, cb);
-        }
+        pipeline_->finish();
     });
 }
 
-void ClippingIterator::from_begin(vs::Decoder *player, bool append_reverse, uint32_t from_frame, uint32_t to_frame, frame_iteration_cb_t cb) {
-    uint32_t frame_count = (to_frame - from_frame) + 1;
+bool ClippingIterator::push_frame(vs::Decoder *player, uint32_t sequence) {
+    ClippingKey key = clipping_->at(player->position());
+    vs::yuv_planes_t planes;
+    int x = 0;
+    int y = 0;
 
-    player->seek_frame(from_frame);
-    while (frame_count) {
-        render_frame(render_buffer_->data);
-        if (!cb(render_buffer_->data)) {
-            return;
-        }
-        player->next();
-        --frame_count;
+    if (yuv_output_ && clipping_->crop_area(key, &x, &y) && player->yuv_planes(&planes)) {
+        return pipeline_->push_yuv(planes, x, y, clipping_->w(), clipping_->h(), sequence);
     }
 
-    if (append_reverse && from_frame + 2 <= to_frame) {
-        from_end(player, false, from_frame + 1, to_frame - 1, cb);
+    // only the pixels the render reads are converted to rgb
+    vs::frame_ref_t frame = player->partial_frame(clipping_->source_area(key));
+    if (!frame) {
+        frame = player->frame();
     }
-}
-
-void ClippingIterator::from_end(vs::Decoder *player, bool append_reverse, uint32_t from_frame, uint32_t to_frame, frame_iteration_cb_t cb) {
-    uint32_t frame_count = (to_frame - from_frame) + 1;
-    uint32_t position = to_frame;
-    bool flushing = false;
-
-    do {
-        flushing = false;
-
-        position -= buffers_->count();
-        if (position > to_frame) {
-            position = from_frame;
-        } else if (position < from_frame) {
-            position = from_frame;
-        }
-
-        player->seek_frame(position);
-
-        while (!flushing && frame_count > 0) {
-            --frame_count;
-            render_frame(render_buffer_->data);
-            player->next();
-            if (buffers_->push(render_buffer_->data)) {
-                continue;
-            }
-            flushing = true;
-        }
-
-        if (!flush_buffers(cb)) {
-            return;
-        }
-    } while (frame_count);
-
-    if (!flush_buffers(cb)) {
-        return;
+    if (frame) {
+        return pipeline_->push(key, frame, sequence);
     }
 
-    if (append_reverse && from_frame + 1<= to_frame) {
-        from_begin(player, false, from_frame + 1, to_frame - 1, cb);
-    }
+    return pipeline_->push(key, player->buffer(), sequence);
 }
 
-bool ClippingIterator::flush_buffers(frame_iteration_cb_t cb) {
-    uint8_t *buffer;
+bool ClippingIterator::from_begin(vs::Decoder *player, uint32_t from_frame, uint32_t to_frame) {
+    uint32_t frame_count = (to_frame - from_frame) + 1;
 
-    do {
-        buffer = buffers_->pop();
-        if (buffer) {
-            if (!cb(buffer)) {
-                return false;
-            }
+    player->seek_frame(from_frame);
+    while (frame_count) {
+        if (!push_frame(player, sequence_++)) {
+            return false;
         }
-    } while (buffer);
+        player->next();
+        --frame_count;
+    }
 
     return true;
 }
 
-void ClippingIterator::grab_all(vs::Decoder *player, uint32_t from_frame, uint32_t to_frame, bool append_reverse, frame_iteration_cb_t cb) {
-    bool forward = from_frame <= to_frame;
-    frames_.clear();
-
-    if (!forward) {
-        uint32_t tmp = from_frame;
-        from_frame = to_frame;
-        to_frame = tmp;
+bool ClippingIterator::store_frame(uint8_t *buffer, frame_format_t format) {
+    // runs on the output thread of the pipeline, the frames arrive in the order they were decoded
+    uint32_t size = clipping_->req_buffer_size();
+    if (format == frame_format_yuv420p) {
+        size = clipping_->w() * clipping_->h() * 3 / 2;
     }
 
-    player->seek_frame(from_frame);
-    uint32_t frame_count = (to_frame - from_frame) + 1;
-
-    do {
-        frames_.push_back(std::shared_ptr<CharBuffer>(new CharBuffer(clipping_->req_buffer_size())));
-        render_frame((*frames_.rbegin())->data);
-        player->next();
-    } while (frames_.size() < frame_count);
+    if (!store_->put(stored_frames_++, buffer, size, format)) {
+        error_ = store_->error();
+        return false;
+    }
 
-    report_frames(forward, append_reverse, cb);
+    return true;
 }
 
-void ClippingIterator::report_frames(bool forward, bool append_reverse, frame_iteration_cb_t cb) {
-    if (forward) {
-        for (auto it = frames_.begin(); it != frames_.end(); ++it) {
-            if (append_reverse && (it == frames_.begin() || (*it)->data == (*frames_.rbegin())->data)) {
-                continue;
-            }
-            if (!cb((*it)->data)) {
-                return;
+bool ClippingIterator::replay(uint32_t first_index, uint32_t last_index) {
+    // deliver the stored frames from first_index to last_index (both included, in any direction)
+    for (uint32_t index = first_index; ; index = first_index < last_index ? index + 1 : index - 1) {
+        bool pushed = pipeline_->push_rendered([this, index] (uint8_t *buffer, frame_format_t *format) -> bool {
+            if (!store_->get(index, buffer, format)) {
+                error_ = store_->error();
+                return false;
             }
+            return true;
+        }, sequence_++);
+
+        if (!pushed) {
+            return false;
         }
-    } else {
-        for (auto it = frames_.rbegin(); it != frames_.rend(); ++it) {
-            if (append_reverse && (it == frames_.rbegin() || (*it)->data == (*frames_.begin())->data)) {
-                continue;
-            }
-            if (!cb((*it)->data)) {
-                return;
-            }
+
+        if (index == last_index) {
+            return true;
         }
     }
+}
 
-    if (append_reverse) {
-        report_frames(!forward, false, cb);
-    }
+void ClippingIterator::yuv_output(bool enabled) {
+    yuv_output_ = enabled;
 }
 
-void ClippingIterator::render_frame(uint8_t *buffer) {
-    clipping_->render(clipping_->at(clipping_->player()->info()->position()), buffer);
+void ClippingIterator::spill_compression(bool enabled) {
+    spill_compression_ = enabled;
+}
+
+const char *ClippingIterator::error() {
+    if (error_.length()) {
+        return error_.c_str();
+    }
+    return NULL;
 }
 
 bool ClippingIterator::finished() {
     return clipping_->player()->execution_finished();
 }
 
+pipeline_stats_t ClippingIterator::stats() {
+    if (pipeline_) {
+        // the frames a reverse export only stores on the first pass are delivered on the second one
+        pipeline_stats_t result = pipeline_->stats();
+        uint32_t withheld = withheld_frames_.load();
+        result.encode.frames = result.encode.frames > withheld ? result.encode.frames - withheld : 0;
+        return result;
+    }
+
+    pipeline_stats_t result;
+    memset(&result, 0, sizeof(result));
+    return result;
+}
+
 }  // namespace vcutter
@@ -7,35 +7,47 @@
 #include <inttypes.h>
 #include <atomic>
 #include <functional>
-#include <list>
+#include <memory>
+#include <string>
 #include "src/clippings/clipping.h"
-#include "src/common/buffers.h"
+#include "src/clippings/clipping_pipeline.h"
+#include "src/clippings/frame_store.h"
 
 namespace vcutter {
 
-typedef std::function<bool(uint8_t *output_buffer)> frame_iteration_cb_t;
+typedef frame_output_cb_t frame_iteration_cb_t;
 
 class ClippingIterator {
  public:
-    ClippingIterator(ClippingRender *clipping, uint32_t max_memory);
+    ClippingIterator(ClippingRender *clipping, uint32_t max_memory, uint32_t render_threads=ClippingPipeline::default_render_threads());
     virtual ~ClippingIterator() {}
     void iterate(bool from_start, bool append_reverse, frame_iteration_cb_t cb);
     bool finished();
+    pipeline_stats_t stats();
+    // let the frames that are a plain crop skip the rgb conversion (they are delivered as frame_format_yuv420p)
+    void yuv_output(bool enabled);
+    // compress the frames the reverse exports spill to disk
+    void spill_compression(bool enabled);
+    // the reason the iteration stopped (NULL if it was completed or canceled by the callback)
+    const char *error();
  private:
-    uint32_t buffer_count(uint32_t frame_count);
-    void grab_all(vs::Decoder *player, uint32_t from_frame, uint32_t to_frame, bool append_reverse, frame_iteration_cb_t cb);
-    void from_begin(vs::Decoder *player, bool append_reverse, uint32_t from_frame, uint32_t to_frame, frame_iteration_cb_t cb);
-    void from_end(vs::Decoder *player, bool append_reverse, uint32_t from_frame, uint32_t to_frame, frame_iteration_cb_t cb);
-    void render_frame(uint8_t *buffer);
-    void report_frames(bool forward, bool append_reverse, frame_iteration_cb_t cb);
-    bool flush_buffers(frame_iteration_cb_t cb);
+    bool from_begin(vs::Decoder *player, uint32_t from_frame, uint32_t to_frame);
+    bool replay(uint32_t first_index, uint32_t last_index);
+    bool store_frame(uint8_t *buffer, frame_format_t format);
+    bool push_frame(vs::Decoder *player, uint32_t sequence);
 
  private:
     ClippingRender *clipping_;
-    std::unique_ptr<StackBuffer> buffers_;
-    std::unique_ptr<CharBuffer> render_buffer_;
-    std::list<std::shared_ptr<CharBuffer> > frames_;
+    std::unique_ptr<ClippingPipeline> pipeline_;
+    std::unique_ptr<FrameStore> store_;
+    std::string error_;
     uint32_t max_memory_;
+    uint32_t render_threads_;
+    uint32_t sequence_;
+    uint32_t stored_frames_;
+    std::atomic<uint32_t> withheld_frames_;
+    bool yuv_output_;
+    bool spill_compression_;
 };
 
 }  // namespace vcutter
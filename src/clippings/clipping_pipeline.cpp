@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include "src/clippings/clipping_pipeline.h"
+
+namespace vcutter {
+
+namespace {
+
+const uint32_t kMIN_OUTPUT_SLOTS = 2;
+const uint32_t kNO_SLOT = 0xFFFFFFFF;
+
+double seconds_since(const boost::chrono::steady_clock::time_point& start) {
+    return boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+double stage_fps(const stage_stats_t& stats) {
+    if (stats.busy_seconds <= 0) {
+        return 0;
+    }
+    return stats.frames / stats.busy_seconds;
+}
+
+ClippingPipeline::ClippingPipeline(
+    uint32_t source_size,
+    uint32_t output_size,
+    uint32_t max_memory,
+    uint32_t render_threads,
+    frame_render_cb_t render_cb,
+    frame_output_cb_t output_cb
+) {
+    render_cb_ = render_cb;
+    output_cb_ = output_cb;
+    source_size_ = source_size;
+    output_size_ = output_size;
+    pending_frames_ = 0;
+    next_sequence_ = 0;
+    canceled_ = false;
+    stopping_ = false;
+    memset(&stats_, 0, sizeof(stats_));
+
+    if (render_threads < 1) {
+        render_threads = 1;
+    }
+
+    // every render thread has a frame to work on while the decoder prepares another one
+    max_sources_ = render_threads + 1;
+    sources_in_flight_ = 0;
+    // allocated by acquire_source_slot, sized up front so the render threads never see the vector move
+    sources_.resize(max_sources_);
+
+    output_count_ = max_memory / output_size;
+    if (output_count_ < kMIN_OUTPUT_SLOTS) {
+        output_count_ = kMIN_OUTPUT_SLOTS;
+    }
+    max_memory_ = max_memory;
+    used_memory_ = static_cast<uint64_t>(output_count_) * output_size;
+
+    for (uint32_t i = 0; i < output_count_; ++i) {
+        outputs_.push_back(std::shared_ptr<CharBuffer>(new CharBuffer(output_size)));
+        free_outputs_.push_back(i);
+    }
+
+    output_formats_.resize(output_count_, frame_format_rgb24);
+    stats_.render_threads = render_threads;
+    started_at_ = boost::chrono::steady_clock::now();
+    last_push_ = started_at_;
+
+    for (uint32_t i = 0; i < render_threads; ++i) {
+        threads_.push_back(std::shared_ptr<boost::thread>(new boost::thread([this] () {
+            render_thread();
+        })));
+    }
+
+    threads_.push_back(std::shared_ptr<boost::thread>(new boost::thread([this] () {
+        output_thread();
+    })));
+}
+
+ClippingPipeline::~ClippingPipeline() {
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        canceled_ = true;
+    }
+    stop();
+}
+
+uint32_t ClippingPipeline::default_render_threads() {
+    // the decoder and the encoder keep other two cores busy
+    uint32_t cores = boost::thread::hardware_concurrency();
+    return cores > 3 ? cores - 2 : 1;
+}
+
+uint32_t ClippingPipeline::output_slots() const {
+    return output_count_;
+}
+
+uint32_t ClippingPipeline::acquire_slot(std::vector<uint32_t> *free_slots, boost::unique_lock<boost::mutex> *lock) {
+    while (free_slots->empty() && !canceled_) {
+        slot_released_.wait(*lock);
+    }
+
+    if (canceled_) {
+        return kNO_SLOT;
+    }
+
+    uint32_t slot = free_slots->back();
+    free_slots->pop_back();
+    return slot;
+}
+
+uint32_t ClippingPipeline::acquire_source_slot() {
+    if (!free_sources_.empty()) {
+        uint32_t slot = free_sources_.back();
+        free_sources_.pop_back();
+        return slot;
+    }
+
+    // no buffer is free: every allocated one holds a frame in flight, so there is room for another
+    uint32_t slot = 0;
+    while (sources_[slot]) {
+        ++slot;
+    }
+    sources_[slot].reset(new CharBuffer(source_size_));
+    used_memory_ += source_size_;
+
+    // give the memory back by dropping the output buffers nobody is using
+    while (used_memory_ > max_memory_ && output_count_ > kMIN_OUTPUT_SLOTS && !free_outputs_.empty()) {
+        uint32_t output_slot = free_outputs_.back();
+        free_outputs_.pop_back();
+        outputs_[output_slot].reset();
+        --output_count_;
+        used_memory_ -= output_size_;
+    }
+
+    return slot;
+}
+
+void ClippingPipeline::release_output_slot(uint32_t slot) {
+    // the ones still in use when the source buffers were allocated are dropped as they come back
+    if (used_memory_ > max_memory_ && output_count_ > kMIN_OUTPUT_SLOTS) {
+        outputs_[slot].reset();
+        --output_count_;
+        used_memory_ -= output_size_;
+    } else {
+        free_outputs_.push_back(slot);
+    }
+}
+
+bool ClippingPipeline::push(const ClippingKey& key, const uint8_t *source_buffer, uint32_t sequence) {
+    return push_source(key, source_buffer, vs::frame_ref_t(), sequence);
+}
+
+bool ClippingPipeline::push(const ClippingKey& key, vs::frame_ref_t source_frame, uint32_t sequence) {
+    return push_source(key, NULL, source_frame, sequence);
+}
+
+bool ClippingPipeline::push_source(
+    const ClippingKey& key, const uint8_t *source_buffer, vs::frame_ref_t source_frame, uint32_t sequence
+) {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    stats_.decode.busy_seconds += seconds_since(last_push_);
+    ++stats_.decode.frames;
+
+    while (sources_in_flight_ >= max_sources_ && !canceled_) {
+        slot_released_.wait(lock);
+    }
+
+    if (canceled_) {
+        return false;
+    }
+
+    uint32_t output_slot = acquire_slot(&free_outputs_, &lock);
+    if (output_slot == kNO_SLOT) {
+        return false;
+    }
+
+    ++sources_in_flight_;
+    uint32_t source_slot = kNO_SLOT;
+    if (!source_frame) {
+        source_slot = acquire_source_slot();
+        lock.unlock();
+        memcpy(sources_[source_slot]->data, source_buffer, source_size_);
+        lock.lock();
+    }
+
+    render_job_t job;
+    job.key = key;
+    job.source_frame = source_frame;
+    job.source_slot = source_slot;
+    job.output_slot = output_slot;
+    job.sequence = sequence;
+
+    output_formats_[output_slot] = frame_format_rgb24;
+    ++pending_frames_;
+    jobs_.push_back(job);
+    job_added_.notify_one();
+
+    last_push_ = boost::chrono::steady_clock::now();
+
+    return !canceled_;
+}
+
+bool ClippingPipeline::push_yuv(const vs::yuv_planes_t& planes, int x, int y, int w, int h, uint32_t sequence) {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    stats_.decode.busy_seconds += seconds_since(last_push_);
+    ++stats_.decode.frames;
+
+    uint32_t output_slot = acquire_slot(&free_outputs_, &lock);
+    if (output_slot == kNO_SLOT) {
+        return false;
+    }
+
+    lock.unlock();
+    uint8_t *target = outputs_[output_slot]->data;
+    for (int line = 0; line < h; ++line) {
+        memcpy(target, planes.data[0] + (y + line) * planes.linesize[0] + x, w);
+        target += w;
+    }
+    for (int plane = 1; plane < 3; ++plane) {
+        for (int line = 0; line < h / 2; ++line) {
+            memcpy(target, planes.data[plane] + (y / 2 + line) * planes.linesize[plane] + x / 2, w / 2);
+            target += w / 2;
+        }
+    }
+    lock.lock();
+
+    output_formats_[output_slot] = frame_format_yuv420p;
+    ++pending_frames_;
+    add_rendered(output_slot, sequence);
+
+    last_push_ = boost::chrono::steady_clock::now();
+
+    return !canceled_;
+}
+
+bool ClippingPipeline::push_rendered(frame_fill_cb_t fill_cb, uint32_t sequence) {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+
+    uint32_t output_slot = acquire_slot(&free_outputs_, &lock);
+    if (output_slot == kNO_SLOT) {
+        return false;
+    }
+
+    lock.unlock();
+    frame_format_t format = frame_format_rgb24;
+    bool filled = fill_cb(outputs_[output_slot]->data, &format);
+    lock.lock();
+
+    if (!filled) {
+        release_output_slot(output_slot);
+        canceled_ = true;
+        slot_released_.notify_all();
+        return false;
+    }
+
+    output_formats_[output_slot] = format;
+    ++pending_frames_;
+    add_rendered(output_slot, sequence);
+
+    return !canceled_;
+}
+
+void ClippingPipeline::add_rendered(uint32_t output_slot, uint32_t sequence) {
+    rendered_[sequence] = output_slot;
+    frame_rendered_.notify_all();
+}
+
+void ClippingPipeline::render_thread() {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    while (true) {
+        while (jobs_.empty() && !stopping_) {
+            job_added_.wait(lock);
+        }
+
+        if (jobs_.empty()) {
+            return;
+        }
+
+        render_job_t job = jobs_.front();
+        jobs_.pop_front();
+        bool canceled = canceled_;
+        lock.unlock();
+
+        auto start = boost::chrono::steady_clock::now();
+        if (!canceled) {
+            uint8_t *source = job.source_frame ?
+                const_cast<uint8_t *>(job.source_frame->data()) : sources_[job.source_slot]->data;
+            render_cb_(job.key, source, outputs_[job.output_slot]->data);
+        }
+        double busy = seconds_since(start);
+
+        lock.lock();
+        stats_.render.busy_seconds += busy;
+        ++stats_.render.frames;
+        if (job.source_slot != kNO_SLOT) {
+            free_sources_.push_back(job.source_slot);
+        }
+        --sources_in_flight_;
+        add_rendered(job.output_slot, job.sequence);
+        slot_released_.notify_all();
+    }
+}
+
+void ClippingPipeline::output_thread() {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    while (true) {
+        auto it = rendered_.find(next_sequence_);
+        while (it == rendered_.end() && !stopping_) {
+            frame_rendered_.wait(lock);
+            it = rendered_.find(next_sequence_);
+        }
+
+        if (it == rendered_.end()) {
+            return;
+        }
+
+        uint32_t slot = it->second;
+        frame_format_t format = output_formats_[slot];
+        rendered_.erase(it);
+        ++next_sequence_;
+        bool canceled = canceled_;
+        lock.unlock();
+
+        bool keep_going = true;
+        auto start = boost::chrono::steady_clock::now();
+        if (!canceled) {
+            keep_going = output_cb_(outputs_[slot]->data, format);
+        }
+        double busy = seconds_since(start);
+
+        lock.lock();
+        stats_.encode.busy_seconds += busy;
+        ++stats_.encode.frames;
+        if (!keep_going) {
+            canceled_ = true;
+        }
+        release_output_slot(slot);
+        --pending_frames_;
+        slot_released_.notify_all();
+    }
+}
+
+bool ClippingPipeline::wait_delivered() {
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    while (pending_frames_ > 0 && !canceled_) {
+        slot_released_.wait(lock);
+    }
+    return !canceled_;
+}
+
+bool ClippingPipeline::finish() {
+    wait_delivered();
+    stop();
+
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return !canceled_;
+}
+
+void ClippingPipeline::stop() {
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        slot_released_.notify_all();
+        job_added_.notify_all();
+        frame_rendered_.notify_all();
+    }
+
+    for (auto & t : threads_) {
+        t->join();
+    }
+
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    stats_.elapsed_seconds = seconds_since(started_at_);
+}
+
+pipeline_stats_t ClippingPipeline::stats() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    pipeline_stats_t result = stats_;
+    if (!stopping_) {
+        result.elapsed_seconds = seconds_since(started_at_);
+    }
+    return result;
+}
+
+}  // namespace vcutter
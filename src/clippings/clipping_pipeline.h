@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_CLIPPINGS_CLIPPING_PIPELINE_H_
+#define SRC_CLIPPINGS_CLIPPING_PIPELINE_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/chrono.hpp>
+
+#include "src/clippings/clipping_key.h"
+#include "src/common/buffers.h"
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+typedef enum {
+    frame_format_rgb24 = 0,
+    frame_format_yuv420p = 1  // packed planes: y (w * h), u (w/2 * h/2) and v (w/2 * h/2)
+} frame_format_t;
+
+typedef std::function<void(const ClippingKey& key, uint8_t *source_buffer, uint8_t *output_buffer)> frame_render_cb_t;
+typedef std::function<bool(uint8_t *output_buffer, frame_format_t format)> frame_output_cb_t;
+typedef std::function<bool(uint8_t *output_buffer, frame_format_t *format)> frame_fill_cb_t;
+
+typedef struct {
+    uint32_t frames;
+    double busy_seconds;  // summed over every thread of the stage
+} stage_stats_t;
+
+typedef struct {
+    stage_stats_t decode;
+    stage_stats_t render;
+    stage_stats_t encode;
+    uint32_t render_threads;
+    double elapsed_seconds;
+} pipeline_stats_t;
+
+// frames per second a single thread of the stage is able to process
+double stage_fps(const stage_stats_t& stats);
+
+/*
+ * Splits the conversion in three stages: the caller decodes and pushes the source frames
+ * (the time between two pushes is accounted as decoding time),
+ * a pool of workers renders them and a single thread delivers the rendered frames to the
+ * output callback following the sequence numbers given to push (starting at zero).
+ * The output buffers share max_memory with the source buffers, the latter are only allocated when
+ * push copies raw pixels: frame handles are rendered in place. push blocks while render_threads + 1
+ * frames wait for the render stage or while every output buffer is in use.
+ */
+class ClippingPipeline {
+    ClippingPipeline(const ClippingPipeline&) = delete;
+    ClippingPipeline& operator=(const ClippingPipeline&) = delete;
+ public:
+    ClippingPipeline(
+        uint32_t source_size,
+        uint32_t output_size,
+        uint32_t max_memory,
+        uint32_t render_threads,
+        frame_render_cb_t render_cb,
+        frame_output_cb_t output_cb);
+
+    virtual ~ClippingPipeline();
+
+    // the number of rendered frames the pipeline can hold at the same time
+    uint32_t output_slots() const;
+
+    // return false if the output callback stopped the pipeline.
+    bool push(const ClippingKey& key, const uint8_t *source_buffer, uint32_t sequence);
+    // the render stage reads the frame without copying it. it must be rgb24 with packed rows (vs::Decoder::frame())
+    bool push(const ClippingKey& key, vs::frame_ref_t source_frame, uint32_t sequence);
+
+    // crop a w x h area at (x, y) of the decoded planes straight into an output buffer (skips the render stage).
+    // x, y, w and h must be even.
+    bool push_yuv(const vs::yuv_planes_t& planes, int x, int y, int w, int h, uint32_t sequence);
+
+    // deliver a frame rendered earlier: fill_cb copies it to the output buffer (skips the render stage).
+    // return false if fill_cb failed or the output callback stopped the pipeline.
+    bool push_rendered(frame_fill_cb_t fill_cb, uint32_t sequence);
+
+    // wait every pushed frame to be delivered. return false if the output callback stopped the pipeline.
+    bool wait_delivered();
+
+    // wait every pushed frame to be delivered and stop the threads
+    bool finish();
+
+    pipeline_stats_t stats();
+
+    static uint32_t default_render_threads();
+
+ private:
+    typedef struct {
+        ClippingKey key;
+        vs::frame_ref_t source_frame;  // rendered in place of the source slot contents when set
+        uint32_t source_slot;  // kNO_SLOT when source_frame is set
+        uint32_t output_slot;
+        uint32_t sequence;
+    } render_job_t;
+
+    bool push_source(const ClippingKey& key, const uint8_t *source_buffer, vs::frame_ref_t source_frame, uint32_t sequence);
+    void render_thread();
+    void output_thread();
+    uint32_t acquire_slot(std::vector<uint32_t> *free_slots, boost::unique_lock<boost::mutex> *lock);
+    uint32_t acquire_source_slot();
+    void release_output_slot(uint32_t slot);
+    void add_rendered(uint32_t output_slot, uint32_t sequence);
+    void stop();
+
+ private:
+    std::vector<std::shared_ptr<CharBuffer> > sources_;
+    std::vector<std::shared_ptr<CharBuffer> > outputs_;
+    std::vector<uint32_t> free_sources_;
+    std::vector<uint32_t> free_outputs_;
+    std::vector<frame_format_t> output_formats_;
+    std::deque<render_job_t> jobs_;
+    std::map<uint32_t, uint32_t> rendered_;  // sequence -> output slot
+    std::vector<std::shared_ptr<boost::thread> > threads_;
+    boost::mutex mtx_;
+    boost::condition_variable slot_released_;
+    boost::condition_variable job_added_;
+    boost::condition_variable frame_rendered_;
+    frame_render_cb_t render_cb_;
+    frame_output_cb_t output_cb_;
+    uint32_t source_size_;
+    uint32_t output_size_;
+    uint32_t output_count_;
+    uint32_t max_sources_;
+    uint32_t sources_in_flight_;
+    uint64_t max_memory_;
+    uint64_t used_memory_;
+    uint32_t pending_frames_;
+    uint32_t next_sequence_;
+    bool canceled_;
+    bool stopping_;
+    pipeline_stats_t stats_;
+    boost::chrono::steady_clock::time_point started_at_;
+    boost::chrono::steady_clock::time_point last_push_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_CLIPPINGS_CLIPPING_PIPELINE_H_
@@ -1,60 +1,47 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <string.h>
 #include <opencv2/opencv.hpp>
 #include <opencv2/video/video.hpp>
 #include "src/clippings/clipping_render.h"
 
 namespace vcutter {
 
-namespace tmp { // temporay namespace (will be removed soon)
+namespace {
 
-void adjust_regions_of_interest(double scale, const cv::Mat& source, const cv::Mat& target, cv::Rect *roi_in,  cv::Rect *roi_out) {
-  if (roi_in->x < 0) {
-    roi_in->width += roi_in->x;
-    int x = scale * -roi_in->x;
-    roi_out->x = x;
-    roi_out->width -= x;
-    roi_in->x = 0;
-  }
-
-  if (roi_in->y < 0) {
-    roi_in->height += roi_in->y;
-    int y = scale * -roi_in->y;
-    roi_out->y = y;
-    roi_out->height -= y;
-    roi_in->y = 0;
-  }
+// the lanczos kernel reads 4 pixels around the sample and the rotation map rounds the square center
+const int kWARP_BORDER = 8;
 
-  if (roi_in->x + roi_in->width > source.cols) {
-    int pass_x = roi_in->x + roi_in->width - source.cols;
-    roi_in->width -= pass_x;
-    pass_x *= scale;
-    roi_out->width -= pass_x;
-  }
-
-  if (roi_in->y + roi_in->height > source.rows) {
-    int pass_y = roi_in->y + roi_in->height - source.rows;
-    roi_in->height -= pass_y;
-    pass_y *= scale;
-    roi_out->height -= pass_y;
-  }
-}
-
-void copy_center(cv::Mat& source, cv::Mat& target) {
-  int dx = source.cols - target.cols;
-  int dy = source.rows - target.rows;
-  cv::Rect roi_in(dx / 2, dy / 2, target.cols, target.rows);
-  cv::Rect roi_out(0, 0, target.cols, target.rows);
-  tmp::adjust_regions_of_interest(1.0, source, target, &roi_in, &roi_out);
-  if (roi_in.width < 1 || roi_in.height < 1 || roi_out.width < 1 || roi_out.height < 1)
-      return;
-  cv::Mat roi_img_in(source(roi_in));
-  cv::Mat roi_img_out(target(roi_out));
-  roi_img_in.copyTo(roi_img_out);
+/*
+ * The inverse map (output -> source) of the rotated clippings. It composes the steps of the former kernel
+ * (copy the bounding box to the center of a square, rotate it around the center, crop the center
+ * at the clipping size and resize it to the output) keeping their rounding, so the output does not shift.
+ */
+cv::Matx23d rotation_map(ClippingKey key, int bbox_w, int bbox_h, uint32_t target_w, uint32_t target_h) {
+    int square = static_cast<int>(sqrt(bbox_w * bbox_w + bbox_h * bbox_h)) + 2;
+    int clipping_w = target_w * key.scale;
+    int clipping_h = target_h * key.scale;
+
+    // resize: output pixel centers -> clipping
+    double fx = static_cast<double>(clipping_w) / target_w;
+    double fy = static_cast<double>(clipping_h) / target_h;
+
+    // crop + rotation center: clipping -> square centered at the origin
+    double ex = fx * 0.5 - 0.5 + (square - clipping_w) / 2 - square / 2;
+    double ey = fy * 0.5 - 0.5 + (square - clipping_h) / 2 - square / 2;
+
+    double radians = (key.angle() - 360) * CV_PI / 180.0;
+    double alpha = cos(radians);
+    double beta = sin(radians);
+
+    // inverse rotation and the translation to the clipping center at the source
+    return cv::Matx23d(
+        alpha * fx, -beta * fy, alpha * ex - beta * ey + key.px,
+        beta * fx, alpha * fy, beta * ex + alpha * ey + key.py);
 }
 
-}  // namespace tmp
+}  // namespace
 
 ClippingRender::ClippingRender(const char *path, bool path_is_video, frame_callback_t frame_cb) : ClippingFrame(path, path_is_video, frame_cb) {
 }
@@ -63,9 +50,15 @@ ClippingRender::ClippingRender(const Json::Value * root, frame_callback_t frame_
 }
 
 void ClippingRender::render(ClippingKey key, uint8_t *source_buffer, uint32_t target_w, uint32_t target_h, uint8_t *buffer) {
-    // TODO(Rodrigo Simplify this logic):
-    int source_w = player()->info()->w();
-    int source_h = player()->info()->h();
+    render(key, source_buffer, player()->info()->w(), player()->info()->h(), target_w, target_h, buffer);
+}
+
+void ClippingRender::render(
+    ClippingKey key, uint8_t *source_buffer, uint32_t source_w, uint32_t source_h, uint32_t target_w, uint32_t target_h, uint8_t *buffer
+) {
+    // the keys have the coordinates of the video size, a smaller source (a proxy frame) scales them
+    double fx = source_w / static_cast<double>(player()->info()->w());
+    double fy = source_h / static_cast<double>(player()->info()->h());
 
     key = key.constrained(this);
 
@@ -77,38 +70,78 @@ void ClippingRender::render(ClippingKey key, uint8_t *source_buffer, uint32_t ta
     cv::Mat frame(source_h, source_w, CV_8UC3, source_buffer);
     cv::Mat output(target_h, target_w, CV_8UC3, buffer);
     if (key.angle() == 0) {
-        cv::Rect roi_input(bbox[0].x, bbox[0].y, bbox_w, bbox_h);
+        cv::Rect roi_input(bbox[0].x * fx, bbox[0].y * fy, bbox_w * fx, bbox_h * fy);
+        roi_input &= cv::Rect(0, 0, source_w, source_h);
+        if (roi_input.width < 1 || roi_input.height < 1) {
+            return;
+        }
         cv::Mat roi_img_in(frame(roi_input));
 
         cv::resize(roi_img_in, output, output.size(), CV_INTER_LANCZOS4);
         return;
     }
 
-    int hypo = sqrt(bbox_w * bbox_w + bbox_h * bbox_h);
-    cv::Mat rotated = cv::Mat(hypo + 2, hypo + 2, CV_8UC3);
+    cv::Matx23d map = rotation_map(key, bbox_w, bbox_h, target_w, target_h);
+    if (source_w != player()->info()->w() || source_h != player()->info()->h()) {
+        // to the pixel centers of the smaller source
+        for (int i = 0; i < 3; ++i) {
+            map(0, i) *= fx;
+            map(1, i) *= fy;
+        }
+        map(0, 2) += fx * 0.5 - 0.5;
+        map(1, 2) += fy * 0.5 - 0.5;
+    }
+
+    // a single pass straight into the output buffer
+    cv::warpAffine(
+        frame, output, map, output.size(),
+        CV_INTER_LANCZOS4 | CV_WARP_INVERSE_MAP, cv::BORDER_CONSTANT);
+}
+
+bool ClippingRender::crop_area(ClippingKey key, int *x, int *y) {
+    int source_w = player()->info()->w();
+    int source_h = player()->info()->h();
+    int target_w = w();
+    int target_h = h();
+
+    key = key.constrained(this);
+
+    if (key.angle() != 0 || target_w % 2 || target_h % 2) {
+        return false;
+    }
+
+    box_t bbox = key.clipping_box(this).occupied_area();
 
-    int half_w = bbox_w / 2;
-    int half_h = bbox_h / 2;
-    cv::Rect roi_input(key.px - half_w, key.py - half_h, bbox_w, bbox_h);
+    int bbox_w = bbox[1].x - bbox[0].x;
+    int bbox_h = bbox[2].y - bbox[0].y;
 
-    half_w = rotated.cols / 2;
-    half_h = rotated.rows / 2;
-    cv::Rect roi_output(half_w - bbox_w / 2, half_h - bbox_h / 2, bbox_w, bbox_h);
+    if (bbox_w != target_w || bbox_h != target_h) {
+        return false;
+    }
 
-    cv::Mat roi_img_in(frame(roi_input));
-    cv::Mat roi_img_out(rotated(roi_output));
-    roi_img_in.copyTo(roi_img_out);
+    // the chroma planes have half of the resolution
+    *x = bbox[0].x;
+    *y = bbox[0].y;
 
-    cv::Point2f src_center(half_w, half_h);
+    return *x % 2 == 0 && *y % 2 == 0 &&
+        *x >= 0 && *y >= 0 &&
+        *x + target_w <= source_w && *y + target_h <= source_h;
+}
 
-    cv::Mat rot_mat = cv::getRotationMatrix2D(src_center, key.angle() - 360, 1.0);
-    cv::Mat temp;
-    cv::warpAffine(rotated, temp, rot_mat, rotated.size(), CV_INTER_LANCZOS4);
-    rotated = cv::Mat(target_h * key.scale, target_w * key.scale, CV_8UC3);
+vs::frame_area_t ClippingRender::source_area(ClippingKey key) {
+    key = key.constrained(this);
 
-    tmp::copy_center(temp, rotated);
+    box_t bbox = key.clipping_box(this).occupied_area();
 
-    cv::resize(rotated, output, output.size(), CV_INTER_LANCZOS4);
+    int border = key.angle() == 0 ? 0 : kWARP_BORDER;
+
+    vs::frame_area_t area;
+    area.x = static_cast<int>(bbox[0].x) - border;
+    area.y = static_cast<int>(bbox[0].y) - border;
+    area.w = static_cast<int>(bbox[1].x - bbox[0].x) + border * 2;
+    area.h = static_cast<int>(bbox[2].y - bbox[0].y) + border * 2;
+
+    return area;
 }
 
 void ClippingRender::render(ClippingKey key, uint8_t *player_buffer, uint8_t *buffer) {
@@ -121,21 +154,25 @@ void ClippingRender::render(ClippingKey key, uint8_t *player_buffer, uint8_t *bu
 }
 
 void ClippingRender::render(ClippingKey key, uint32_t target_w, uint32_t target_h, uint8_t *buffer) {
+    // the decoder runs ahead while playing, only the presented frame matches the position on the screen
+    vs::frame_ref_t frame = player()->display_frame();
+    if (!frame) {
+        memset(buffer, 0, target_w * target_h * 3);
+        return;
+    }
+
     render(
         key,
-        player()->info()->buffer(),
+        const_cast<uint8_t *>(frame->data()),
+        frame->w(),
+        frame->h(),
         target_w,
         target_h,
         buffer);
 }
 
 void ClippingRender::render(ClippingKey key, uint8_t *buffer) {
-    render(
-        key,
-        player()->info()->buffer(),
-        w(),
-        h(),
-        buffer);
+    render(key, w(), h(), buffer);
 }
 
 std::shared_ptr<ClippingRender> ClippingRender::clone() {
@@ -18,12 +18,20 @@ class ClippingRender: public ClippingFrame {
     explicit ClippingRender(const Json::Value * root, frame_callback_t frame_cb);
     ClippingRender(const char *path, bool path_is_video,  frame_callback_t frame_cb);
     virtual ~ClippingRender(){}
+    // render from the frame the player presented to the ui (it may be smaller than the video)
     void render(ClippingKey key, uint32_t target_w, uint32_t target_h, uint8_t *buffer);
     void render(ClippingKey key, uint8_t *buffer);
     void render(ClippingKey key, uint8_t *player_buffer, uint8_t *buffer);
+    // return true when rendering the key is a plain w() x h() crop at (x, y) with even coordinates
+    bool crop_area(ClippingKey key, int *x, int *y);
+    // the part of the source frame that rendering the key reads (it can exceed the frame)
+    vs::frame_area_t source_area(ClippingKey key);
     std::shared_ptr<ClippingRender> clone();
  private:
     void render(ClippingKey key, uint8_t *source_buffer, uint32_t target_w, uint32_t target_h, uint8_t *buffer);
+    void render(
+        ClippingKey key, uint8_t *source_buffer, uint32_t source_w, uint32_t source_h,
+        uint32_t target_w, uint32_t target_h, uint8_t *buffer);
 };
 
 }  // namespace vcutter
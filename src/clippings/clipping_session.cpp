@@ -1,8 +1,8 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
-#include <FL/Fl.H>
 #include "src/clippings/clipping_session.h"
+#include "src/common/event_loop.h"
 #include "src/common/utils.h"
 
 namespace vcutter {
@@ -13,7 +13,7 @@ const char *kCLIPPING_SESSION_NAME = "-clipping-session.vcutter";
 
 ClippingSession::ClippingSession(const char *session_name, const char *path, bool path_is_video, frame_callback_t frame_cb)
  : Clipping(path, path_is_video, frame_cb), session_name_(session_name) {
-    Fl::add_timeout(1.0, &ClippingSession::fltk_timeout_handler, this);
+    add_timeout(1.0, &ClippingSession::fltk_timeout_handler, this);
 }
 
 ClippingSession::ClippingSession(const char *session_name, const Json::Value * root, frame_callback_t frame_cb)
@@ -21,13 +21,13 @@ ClippingSession::ClippingSession(const char *session_name, const Json::Value * r
 }
 
 ClippingSession::~ClippingSession() {
-    Fl::remove_timeout(&ClippingSession::fltk_timeout_handler, this);
+    remove_timeout(&ClippingSession::fltk_timeout_handler, this);
     remove_session();
 }
 
 void ClippingSession::fltk_timeout_handler(void* clipping_session) {
     static_cast<ClippingSession *>(clipping_session)->save_session();
-    Fl::repeat_timeout(1.0, &ClippingSession::fltk_timeout_handler, clipping_session);
+    repeat_timeout(1.0, &ClippingSession::fltk_timeout_handler, clipping_session);
 }
 
 void ClippingSession::save_session() {
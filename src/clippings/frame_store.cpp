@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include "src/clippings/frame_store.h"
+#include "src/common/utils.h"
+
+namespace vcutter {
+
+namespace {
+
+const uint32_t kMAX_RUN = 128;
+const uint32_t kMIN_RUN = 3;
+
+uint32_t delta_stride(frame_format_t format) {
+    // the rgb pixels are predicted from the same channel of the pixel at the left
+    return format == frame_format_rgb24 ? 3 : 1;
+}
+
+void delta_encode(const uint8_t *source, uint32_t size, uint32_t stride, uint8_t *target) {
+    uint32_t i = 0;
+    for (; i < stride && i < size; ++i) {
+        target[i] = source[i];
+    }
+    for (; i < size; ++i) {
+        target[i] = source[i] - source[i - stride];
+    }
+}
+
+void delta_decode(uint8_t *buffer, uint32_t size, uint32_t stride) {
+    for (uint32_t i = stride; i < size; ++i) {
+        buffer[i] += buffer[i - stride];
+    }
+}
+
+/*
+ * packbits: a header h < 128 is followed by h + 1 literal bytes,
+ * a header h > 128 is followed by a byte repeated 257 - h times.
+ * return 0 when the result would not fit in limit bytes.
+ */
+uint32_t pack_runs(const uint8_t *source, uint32_t size, uint8_t *target, uint32_t limit) {
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    while (in < size) {
+        uint32_t run = 1;
+        while (in + run < size && run < kMAX_RUN && source[in + run] == source[in]) {
+            ++run;
+        }
+
+        if (run >= kMIN_RUN) {
+            if (out + 2 > limit) {
+                return 0;
+            }
+            target[out++] = static_cast<uint8_t>(257 - run);
+            target[out++] = source[in];
+            in += run;
+            continue;
+        }
+
+        uint32_t start = in;
+        uint32_t count = 0;
+        while (in < size && count < kMAX_RUN) {
+            if (in + 2 < size && source[in] == source[in + 1] && source[in] == source[in + 2]) {
+                break;
+            }
+            ++in;
+            ++count;
+        }
+
+        if (out + 1 + count > limit) {
+            return 0;
+        }
+        target[out++] = static_cast<uint8_t>(count - 1);
+        memcpy(target + out, source + start, count);
+        out += count;
+    }
+
+    return out;
+}
+
+bool unpack_runs(const uint8_t *source, uint32_t size, uint8_t *target, uint32_t target_size) {
+    uint32_t in = 0;
+    uint32_t out = 0;
+
+    while (in < size) {
+        uint8_t header = source[in++];
+        if (header < 128) {
+            uint32_t count = header + 1;
+            if (in + count > size || out + count > target_size) {
+                return false;
+            }
+            memcpy(target + out, source + in, count);
+            in += count;
+            out += count;
+        } else if (header > 128) {
+            uint32_t count = 257 - header;
+            if (in >= size || out + count > target_size) {
+                return false;
+            }
+            memset(target + out, source[in++], count);
+            out += count;
+        }
+    }
+
+    return out == target_size;
+}
+
+}  // namespace
+
+FrameStore::FrameStore(uint32_t frame_size, uint32_t frame_count, uint64_t max_memory, const char *scratch_dir, bool compress) {
+    frame_size_ = frame_size;
+    compress_ = compress;
+    spilled_bytes_ = 0;
+    scratch_dir_ = scratch_dir ? scratch_dir : temp_filepath(NULL);
+
+    uint64_t memory_frames = frame_size ? max_memory / frame_size : frame_count;
+    memory_frames_ = memory_frames < frame_count ? static_cast<uint32_t>(memory_frames) : frame_count;
+
+    frame_entry_t empty;
+    memset(&empty, 0, sizeof(empty));
+    entries_.resize(frame_count, empty);
+    memory_.resize(memory_frames_);
+}
+
+FrameStore::~FrameStore() {
+    scratch_region_.reset();
+    scratch_file_.reset();
+
+    if (!scratch_path_.empty()) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(scratch_path_, ec);
+    }
+}
+
+bool FrameStore::report_error(const std::string& error) {
+    error_ = error;
+    return false;
+}
+
+const char *FrameStore::error() const {
+    if (error_.length()) {
+        return error_.c_str();
+    }
+    return NULL;
+}
+
+uint32_t FrameStore::memory_frames() const {
+    return memory_frames_;
+}
+
+uint32_t FrameStore::spilled_frames() const {
+    return entries_.size() - memory_frames_;
+}
+
+uint64_t FrameStore::spilled_bytes() const {
+    return spilled_bytes_;
+}
+
+bool FrameStore::open_scratch() {
+    // every spilled frame has a slot of frame_size bytes. the file is sparse, so the
+    // compressed frames use only the blocks they write.
+    uint64_t file_size = static_cast<uint64_t>(spilled_frames()) * frame_size_;
+    boost::filesystem::path path = boost::filesystem::path(scratch_dir_) /
+        boost::filesystem::unique_path("vcutter-%%%%-%%%%-%%%%.frames");
+
+    {
+        std::ofstream file(path.string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return report_error(std::string("Could not create the scratch file ") + path.string());
+        }
+    }
+
+    scratch_path_ = path.string();
+
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(path, file_size, ec);
+    if (ec) {
+        return report_error(std::string("Could not allocate the scratch file: ") + ec.message());
+    }
+
+    try {
+        scratch_file_.reset(new boost::interprocess::file_mapping(
+            scratch_path_.c_str(), boost::interprocess::read_write));
+        scratch_region_.reset(new boost::interprocess::mapped_region(
+            *scratch_file_, boost::interprocess::read_write));
+    } catch (const boost::interprocess::interprocess_exception& e) {
+        scratch_region_.reset();
+        scratch_file_.reset();
+        return report_error(std::string("Could not map the scratch file: ") + e.what());
+    }
+
+    if (compress_) {
+        delta_.reset(new CharBuffer(frame_size_));
+    }
+
+    return true;
+}
+
+uint8_t *FrameStore::spill_slot(uint32_t index) {
+    uint64_t offset = static_cast<uint64_t>(index - memory_frames_) * frame_size_;
+    return static_cast<uint8_t *>(scratch_region_->get_address()) + offset;
+}
+
+bool FrameStore::put(uint32_t index, const uint8_t *data, uint32_t size, frame_format_t format) {
+    if (index >= entries_.size() || size > frame_size_) {
+        return report_error("The frame does not fit in the frame store");
+    }
+
+    frame_entry_t & entry = entries_[index];
+    entry.raw_size = size;
+    entry.size = size;
+    entry.format = format;
+    entry.compressed = false;
+
+    if (index < memory_frames_) {
+        if (!memory_[index]) {
+            memory_[index].reset(new CharBuffer(frame_size_));
+        }
+        memcpy(memory_[index]->data, data, size);
+        entry.stored = true;
+        return true;
+    }
+
+    if (!scratch_region_ && !open_scratch()) {
+        return false;
+    }
+
+    uint8_t *slot = spill_slot(index);
+
+    if (compress_ && size > 1) {
+        delta_encode(data, size, delta_stride(format), delta_->data);
+        uint32_t packed = pack_runs(delta_->data, size, slot, size - 1);
+        if (packed) {
+            entry.size = packed;
+            entry.compressed = true;
+        }
+    }
+
+    if (!entry.compressed) {
+        memcpy(slot, data, size);
+    }
+
+    spilled_bytes_ += entry.size;
+    entry.stored = true;
+
+    return true;
+}
+
+bool FrameStore::get(uint32_t index, uint8_t *buffer, frame_format_t *format) {
+    if (index >= entries_.size() || !entries_[index].stored) {
+        return report_error("The frame is not in the frame store");
+    }
+
+    const frame_entry_t & entry = entries_[index];
+    *format = entry.format;
+
+    if (index < memory_frames_) {
+        memcpy(buffer, memory_[index]->data, entry.size);
+        return true;
+    }
+
+    const uint8_t *slot = spill_slot(index);
+
+    if (!entry.compressed) {
+        memcpy(buffer, slot, entry.size);
+        return true;
+    }
+
+    if (!unpack_runs(slot, entry.size, buffer, entry.raw_size)) {
+        return report_error("The scratch file is corrupted");
+    }
+
+    delta_decode(buffer, entry.raw_size, delta_stride(entry.format));
+
+    return true;
+}
+
+}  // namespace vcutter
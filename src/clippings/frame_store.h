@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_CLIPPINGS_FRAME_STORE_H_
+#define SRC_CLIPPINGS_FRAME_STORE_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "src/clippings/clipping_pipeline.h"
+#include "src/common/buffers.h"
+
+namespace vcutter {
+
+/*
+ * Keeps frame_count rendered frames of up to frame_size bytes each.
+ * The first frames go to memory until max_memory is used, the others to a memory mapped
+ * scratch file (created inside scratch_dir on the first spill and removed by the destructor).
+ * With compress the spilled frames are delta coded and run length encoded, a frame that
+ * does not shrink is kept as is. The store is not thread safe.
+ */
+class FrameStore {
+    FrameStore(const FrameStore&) = delete;
+    FrameStore& operator=(const FrameStore&) = delete;
+ public:
+    FrameStore(uint32_t frame_size, uint32_t frame_count, uint64_t max_memory, const char *scratch_dir=NULL, bool compress=false);
+    virtual ~FrameStore();
+
+    bool put(uint32_t index, const uint8_t *data, uint32_t size, frame_format_t format);
+    // copy the frame to buffer (at least frame_size bytes)
+    bool get(uint32_t index, uint8_t *buffer, frame_format_t *format);
+
+    uint32_t memory_frames() const;
+    uint32_t spilled_frames() const;
+    // bytes written to the scratch file
+    uint64_t spilled_bytes() const;
+    const char *error() const;
+
+ private:
+    typedef struct {
+        uint32_t size;  // stored size (the compressed one when compressed is set)
+        uint32_t raw_size;
+        frame_format_t format;
+        bool stored;
+        bool compressed;
+    } frame_entry_t;
+
+    bool open_scratch();
+    uint8_t *spill_slot(uint32_t index);
+    bool report_error(const std::string& error);
+
+ private:
+    std::vector<std::shared_ptr<CharBuffer> > memory_;
+    std::vector<frame_entry_t> entries_;
+    std::unique_ptr<boost::interprocess::file_mapping> scratch_file_;
+    std::unique_ptr<boost::interprocess::mapped_region> scratch_region_;
+    std::unique_ptr<CharBuffer> delta_;
+    std::string scratch_dir_;
+    std::string scratch_path_;
+    std::string error_;
+    uint32_t frame_size_;
+    uint32_t memory_frames_;
+    uint64_t spilled_bytes_;
+    bool compress_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_CLIPPINGS_FRAME_STORE_H_
@@ -2,10 +2,146 @@
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
 #include <string.h>
+#include <new>
+#include <boost/align/aligned_alloc.hpp>
 #include "src/common/buffers.h"
 
 namespace vcutter {
 
+namespace {
+
+const uint32_t kMIN_SIZE_CLASS = 4096;
+
+}  // namespace
+
+const uint32_t BufferPool::kALIGNMENT;
+const uint64_t BufferPool::kDEFAULT_MAX_POOLED_BYTES;
+
+BufferPool *buffer_pool() {
+    // never destroyed: static objects may release their buffers after the exit handlers run
+    static BufferPool *pool = new BufferPool();
+    return pool;
+}
+
+BufferPool::BufferPool(uint64_t max_pooled_bytes) {
+    max_pooled_bytes_ = max_pooled_bytes;
+    memset(&stats_, 0, sizeof(stats_));
+}
+
+BufferPool::~BufferPool() {
+    trim();
+}
+
+uint32_t BufferPool::size_class(uint32_t size) {
+    if (size <= kMIN_SIZE_CLASS) {
+        return kMIN_SIZE_CLASS;
+    }
+
+    uint64_t power = kMIN_SIZE_CLASS;
+    while (power * 2 < size) {
+        power *= 2;
+    }
+
+    // the buffers waste less than a quarter of the power of two
+    uint64_t step = power / 4;
+    uint64_t result = ((size + step - 1) / step) * step;
+    return result > 0xFFFFFFFF ? size : static_cast<uint32_t>(result);
+}
+
+uint8_t *BufferPool::acquire(uint32_t size, uint32_t *capacity) {
+    *capacity = size_class(size);
+
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        stats_.live_bytes += *capacity;
+        if (stats_.live_bytes > stats_.peak_bytes) {
+            stats_.peak_bytes = stats_.live_bytes;
+        }
+
+        auto it = free_.find(*capacity);
+        if (it != free_.end() && !it->second.empty()) {
+            uint8_t *data = it->second.back();
+            it->second.pop_back();
+            stats_.pooled_bytes -= *capacity;
+            ++stats_.reuses;
+            return data;
+        }
+
+        ++stats_.allocations;
+    }
+
+    uint8_t *data = static_cast<uint8_t *>(boost::alignment::aligned_alloc(kALIGNMENT, *capacity));
+    if (!data) {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        stats_.live_bytes -= *capacity;
+        throw std::bad_alloc();
+    }
+
+    return data;
+}
+
+void BufferPool::release(uint8_t *data, uint32_t capacity) {
+    if (!data) {
+        return;
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        stats_.live_bytes -= capacity;
+        if (stats_.pooled_bytes + capacity <= max_pooled_bytes_) {
+            free_[capacity].push_back(data);
+            stats_.pooled_bytes += capacity;
+            return;
+        }
+    }
+
+    boost::alignment::aligned_free(data);
+}
+
+void BufferPool::trim() {
+    std::map<uint32_t, std::vector<uint8_t *> > released;
+
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        released.swap(free_);
+        stats_.pooled_bytes = 0;
+    }
+
+    for (auto & size_class : released) {
+        for (uint8_t *data : size_class.second) {
+            boost::alignment::aligned_free(data);
+        }
+    }
+}
+
+buffer_pool_stats_t BufferPool::stats() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return stats_;
+}
+
+CharBuffer::CharBuffer(uint32_t size) {
+    size_ = size;
+    data = buffer_pool()->acquire(size, &capacity_);
+}
+
+CharBuffer::~CharBuffer() {
+    buffer_pool()->release(data, capacity_);
+}
+
+void CharBuffer::resize(uint32_t size) {
+    size_ = size;
+    if (size <= capacity_) {
+        return;
+    }
+    buffer_pool()->release(data, capacity_);
+    data = NULL;
+    data = buffer_pool()->acquire(size, &capacity_);
+}
+
+uint32_t CharBuffer::size() const {
+    return size_;
+}
+
 StackBuffer::StackBuffer(uint32_t individual_size, uint32_t buffer_count) {
     buffer_index_ = 0;
     individual_size_ = individual_size;
@@ -4,25 +4,72 @@
 #ifndef SRC_COMMON_BUFFERS_H_
 #define SRC_COMMON_BUFFERS_H_
 
+#include <inttypes.h>
+#include <map>
 #include <memory>
 #include <vector>
+#include <boost/thread.hpp>
 
 
 namespace vcutter {
 
+typedef struct {
+    uint64_t live_bytes;    // capacity of the buffers in use
+    uint64_t peak_bytes;    // the highest live_bytes
+    uint64_t pooled_bytes;  // capacity of the released buffers kept for reuse
+    uint64_t allocations;   // buffers allocated from the heap
+    uint64_t reuses;        // buffers handed out again
+} buffer_pool_stats_t;
+
+/*
+ * Recycles the frame sized buffers. The sizes are rounded up to a size class
+ * (four classes for each power of two) and the buffers are aligned to kALIGNMENT bytes.
+ * Released buffers are kept for the next acquire up to max_pooled_bytes. Thread safe.
+ */
+class BufferPool {
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+ public:
+    explicit BufferPool(uint64_t max_pooled_bytes=kDEFAULT_MAX_POOLED_BYTES);
+    virtual ~BufferPool();
+
+    // capacity receives the size of the buffer (its size class)
+    uint8_t *acquire(uint32_t size, uint32_t *capacity);
+    void release(uint8_t *data, uint32_t capacity);
+    // free the buffers kept for reuse
+    void trim();
+    buffer_pool_stats_t stats();
+
+    static uint32_t size_class(uint32_t size);
+
+    static const uint32_t kALIGNMENT = 64;
+    static const uint64_t kDEFAULT_MAX_POOLED_BYTES = 128 * 1024 * 1024;
+
+ private:
+    std::map<uint32_t, std::vector<uint8_t *> > free_;  // size class -> released buffers
+    boost::mutex mtx_;
+    buffer_pool_stats_t stats_;
+    uint64_t max_pooled_bytes_;
+};
+
+// the pool of the char buffers
+BufferPool *buffer_pool();
+
 class CharBuffer {
    CharBuffer(const CharBuffer&) = delete;
    CharBuffer& operator=(const CharBuffer&) = delete;
  public:
-    CharBuffer(uint32_t size) {
-        data = new uint8_t[size];
-    }
+    CharBuffer(uint32_t size);
+    ~CharBuffer();
 
-    ~CharBuffer() {
-        delete[] data;
-    }
+    // the contents are kept only when size fits the current capacity
+    void resize(uint32_t size);
+    uint32_t size() const;
 
     uint8_t *data;
+ private:
+    uint32_t size_;
+    uint32_t capacity_;
 };
 
 
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_COMMON_EVENT_LOOP_H_
+#define SRC_COMMON_EVENT_LOOP_H_
+
+namespace vcutter {
+
+/*
+ * The user interface loop used by the players, sessions and conversions.
+ * The application implements it with fltk (src/wnd_common) and the command line tool without a ui (src/cli).
+ */
+
+typedef void (*timeout_handler_t)(void *data);
+
+// process the pending events (or just sleep when there is no ui) up to timeout seconds
+void wait_events(double timeout);
+void add_timeout(double timeout, timeout_handler_t handler, void *data);
+void repeat_timeout(double timeout, timeout_handler_t handler, void *data);
+void remove_timeout(timeout_handler_t handler, void *data);
+// the handler runs every time the loop wakes up
+void add_check(timeout_handler_t handler, void *data);
+void remove_check(timeout_handler_t handler, void *data);
+// thread safe: wakes up the loop, so the checks run
+void awake();
+
+}  // namespace vcutter
+
+#endif  // SRC_COMMON_EVENT_LOOP_H_
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_COMMON_TRIPLE_BUFFER_H_
+#define SRC_COMMON_TRIPLE_BUFFER_H_
+
+#include <inttypes.h>
+#include <atomic>
+
+namespace vcutter {
+
+/*
+ * Hands values from one writer thread to one reader thread without locks.
+ * The writer fills back() and publishes it, the reader takes the last published value with update()
+ * and reads front(). Each side owns its slot, the third one is swapped between them, so the reader
+ * never sees a value being written and the writer never waits (the values not taken in time are skipped).
+ */
+template <class T>
+class TripleBuffer {
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+ public:
+    TripleBuffer() : back_(0), front_(1), middle_(2) {}
+
+    // writer thread
+    T& back() {
+        return slots_[back_];
+    }
+
+    // writer thread: back() goes to the reader, the writer gets the slot the reader did not take
+    void publish() {
+        uint8_t middle = middle_.exchange(back_ | kPUBLISHED, std::memory_order_acq_rel);
+        back_ = middle & kINDEX_MASK;
+    }
+
+    // reader thread: return false when nothing was published since the last update
+    bool update() {
+        if (!(middle_.load(std::memory_order_acquire) & kPUBLISHED)) {
+            return false;
+        }
+        uint8_t middle = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = middle & kINDEX_MASK;
+        return true;
+    }
+
+    // reader thread
+    T& front() {
+        return slots_[front_];
+    }
+
+ private:
+    static const uint8_t kINDEX_MASK = 3;
+    static const uint8_t kPUBLISHED = 4;
+
+    T slots_[3];
+    uint8_t back_;   // the writer slot
+    uint8_t front_;  // the reader slot
+    std::atomic<uint8_t> middle_;  // the slot in between and whether it has a new value
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_COMMON_TRIPLE_BUFFER_H_
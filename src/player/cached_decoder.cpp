@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/player/cached_decoder.h"
+
+namespace vcutter {
+
+CachedDecoder::CachedDecoder(std::shared_ptr<vs::Decoder> decoder, uint64_t max_cache_bytes) : cache_(max_cache_bytes) {
+    decoder_ = decoder;
+}
+
+FrameCache *CachedDecoder::cache() {
+    return &cache_;
+}
+
+bool CachedDecoder::use_cached(uint32_t frame) {
+    cached_frame_t cached = cache_.get(frame);
+    if (cached) {
+        if (current_) {
+            previous_ = current_;
+        }
+        current_ = cached;
+        return true;
+    }
+    return false;
+}
+
+void CachedDecoder::decoded() {
+    if (current_) {
+        previous_ = current_;
+    }
+    current_.reset();
+}
+
+void CachedDecoder::cache_current() {
+    current_ = cache_decoded();
+}
+
+cached_frame_t CachedDecoder::cache_decoded() {
+    vs::frame_ref_t decoded = decoder_->frame();
+    if (decoded) {
+        return cache_.put(decoded);
+    }
+
+    return cache_.put(
+        decoder_->position(),
+        decoder_->pts(),
+        decoder_->time(),
+        decoder_->key_frame(),
+        decoder_->buffer(),
+        decoder_->w() * decoder_->h() * 3);
+}
+
+vs::source_type CachedDecoder::source() {
+    return decoder_->source();
+}
+
+uint32_t CachedDecoder::w() {
+    return decoder_->w();
+}
+
+uint32_t CachedDecoder::h() {
+    return decoder_->h();
+}
+
+const char* CachedDecoder::error() {
+    return decoder_->error();
+}
+
+unsigned char *CachedDecoder::buffer() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!current_ && !decoder_->error()) {
+        cache_current();
+    }
+    if (current_) {
+        return const_cast<unsigned char *>(current_->data());
+    }
+    return decoder_->buffer();
+}
+
+uint32_t CachedDecoder::buffer_size() {
+    return decoder_->buffer_size();
+}
+
+uint32_t CachedDecoder::position() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_) {
+        return current_->position;
+    }
+    return decoder_->position();
+}
+
+uint32_t CachedDecoder::count() {
+    return decoder_->count();
+}
+
+double CachedDecoder::fps() {
+    return decoder_->fps();
+}
+
+double CachedDecoder::duration() {
+    return decoder_->duration();
+}
+
+double CachedDecoder::time() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_) {
+        return current_->time;
+    }
+    return decoder_->time();
+}
+
+int64_t CachedDecoder::pts() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_) {
+        return current_->pts;
+    }
+    return decoder_->pts();
+}
+
+int CachedDecoder::ratio_den() {
+    return decoder_->ratio_den();
+}
+
+int CachedDecoder::ratio_num() {
+    return decoder_->ratio_num();
+}
+
+int CachedDecoder::time_den() {
+    return decoder_->time_den();
+}
+
+int CachedDecoder::time_num() {
+    return decoder_->time_num();
+}
+
+bool CachedDecoder::key_frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_) {
+        return current_->key_frame;
+    }
+    return decoder_->key_frame();
+}
+
+vs::decoder_thread_type CachedDecoder::thread_type() {
+    return decoder_->thread_type();
+}
+
+int CachedDecoder::thread_count() {
+    return decoder_->thread_count();
+}
+
+void CachedDecoder::next() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error()) {
+        return;
+    }
+
+    uint32_t frame = position() + 1;
+    if (use_cached(frame)) {
+        return;
+    }
+
+    // the decoder may be elsewhere when the current frame came from the cache
+    if (decoder_->position() + 1 == frame) {
+        decoder_->next();
+    } else {
+        decoder_->seek_frame(frame);
+    }
+
+    decoded();
+}
+
+void CachedDecoder::prior() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error()) {
+        return;
+    }
+
+    uint32_t frame = position();
+    if (frame > 1 && use_cached(frame - 1)) {
+        return;
+    }
+
+    // the decoder steps backwards faster when it is already at the current frame
+    if (decoder_->position() == frame) {
+        decoder_->prior();
+    } else {
+        decoder_->seek_frame(frame - 1);
+    }
+
+    decoded();
+}
+
+void CachedDecoder::seek_frame(int64_t frame) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error()) {
+        return;
+    }
+
+    if (frame > 0 && use_cached(frame)) {
+        return;
+    }
+
+    decoder_->seek_frame(frame);
+    decoded();
+}
+
+void CachedDecoder::seek_time(int64_t ms_time) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error()) {
+        return;
+    }
+
+    decoder_->seek_time(ms_time);
+    decoded();
+}
+
+void CachedDecoder::seek_keyframe(int64_t frame) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error()) {
+        return;
+    }
+
+    // the exact frame is better when it's at hand
+    if (frame > 0 && use_cached(frame)) {
+        return;
+    }
+
+    decoder_->seek_keyframe(frame);
+    decoded();
+}
+
+void CachedDecoder::interrupt_seek() {
+    // no lock, the seek holds it
+    decoder_->interrupt_seek();
+}
+
+uint32_t CachedDecoder::seek_generation() {
+    return decoder_->seek_generation();
+}
+
+void CachedDecoder::claim_seek_generation(uint32_t generation) {
+    decoder_->claim_seek_generation(generation);
+}
+
+bool CachedDecoder::prefetch(uint32_t frame) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+
+    if (decoder_->error() || frame < 1 || frame > decoder_->count() || cache_.contains(frame)) {
+        return false;
+    }
+
+    // the current frame stays at hand while the decoder is elsewhere
+    if (!current_) {
+        cache_current();
+    }
+
+    if (decoder_->position() + 1 == frame) {
+        decoder_->next();
+    } else if (decoder_->position() != frame) {
+        decoder_->seek_frame(frame);
+    }
+
+    // an interrupted seek stops before the frame
+    if (decoder_->position() == frame) {
+        cache_decoded();
+    }
+
+    return true;
+}
+
+void CachedDecoder::follow_source() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    decoded();
+}
+
+void CachedDecoder::skip_non_reference(bool skip) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    decoder_->skip_non_reference(skip);
+}
+
+void CachedDecoder::convert_threads(int count) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    decoder_->convert_threads(count);
+}
+
+bool CachedDecoder::save_keyframe_index(const char *path) {
+    return decoder_->save_keyframe_index(path);
+}
+
+bool CachedDecoder::yuv_planes(vs::yuv_planes_t *planes) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the cache keeps rgb only, the decoder must be at the current frame
+    if (current_ && current_->position != decoder_->position()) {
+        return false;
+    }
+    return decoder_->yuv_planes(planes);
+}
+
+vs::frame_ref_t CachedDecoder::frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!current_ && !decoder_->error()) {
+        cache_current();
+    }
+    if (current_) {
+        return current_->frame;
+    }
+    return decoder_->frame();
+}
+
+vs::frame_ref_t CachedDecoder::partial_frame(const vs::frame_area_t& area) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_) {
+        return current_->frame;
+    }
+    // the partial frames are not cached
+    return decoder_->partial_frame(area);
+}
+
+vs::frame_ref_t CachedDecoder::scaled_frame(uint32_t max_w, uint32_t max_h) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the cache keeps full frames only, the decoder must be at the current frame
+    if (current_ && current_->position != decoder_->position()) {
+        return current_->frame;
+    }
+    return decoder_->scaled_frame(max_w, max_h);
+}
+
+vs::frame_ref_t CachedDecoder::source_frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (current_ && current_->position != decoder_->position()) {
+        return vs::frame_ref_t();
+    }
+    return decoder_->source_frame();
+}
+
+}  // namespace vcutter
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_CACHED_DECODER_H_
+#define SRC_PLAYER_CACHED_DECODER_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <boost/thread.hpp>
+#include "src/vstream/video_stream.h"
+#include "src/player/frame_cache.h"
+
+namespace vcutter {
+
+/*
+ * Decoder that keeps the decoded frames in a FrameCache.
+ * Revisiting a cached frame does not decode it again.
+ * A decoded frame is converted and cached only when its rgb buffer is requested.
+ * The cache shares the frames of the decoder instead of copying them.
+ */
+class CachedDecoder: public vs::Decoder {
+    CachedDecoder(const CachedDecoder&) = delete;
+    CachedDecoder& operator=(const CachedDecoder&) = delete;
+ public:
+    CachedDecoder(std::shared_ptr<vs::Decoder> decoder, uint64_t max_cache_bytes);
+    virtual ~CachedDecoder() {}
+    vs::source_type source() override;
+    uint32_t w() override;
+    uint32_t h() override;
+    const char* error() override;
+    unsigned char *buffer() override;
+    uint32_t buffer_size() override;
+    uint32_t position() override;
+    uint32_t count() override;
+    double fps() override;
+    double duration() override;
+    double time() override;
+    int64_t pts() override;
+    int ratio_den() override;
+    int ratio_num() override;
+    int time_den() override;
+    int time_num() override;
+    bool key_frame() override;
+    vs::decoder_thread_type thread_type() override;
+    int thread_count() override;
+    void next() override;
+    void prior() override;
+    void seek_frame(int64_t frame) override;
+    void seek_time(int64_t ms_time) override;
+    void seek_keyframe(int64_t frame) override;
+    void interrupt_seek() override;
+    uint32_t seek_generation() override;
+    void claim_seek_generation(uint32_t generation) override;
+    void skip_non_reference(bool skip) override;
+    void convert_threads(int count) override;
+    bool save_keyframe_index(const char *path) override;
+    bool yuv_planes(vs::yuv_planes_t *planes) override;
+    vs::frame_ref_t frame() override;
+    vs::frame_ref_t partial_frame(const vs::frame_area_t& area) override;
+    vs::frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) override;
+    vs::frame_ref_t source_frame() override;
+    FrameCache *cache();
+    // decodes frame into the cache, the current frame does not change (the decoder moves away from it).
+    // return false when there was nothing to decode
+    bool prefetch(uint32_t frame);
+    // forgets the current frame after the decoder was moved without the cache
+    void follow_source();
+ private:
+    bool use_cached(uint32_t frame);
+    void cache_current();
+    cached_frame_t cache_decoded();
+    void decoded();
+
+ private:
+    std::shared_ptr<vs::Decoder> decoder_;
+    FrameCache cache_;
+    boost::recursive_mutex mtx_;
+    cached_frame_t current_;  // NULL while the decoded frame is not cached
+    cached_frame_t previous_;  // keeps the buffer alive for readers that got it before a frame change
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_CACHED_DECODER_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <set>
+#include <vector>
+#include "src/player/command_queue.h"
+
+namespace vcutter {
+
+CommandQueue::CommandQueue() {
+    tail_ = new node_t();
+    tail_->next = NULL;
+    tail_->coalesce_key = 0;
+    head_ = tail_;
+    sleeping_ = false;
+}
+
+CommandQueue::~CommandQueue() {
+    while (tail_) {
+        node_t *next = tail_->next;
+        delete tail_;
+        tail_ = next;
+    }
+}
+
+void CommandQueue::push(command_t command, uint32_t coalesce_key) {
+    node_t *node = new node_t();
+    node->next = NULL;
+    node->command = command;
+    node->coalesce_key = coalesce_key;
+
+    node_t *prior = head_.exchange(node, std::memory_order_acq_rel);
+    // the consumer sees the node once it's linked. sequentially consistent with the sleeping flag:
+    // either the consumer sees the node before sleeping or this sees it sleeping
+    prior->next.store(node, std::memory_order_seq_cst);
+
+    if (!sleeping_.load(std::memory_order_seq_cst)) {
+        return;
+    }
+
+    // the consumer holds the mutex from setting the flag until it sleeps,
+    // taking it here makes sure the notification is not lost in between
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_wait_);
+    }
+    wait_cond_.notify_one();
+}
+
+CommandQueue::node_t *CommandQueue::pop() {
+    node_t *next = tail_->next.load(std::memory_order_acquire);
+    if (!next) {
+        return NULL;
+    }
+    delete tail_;
+    tail_ = next;
+    return next;
+}
+
+uint32_t CommandQueue::run_pending() {
+    std::vector<std::pair<command_t, uint32_t> > commands;
+    for (node_t *node = pop(); node; node = pop()) {
+        commands.push_back(std::make_pair(std::move(node->command), node->coalesce_key));
+        node->command = command_t();
+    }
+
+    // the last command of each key wins
+    std::set<uint32_t> keys;
+    std::vector<bool> skip(commands.size(), false);
+    for (size_t i = commands.size(); i > 0; --i) {
+        uint32_t key = commands[i - 1].second;
+        if (key && !keys.insert(key).second) {
+            skip[i - 1] = true;
+        }
+    }
+
+    uint32_t count = 0;
+    for (size_t i = 0; i < commands.size(); ++i) {
+        if (!skip[i]) {
+            commands[i].first();
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+bool CommandQueue::pending() {
+    return tail_->next.load(std::memory_order_acquire) != NULL;
+}
+
+void CommandQueue::wait(uint32_t timeout_ms) {
+    boost::unique_lock<boost::mutex> lock(mtx_wait_);
+    sleeping_.store(true, std::memory_order_seq_cst);
+    if (tail_->next.load(std::memory_order_seq_cst) == NULL) {
+        wait_cond_.wait_for(lock, boost::chrono::milliseconds(timeout_ms));
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+}
+
+}  // namespace vcutter
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_COMMAND_QUEUE_H_
+#define SRC_PLAYER_COMMAND_QUEUE_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <functional>
+#include <boost/thread.hpp>
+
+namespace vcutter {
+
+typedef std::function<void()> command_t;
+
+/*
+ * Commands pushed by any thread and run in order by a single consumer thread.
+ * push() never waits: the nodes are linked with atomic exchanges (multiple producers, single consumer),
+ * and it takes the mutex to wake up the consumer only when it sleeps.
+ * Of the pending commands pushed with the same coalesce key only the last one runs (0 = never coalesced),
+ * so a burst of seeks costs a single seek.
+ */
+class CommandQueue {
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+ public:
+    CommandQueue();
+    virtual ~CommandQueue();
+    // any thread
+    void push(command_t command, uint32_t coalesce_key=0);
+    // consumer thread: run the pending commands. return how many ran
+    uint32_t run_pending();
+    // consumer thread: sleep until a command is pushed or the timeout expires
+    void wait(uint32_t timeout_ms);
+    // consumer thread: there are commands to run
+    bool pending();
+
+ private:
+    typedef struct node_t {
+        std::atomic<node_t *> next;
+        command_t command;
+        uint32_t coalesce_key;
+    } node_t;
+
+    node_t *pop();
+
+ private:
+    std::atomic<node_t *> head_;  // the last node pushed
+    node_t *tail_;  // the consumed node before the first pending one
+    std::atomic_bool sleeping_;  // the consumer is in wait()
+    boost::mutex mtx_wait_;
+    boost::condition_variable wait_cond_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_COMMAND_QUEUE_H_
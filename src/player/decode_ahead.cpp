@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/player/decode_ahead.h"
+
+namespace vcutter {
+
+DecodeAhead::DecodeAhead(
+    std::shared_ptr<vs::Decoder> decoder,
+    PlaybackClock *clock,
+    uint32_t depth,
+    bool skip_non_reference,
+    advance_callback_t advance,
+    convert_callback_t convert,
+    ready_callback_t ready
+) : decoder_(decoder), clock_(clock), depth_(depth > 0 ? depth : 1), skip_non_reference_(skip_non_reference),
+    advance_(advance), convert_(convert), ready_(ready) {
+    cancel_ = false;
+    ended_ = false;
+    dropped_ = 0;
+    if (skip_non_reference_) {
+        decoder_->skip_non_reference(true);
+    }
+    thread_.reset(new boost::thread([this] () {
+        run();
+    }));
+}
+
+DecodeAhead::~DecodeAhead() {
+    cancel_ = true;
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+    }
+    space_cond_.notify_all();
+    thread_->join();
+    if (skip_non_reference_) {
+        decoder_->skip_non_reference(false);
+    }
+}
+
+vs::frame_ref_t DecodeAhead::front() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    if (frames_.empty()) {
+        return vs::frame_ref_t();
+    }
+    return frames_.front();
+}
+
+void DecodeAhead::pop() {
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        if (frames_.empty()) {
+            return;
+        }
+        frames_.pop_front();
+    }
+    space_cond_.notify_one();
+}
+
+bool DecodeAhead::finished() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return ended_ && frames_.empty();
+}
+
+uint32_t DecodeAhead::dropped() {
+    return dropped_;
+}
+
+void DecodeAhead::run() {
+    while (!cancel_) {
+        size_t queued = 0;
+        {
+            boost::unique_lock<boost::mutex> lock(mtx_);
+            while (!cancel_ && frames_.size() >= depth_) {
+                space_cond_.wait(lock);
+            }
+            queued = frames_.size();
+        }
+
+        if (cancel_) {
+            break;
+        }
+
+        if (!advance_(decoder_.get())) {
+            ended_ = true;
+            ready_();
+            break;
+        }
+
+        // the conversion is the expensive part, the late frames skip it when another one can be shown
+        if (queued > 0 && clock_->late(decoder_->position())) {
+            ++dropped_;
+            continue;
+        }
+
+        vs::frame_ref_t frame = convert_(decoder_.get());
+        if (!frame) {
+            continue;
+        }
+
+        bool was_empty = false;
+        {
+            boost::lock_guard<boost::mutex> lock(mtx_);
+            was_empty = frames_.empty();
+            frames_.push_back(frame);
+        }
+        if (was_empty) {
+            ready_();
+        }
+    }
+}
+
+}  // namespace vcutter
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_DECODE_AHEAD_H_
+#define SRC_PLAYER_DECODE_AHEAD_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <boost/thread.hpp>
+#include "src/vstream/video_stream.h"
+#include "src/player/playback_clock.h"
+
+namespace vcutter {
+
+// moves the decoder to the next frame to play. return false at the end
+typedef std::function<bool(vs::Decoder *decoder)> advance_callback_t;
+// the current frame as the presenter wants it (converted, resized)
+typedef std::function<vs::frame_ref_t(vs::Decoder *decoder)> convert_callback_t;
+// a frame was queued while the queue was empty, or the end was reached
+typedef std::function<void()> ready_callback_t;
+
+/*
+ * Decodes the frames of the playback on its own thread, up to depth frames ahead of the presenter.
+ * The decoder belongs to it until it's destroyed. The frames the clock tells are late are not converted
+ * while there are others waiting to be shown, and with skip_non_reference the codec does not even decode
+ * the frames nothing depends on (for the high speeds).
+ */
+class DecodeAhead {
+    DecodeAhead(const DecodeAhead&) = delete;
+    DecodeAhead& operator=(const DecodeAhead&) = delete;
+ public:
+    DecodeAhead(
+        std::shared_ptr<vs::Decoder> decoder,
+        PlaybackClock *clock,
+        uint32_t depth,
+        bool skip_non_reference,
+        advance_callback_t advance,
+        convert_callback_t convert,
+        ready_callback_t ready);
+    // stops the thread. the decoder stays on the last frame decoded
+    virtual ~DecodeAhead();
+    // the oldest frame queued (empty when none is ready)
+    vs::frame_ref_t front();
+    void pop();
+    // the end was reached and every frame was taken
+    bool finished();
+    // the frames skipped for being late
+    uint32_t dropped();
+ private:
+    void run();
+ private:
+    std::shared_ptr<vs::Decoder> decoder_;
+    PlaybackClock *clock_;
+    uint32_t depth_;
+    bool skip_non_reference_;
+    advance_callback_t advance_;
+    convert_callback_t convert_;
+    ready_callback_t ready_;
+    std::atomic_bool cancel_;
+    std::atomic_bool ended_;
+    std::atomic_uint dropped_;
+    boost::mutex mtx_;
+    boost::condition_variable space_cond_;
+    std::deque<vs::frame_ref_t> frames_;
+    std::unique_ptr<boost::thread> thread_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_DECODE_AHEAD_H_
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include "src/player/frame_cache.h"
+
+namespace vcutter {
+
+CachedFrame::CachedFrame(const uint8_t *buffer, uint32_t buffer_size) : size(buffer_size) {
+    copy_.reset(new CharBuffer(buffer_size));
+    memcpy(copy_->data, buffer, buffer_size);
+}
+
+CachedFrame::CachedFrame(vs::frame_ref_t decoded) : frame(decoded) {
+    position = decoded->position();
+    pts = decoded->pts();
+    time = decoded->time();
+    key_frame = decoded->key_frame();
+    size = decoded->stride() * decoded->h();
+}
+
+const uint8_t *CachedFrame::data() const {
+    if (frame) {
+        return frame->data();
+    }
+    return copy_->data;
+}
+
+FrameCache::FrameCache(uint64_t max_bytes) : hits_(0), misses_(0) {
+    max_bytes_ = max_bytes;
+    bytes_ = 0;
+}
+
+cached_frame_t FrameCache::get(uint32_t position) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+
+    auto it = positions_.find(position);
+    if (it == positions_.end()) {
+        ++misses_;
+        return cached_frame_t();
+    }
+
+    ++hits_;
+    frames_.splice(frames_.begin(), frames_, it->second);
+
+    return *it->second;
+}
+
+bool FrameCache::contains(uint32_t position) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return positions_.find(position) != positions_.end();
+}
+
+cached_frame_t FrameCache::put(uint32_t position, int64_t pts, double time, bool key_frame, const uint8_t *buffer, uint32_t size) {
+    cached_frame_t frame(new CachedFrame(buffer, size));
+    frame->position = position;
+    frame->pts = pts;
+    frame->time = time;
+    frame->key_frame = key_frame;
+    return insert(frame);
+}
+
+cached_frame_t FrameCache::put(vs::frame_ref_t frame) {
+    return insert(cached_frame_t(new CachedFrame(frame)));
+}
+
+cached_frame_t FrameCache::insert(cached_frame_t frame) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+
+    auto it = positions_.find(frame->position);
+    if (it != positions_.end()) {
+        bytes_ -= (*it->second)->size;
+        frames_.erase(it->second);
+    }
+
+    frames_.push_front(frame);
+    positions_[frame->position] = frames_.begin();
+    bytes_ += frame->size;
+
+    evict();
+
+    return frame;
+}
+
+void FrameCache::evict() {
+    // the frame just added is kept even when it alone exceeds the limit
+    while (bytes_ > max_bytes_ && frames_.size() > 1) {
+        cached_frame_t frame = frames_.back();
+        positions_.erase(frame->position);
+        bytes_ -= frame->size;
+        frames_.pop_back();
+    }
+}
+
+void FrameCache::clear() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    frames_.clear();
+    positions_.clear();
+    bytes_ = 0;
+}
+
+uint64_t FrameCache::hits() const {
+    return hits_;
+}
+
+uint64_t FrameCache::misses() const {
+    return misses_;
+}
+
+uint64_t FrameCache::bytes() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return bytes_;
+}
+
+uint64_t FrameCache::max_bytes() const {
+    return max_bytes_;
+}
+
+}  // namespace vcutter
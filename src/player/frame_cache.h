@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_FRAME_CACHE_H_
+#define SRC_PLAYER_FRAME_CACHE_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <boost/thread.hpp>
+#include "src/common/buffers.h"
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+class CachedFrame {
+    CachedFrame(const CachedFrame&) = delete;
+    CachedFrame& operator=(const CachedFrame&) = delete;
+ public:
+    // keeps a copy of buffer
+    CachedFrame(const uint8_t *buffer, uint32_t buffer_size);
+    // shares the frame with the decoder
+    explicit CachedFrame(vs::frame_ref_t frame);
+
+    const uint8_t *data() const;
+
+ public:
+    uint32_t position;
+    int64_t pts;
+    double time;
+    bool key_frame;
+    uint32_t size;
+    vs::frame_ref_t frame;  // empty when the cache keeps a copy
+
+ private:
+    std::unique_ptr<CharBuffer> copy_;
+};
+
+typedef std::shared_ptr<CachedFrame> cached_frame_t;
+
+/*
+ * Least recently used cache of decoded frames keyed by the frame number.
+ * The frames are evicted when the bytes of the cached frames exceed max_bytes.
+ */
+class FrameCache {
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+ public:
+    explicit FrameCache(uint64_t max_bytes);
+    virtual ~FrameCache() {}
+
+    // return an empty pointer when the frame is not cached
+    cached_frame_t get(uint32_t position);
+    bool contains(uint32_t position);
+    cached_frame_t put(uint32_t position, int64_t pts, double time, bool key_frame, const uint8_t *buffer, uint32_t size);
+    // the frame is not copied, the cache holds a reference
+    cached_frame_t put(vs::frame_ref_t frame);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    uint64_t bytes();
+    uint64_t max_bytes() const;
+
+ private:
+    cached_frame_t insert(cached_frame_t frame);
+    void evict();
+
+ private:
+    typedef std::list<cached_frame_t> frame_list_t;
+
+    boost::mutex mtx_;
+    frame_list_t frames_;  // the most recently used first
+    std::unordered_map<uint32_t, frame_list_t::iterator> positions_;
+    uint64_t max_bytes_;
+    uint64_t bytes_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_FRAME_CACHE_H_
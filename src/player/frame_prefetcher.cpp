@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <algorithm>
+#include "src/player/frame_prefetcher.h"
+
+namespace vcutter {
+
+namespace {
+
+// the steps next to the current frame go before the keys
+const uint32_t kNEAR_FRAMES = 4;
+
+}  // namespace
+
+FramePrefetcher::FramePrefetcher(std::shared_ptr<CachedDecoder> decoder, uint32_t ahead, uint32_t behind) {
+    decoder_ = decoder;
+    ahead_ = ahead;
+    behind_ = behind;
+    next_ = 0;
+    position_ = 0;
+    planned_ = false;
+}
+
+void FramePrefetcher::key_frames(const std::vector<uint32_t>& frames) {
+    if (frames == key_frames_) {
+        return;
+    }
+    key_frames_ = frames;
+    planned_ = false;
+}
+
+bool FramePrefetcher::step() {
+    if (decoder_->error()) {
+        return false;
+    }
+
+    uint32_t position = decoder_->position();
+    if (!planned_ || position != position_) {
+        plan(position);
+    }
+
+    while (next_ < plan_.size()) {
+        if (decoder_->prefetch(plan_[next_++])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FramePrefetcher::add(int64_t frame, uint32_t position, uint32_t max_frames) {
+    if (frame < 1 || frame > decoder_->count() || frame == position || plan_.size() >= max_frames) {
+        return;
+    }
+    if (std::find(plan_.begin(), plan_.end(), frame) == plan_.end()) {
+        plan_.push_back(frame);
+    }
+}
+
+void FramePrefetcher::plan(uint32_t position) {
+    plan_.clear();
+    next_ = 0;
+    position_ = position;
+    planned_ = true;
+
+    // the prefetched frames must not evict each other
+    uint64_t frame_bytes = static_cast<uint64_t>(decoder_->w()) * decoder_->h() * 3;
+    uint32_t max_frames = frame_bytes ? decoder_->cache()->max_bytes() / 2 / frame_bytes : 0;
+
+    uint32_t near_ahead = std::min(kNEAR_FRAMES, ahead_);
+    uint32_t near_behind = std::min(kNEAR_FRAMES, behind_);
+
+    for (uint32_t i = 1; i <= near_ahead; ++i) {
+        add(static_cast<int64_t>(position) + i, position, max_frames);
+    }
+    // the frames behind go in ascending order: a single seek, then the decoder steps forward
+    for (uint32_t i = near_behind; i > 0; --i) {
+        add(static_cast<int64_t>(position) - i, position, max_frames);
+    }
+    for (uint32_t frame : key_frames_) {
+        add(frame, position, max_frames);
+        add(static_cast<int64_t>(frame) + 1, position, max_frames);
+    }
+    for (uint32_t i = near_ahead + 1; i <= ahead_; ++i) {
+        add(static_cast<int64_t>(position) + i, position, max_frames);
+    }
+    for (uint32_t i = behind_; i > near_behind; --i) {
+        add(static_cast<int64_t>(position) - i, position, max_frames);
+    }
+}
+
+}  // namespace vcutter
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_FRAME_PREFETCHER_H_
+#define SRC_PLAYER_FRAME_PREFETCHER_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <vector>
+#include "src/player/cached_decoder.h"
+
+namespace vcutter {
+
+/*
+ * Decodes into the cache the frames the editing is likely to visit next: a window around the
+ * current frame (the steps next to it first) and the frames at the given keys.
+ * The player thread runs it while idle, one frame by step, so a command waits a single frame at most.
+ * The plan starts over when the current frame or the keys change, and it takes half the cache at most.
+ */
+class FramePrefetcher {
+    FramePrefetcher(const FramePrefetcher&) = delete;
+    FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+ public:
+    FramePrefetcher(std::shared_ptr<CachedDecoder> decoder, uint32_t ahead, uint32_t behind);
+    virtual ~FramePrefetcher() {}
+    // the frames of the keys next to the current one
+    void key_frames(const std::vector<uint32_t>& frames);
+    // decodes the next frame missing from the cache. return false when there is nothing left to do
+    bool step();
+ private:
+    void plan(uint32_t position);
+    void add(int64_t frame, uint32_t position, uint32_t max_frames);
+ private:
+    std::shared_ptr<CachedDecoder> decoder_;
+    uint32_t ahead_;
+    uint32_t behind_;
+    std::vector<uint32_t> key_frames_;
+    std::vector<uint32_t> plan_;  // the frames to decode in order
+    size_t next_;
+    uint32_t position_;  // the current frame when the plan was made
+    bool planned_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_FRAME_PREFETCHER_H_
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <boost/chrono.hpp>
+#include "src/player/playback_clock.h"
+
+namespace vcutter {
+
+PlaybackClock::PlaybackClock() {
+    running_ = false;
+    start_us_ = 0;
+    start_frame_ = 0;
+    rate_ = 1;
+    speed_ = 1;
+}
+
+PlaybackClock::~PlaybackClock() {
+}
+
+void PlaybackClock::start(uint32_t frame, double fps, double speed) {
+    if (fps < 1) {
+        fps = 1;
+    }
+    start_us_ = now_us();
+    start_frame_ = frame;
+    rate_ = fps * speed;
+    speed_ = speed;
+    running_ = true;
+}
+
+void PlaybackClock::stop() {
+    running_ = false;
+}
+
+bool PlaybackClock::running() {
+    return running_;
+}
+
+double PlaybackClock::speed() {
+    return speed_;
+}
+
+double PlaybackClock::wait_time(uint32_t frame) {
+    if (!running_) {
+        return 0;
+    }
+    double due = (static_cast<double>(frame) - start_frame_) / rate_;
+    double elapsed = (now_us() - start_us_) / 1000000.0;
+    return due - elapsed;
+}
+
+bool PlaybackClock::late(uint32_t frame) {
+    return wait_time(frame) < -1.0 / rate_;
+}
+
+int64_t PlaybackClock::now_us() {
+    return boost::chrono::duration_cast<boost::chrono::microseconds>(
+        boost::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace vcutter
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_PLAYBACK_CLOCK_H_
+#define SRC_PLAYER_PLAYBACK_CLOCK_H_
+
+#include <inttypes.h>
+#include <atomic>
+
+namespace vcutter {
+
+/*
+ * Tells when the frames of the playback are due on the wall clock.
+ * The frame it starts at is due at once, the next ones follow at fps * speed frames by second,
+ * so the decoding time does not add up and the playback holds the speed.
+ * Started and stopped by the presenting thread, read by any thread.
+ */
+class PlaybackClock {
+    PlaybackClock(const PlaybackClock&) = delete;
+    PlaybackClock& operator=(const PlaybackClock&) = delete;
+ public:
+    PlaybackClock();
+    virtual ~PlaybackClock();
+    void start(uint32_t frame, double fps, double speed);
+    void stop();
+    bool running();
+    double speed();
+    // seconds until frame is due, negative when it is past due (0 while stopped)
+    double wait_time(uint32_t frame);
+    // the frame was due more than a frame interval ago (false while stopped)
+    bool late(uint32_t frame);
+ protected:
+    // microseconds of a steady clock
+    virtual int64_t now_us();
+ private:
+    std::atomic_bool running_;
+    std::atomic<int64_t> start_us_;
+    std::atomic<uint32_t> start_frame_;
+    std::atomic<double> rate_;  // frames by second
+    std::atomic<double> speed_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_PLAYBACK_CLOCK_H_
@@ -1,34 +1,68 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
-#include <Fl/Fl.H>
-
-
+#include <math.h>
+#include <algorithm>
+#include "src/common/event_loop.h"
 #include "src/player/player.h"
 
 namespace vcutter {
 
-const float kON_FRAME_TIMEOUT_INTERVAL = 0.0333;
+const uint64_t kFRAME_CACHE_BYTES = 268435456;
+// the videos larger than full hd are edited on a proxy of this size
+const uint32_t kPROXY_MIN_W = 1920;
+const uint32_t kPROXY_MIN_H = 1080;
+const uint32_t kPROXY_MAX_W = 960;
+const uint32_t kPROXY_MAX_H = 540;
+// the idle player thread wakes up on the commands, this is just for the proxy builder
+const uint32_t kIDLE_WAIT_MS = 50;
+// the pending seeks are coalesced, only the last one runs
+const uint32_t kSEEK_COMMAND = 1;
+const uint32_t kPRESENT_COMMAND = 2;
+// the frames decoded ahead of the one on the screen
+const uint32_t kDECODE_AHEAD_FRAMES = 8;
+const float kMIN_SPEED = 0.20;
+// the codec skips the frames nothing depends on from this speed
+const float kSKIP_NON_REFERENCE_SPEED = 2.0;
+// the frames prefetched around the current one while paused
+const uint32_t kPREFETCH_AHEAD = 16;
+const uint32_t kPREFETCH_BEHIND = 8;
 
 Player::Player(const char *path) {
     init(path);
 }
 
-Player::Player(const char *path, frame_callback_t frame_changed_cb) {
+Player::Player(const char *path, frame_callback_t frame_changed_cb, const char *keyframe_index_path) {
     frame_changed_cb_ = frame_changed_cb;
-    init(path);
+    init(path, keyframe_index_path);
     init_frame_changed_notifier();
 }
 
-void Player::init(const char *path) {
-    decoder_ = vs::open_file(path);
-    frame_changed_.store(true);
+void Player::init(const char *path, const char *keyframe_index_path) {
+    video_path_ = path;
+    // the editing converts on every core, the other decoders take one
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.convert_threads = 0;
+    proxy_decoder_.reset(new ProxyDecoder(vs::open_file(path, keyframe_index_path, options)));
+    decoder_.reset(new CachedDecoder(proxy_decoder_, kFRAME_CACHE_BYTES));
+    info_.reset(new PresentedInfo(decoder_));
+    prefetcher_.reset(new FramePrefetcher(decoder_, kPREFETCH_AHEAD, kPREFETCH_BEHIND));
+    prefetching_ = false;
+    frame_changed_.store(false);
     execution_finished_.store(true);
+    display_w_.store(0);
+    display_h_.store(0);
     finished_ = false;
     playing_ = false;
     playing_interval_ = false;
     start_ = 0;
     end_ = 0;
+    reset_stats_ = false;
+    seek_target_ = 0;
+    presented_frames_ = 0;
+    dropped_frames_ = 0;
+    late_frames_ = 0;
+    skipping_non_reference_ = false;
     set_speed(1);
     thread_.reset(new boost::thread([this] () {
         run();
@@ -43,30 +77,163 @@ void Player::set_frame_changed_callback(frame_callback_t frame_changed_cb) {
 
 void Player::clear_frame_changed_callback() {
     if (frame_changed_cb_) {
-        Fl::remove_timeout(&Player::timeout_handler, this);
+        remove_check(&Player::check_handler, this);
         frame_changed_cb_ = frame_callback_t();
     }
 }
 
+bool Player::save_keyframe_index(const char *path) {
+    return decoder_->save_keyframe_index(path);
+}
+
+FrameCache *Player::frame_cache() {
+    return decoder_->cache();
+}
+
+playback_stats_t Player::playback_stats() {
+    playback_stats_t stats;
+    stats.presented = presented_frames_;
+    stats.dropped = dropped_frames_;
+    return stats;
+}
+
+void Player::prefetch_key_frames(const std::vector<uint32_t>& frames) {
+    boost::lock_guard<boost::mutex> lock(mtx_prefetch_);
+    prefetch_keys_ = frames;
+}
+
+bool Player::prefetch() {
+    // a frame at a time, the commands go first. the proxy makes the steps cheap already
+    if (commands_.pending() || has_proxy()) {
+        return false;
+    }
+
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_prefetch_);
+        prefetcher_->key_frames(prefetch_keys_);
+    }
+
+    prefetching_ = true;
+    bool decoded = prefetcher_->step();
+    prefetching_ = false;
+
+    return decoded;
+}
+
+void Player::yield_prefetch() {
+    // the seek of a prefetch may decode a whole group of pictures
+    if (prefetching_) {
+        decoder_->interrupt_seek();
+    }
+}
+
+void Player::convert_threads(int count) {
+    push_command([this, count] () {
+        // the decode ahead thread may be converting, the playback starts it again
+        stop_decode_ahead(true);
+        decoder_->convert_threads(count);
+    });
+}
+
+void Player::display_size(uint32_t w, uint32_t h) {
+    uint32_t former_w = display_w_.exchange(w);
+    uint32_t former_h = display_h_.exchange(h);
+    if (former_w == w && former_h == h) {
+        return;
+    }
+    // the current frame again in the new size
+    push_command([this] () {
+        // the playback converts the next frames to the new size
+        if (playing_ || playing_interval_) {
+            return;
+        }
+        stop_decode_ahead(true);
+        present();
+    }, kPRESENT_COMMAND);
+}
+
+vs::frame_ref_t Player::display_frame() {
+    presented_.update();
+    return presented_.front();
+}
+
+vs::frame_ref_t Player::display_conversion(vs::Decoder *decoder) {
+    // the conversion and the resize run off the ui thread, the viewer just draws the result
+    uint32_t w = display_w_.load();
+    uint32_t h = display_h_.load();
+    return w && h ? decoder->scaled_frame(w, h) : decoder->frame();
+}
+
+void Player::present() {
+    present(display_conversion(decoder_.get()));
+}
+
+void Player::present(vs::frame_ref_t frame) {
+    info_->present(frame);
+    presented_.back() = frame;
+    presented_.publish();
+
+    frame_changed_.store(true);
+    awake();
+}
+
+void Player::use_proxy(const char *proxy_path) {
+    boost::lock_guard<boost::mutex> lock(mtx_proxy_);
+    proxy_path_ = proxy_path;
+}
+
+bool Player::has_proxy() {
+    return proxy_decoder_->has_proxy();
+}
+
+void Player::attach_proxy() {
+    if (proxy_builder_) {
+        if (!proxy_builder_->finished()) {
+            return;
+        }
+        if (!proxy_builder_->error()) {
+            proxy_decoder_->attach(vs::open_file(
+                proxy_builder_->proxy_path().c_str(), proxy_builder_->keyframe_index_path().c_str()));
+        }
+        proxy_builder_.reset();
+        return;
+    }
+
+    std::string proxy_path;
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_proxy_);
+        proxy_path.swap(proxy_path_);
+    }
+
+    if (proxy_path.empty() || decoder_->error() || has_proxy()) {
+        return;
+    }
+
+    if (decoder_->w() > kPROXY_MIN_W || decoder_->h() > kPROXY_MIN_H) {
+        proxy_builder_.reset(new ProxyBuilder(video_path_.c_str(), proxy_path.c_str(), kPROXY_MAX_W, kPROXY_MAX_H));
+    }
+}
+
 void Player::init_frame_changed_notifier() {
     if (frame_changed_cb_) {
-        Fl::add_timeout(kON_FRAME_TIMEOUT_INTERVAL, &Player::timeout_handler, this);
+        add_check(&Player::check_handler, this);
     }
 }
 
-void Player::timeout_handler(void* ud) {
+void Player::check_handler(void* ud) {
+    // present() wakes up the loop
     static_cast<Player *>(ud)->notify_frame_changed();
-    Fl::repeat_timeout(kON_FRAME_TIMEOUT_INTERVAL, &Player::timeout_handler, ud);
 }
 
 Player::~Player() {
     clear_frame_changed_callback();
     finished_ = true;
+    commands_.push([] () {});
     thread_->join();
 }
 
 vs::StreamInfo *Player::info() {
-    return decoder_.get();
+    return info_.get();
 }
 
 void Player::set_speed(float speed) {
@@ -78,8 +245,12 @@ float Player::get_speed() {
 }
 
 void Player::play() {
-    stop_playing();
+    yield_prefetch();
+    seek_target_ = 0;
+    playing_interval_ = false;
+    reset_stats_ = true;
     playing_ = true;
+    commands_.push([] () {});
 }
 
 bool Player::frame_changed(bool clear_flag) {
@@ -106,21 +277,36 @@ void Player::play(unsigned int start, unsigned int end) {
     if (start >= end) {
         return;
     }
+    // the player thread reads the interval after the flag
+    yield_prefetch();
+    seek_target_ = 0;
     start_ = start;
     end_ = end;
+    reset_stats_ = true;
     playing_interval_ = true;
+    commands_.push([] () {});
 }
 
 void Player::stop_playing() {
-    if (playing_ || playing_interval_) {
-        playing_ = false;
-        playing_interval_ = false;
-        noop();
-    }
+    // a frame being decoded still arrives
+    playing_ = false;
+    playing_interval_ = false;
 }
 
-void Player::noop() {
-    call_async([](){});
+void Player::push_command(async_callback_t callback, uint32_t coalesce_key) {
+    uint32_t generation = decoder_->seek_generation();
+    commands_.push([this, callback, generation] () {
+        decoder_->claim_seek_generation(generation);
+        callback();
+    }, coalesce_key);
+}
+
+void Player::push_seek(async_callback_t callback) {
+    // a seek still running is for a position already left (the exports run alone)
+    if (execution_finished_.load()) {
+        decoder_->interrupt_seek();
+    }
+    push_command(callback, kSEEK_COMMAND);
 }
 
 void Player::notify_frame_changed() {
@@ -131,78 +317,80 @@ void Player::notify_frame_changed() {
 
 void Player::stop() {
     stop_playing();
-    call_async([this] () {
+    seek_target_ = 0;
+    push_seek([this] () {
+        stop_decode_ahead(false);
         decoder_->seek_frame(0);
-        frame_changed_.store(true);
+        present();
     });
-    notify_frame_changed();
 }
 
 void Player::next() {
     stop_playing();
-    call_async([this] () {
+    seek_target_ = 0;
+    yield_prefetch();
+    push_command([this] () {
+        stop_decode_ahead(true);
         decoder_->next();
-        frame_changed_.store(true);
+        present();
     });
-    notify_frame_changed();
 }
 
 void Player::prior() {
     stop_playing();
-    call_async([this] () {
+    seek_target_ = 0;
+    yield_prefetch();
+    push_command([this] () {
+        stop_decode_ahead(true);
         decoder_->prior();
-        frame_changed_.store(true);
+        present();
     });
-    notify_frame_changed();
 }
 
 void Player::seek_frame(int64_t frame) {
-    call_async([this, frame] () {
+    seek_target_ = frame;
+    push_seek([this, frame] () {
+        stop_decode_ahead(false);
         decoder_->seek_frame(frame);
-        frame_changed_.store(true);
-    });
-    notify_frame_changed();
-}
-
-void Player::seek_time(int64_t ms_time) {
-    call_async([this, ms_time] () {
-        decoder_->seek_time(ms_time);
-        frame_changed_.store(true);
+        present();
+        // the frame on the screen is the target now, unless another seek replaced it
+        int64_t target = frame;
+        seek_target_.compare_exchange_strong(target, 0);
     });
-    notify_frame_changed();
 }
 
-void Player::replace_callback(async_callback_t callback) {
-    while (!mtx_run_.try_lock()) {
-        Fl::wait(0.1);
+bool Player::seek_relative(int64_t frames) {
+    int64_t target = seek_target_.load();
+    if (target == 0) {
+        target = info()->position();
     }
-    boost::lock_guard<boost::mutex> lock_guard(mtx_run_, boost::adopt_lock_t());
-    callback_ = callback;
-}
-
-void Player::wait_callback() {
-    while (true) {
-        {
-            boost::lock_guard<boost::mutex> lock_guard(mtx_run_);
-            if (!callback_) {
-                break;
-            }
-        }
-        Fl::wait(0.1);
+    target += frames;
+    if (target < 1 || target >= info()->count()) {
+        return false;
     }
+    seek_frame(target);
+    return true;
 }
 
-void Player::call_async(async_callback_t callback) {
-   replace_callback(callback);
-   wait_callback();
+void Player::seek_time(int64_t ms_time) {
+    seek_target_ = 0;
+    push_seek([this, ms_time] () {
+        stop_decode_ahead(false);
+        decoder_->seek_time(ms_time);
+        present();
+    });
 }
 
-void Player::run_callback() {
-    boost::lock_guard<boost::mutex> lock_guard(mtx_run_);
-    if (callback_) {
-        callback_();
-        callback_ = async_callback_t();
+void Player::scrub_frame(int64_t frame) {
+    if (frame < 1) {
+        frame = 1;
     }
+    seek_target_ = 0;
+    push_seek([this, frame] () {
+        stop_decode_ahead(false);
+        decoder_->seek_keyframe(frame);
+        present();
+    });
 }
 
 void Player::change_speed(bool increment) {
@@ -221,48 +409,125 @@ void Player::change_speed(bool increment) {
 
 bool Player::grab_frame() {
     if (!playing_ && !playing_interval_) {
+        stop_decode_ahead(true);
         return false;
     }
 
-    if (playing_interval_) {
-        if (info()->position() >= end_ ||
-            info()->position() < start_
-        ) {
-            decoder_->seek_frame(start_);
-        } else {
-            decoder_->next();
-        }
+    if (reset_stats_.exchange(false)) {
+        late_frames_ = 0;
+        presented_frames_ = 0;
+        dropped_frames_ = 0;
+    }
 
-        frame_changed_.store(true);
-    } else {
-        frame_changed_.store(true);
-        decoder_->next();
+    double speed = std::max(get_speed(), kMIN_SPEED);
+    bool skip_non_reference = speed >= kSKIP_NON_REFERENCE_SPEED;
+    if (decode_ahead_ && skipping_non_reference_ != skip_non_reference) {
+        // the codec changes with nothing decoded ahead
+        stop_decode_ahead(true);
+    }
+    if (!decode_ahead_) {
+        start_decode_ahead(skip_non_reference);
+    }
 
-        if (info()->position() >= info()->count()) {
+    vs::frame_ref_t frame = decode_ahead_->front();
+    if (!frame) {
+        if (decode_ahead_->finished()) {
             playing_ = false;
+            stop_decode_ahead(true);
+            return false;
         }
+        // the decode ahead wakes up the thread on the next frame
+        commands_.wait(kIDLE_WAIT_MS);
+        return true;
+    }
+
+    uint32_t position = frame->position();
+    if (!clock_.running() || position < info_->position()) {
+        // the playback (or the interval again) starts at this frame
+        clock_.start(position, decoder_->fps(), speed);
+    } else if (clock_.speed() != speed) {
+        clock_.start(info_->position(), decoder_->fps(), speed);
+    }
+
+    double wait_time = clock_.wait_time(position);
+    if (wait_time > 0) {
+        // the commands do not wait for the frame
+        commands_.wait(static_cast<uint32_t>(ceil(wait_time * 1000)));
+        return true;
+    }
+
+    decode_ahead_->pop();
+    // a late frame is shown only when there is no newer one
+    if (clock_.late(position) && decode_ahead_->front()) {
+        ++late_frames_;
+    } else {
+        present(frame);
+        ++presented_frames_;
+    }
+    dropped_frames_ = late_frames_ + decode_ahead_->dropped();
+
+    return true;
+}
+
+void Player::start_decode_ahead(bool skip_non_reference) {
+    clock_.stop();
+    skipping_non_reference_ = skip_non_reference;
+    decode_ahead_.reset(new DecodeAhead(
+        decoder_,
+        &clock_,
+        kDECODE_AHEAD_FRAMES,
+        skip_non_reference,
+        [this] (vs::Decoder *decoder) {
+            return advance(decoder);
+        },
+        [this] (vs::Decoder *decoder) {
+            return display_conversion(decoder);
+        },
+        [this] () {
+            commands_.push([] () {});
+        }));
+}
+
+void Player::stop_decode_ahead(bool restore_position) {
+    if (!decode_ahead_) {
+        return;
     }
 
-    auto speed = get_speed();
+    late_frames_ += decode_ahead_->dropped();
+    dropped_frames_ = late_frames_;
+    decode_ahead_.reset();
+    clock_.stop();
 
-    if (speed <= 0.20) {
-        speed = 0.20;
+    // the decoder is past the frame on the screen
+    uint32_t position = info_->position();
+    if (restore_position && position > 0 && decoder_->position() != position) {
+        decoder_->seek_frame(position);
+    }
+}
+
+bool Player::advance(vs::Decoder *decoder) {
+    if (decoder->error()) {
+        return false;
     }
 
-    if (speed <= 10) {
-        double fps = info()->fps();
+    uint32_t position = decoder->position();
 
-        if (fps < 1) {
-            fps = 1;
-        } else if (fps > 60) {
-            fps = 60;
+    if (playing_interval_) {
+        if (position >= end_ || position < start_) {
+            decoder->seek_frame(start_);
+        } else {
+            decoder->next();
         }
+        return true;
+    }
 
-        boost::this_thread::sleep(
-            boost::posix_time::milliseconds(1000.0 / (fps * speed))
-        );
+    if (position >= decoder->count()) {
+        return false;
     }
-    return true;
+
+    decoder->next();
+
+    return decoder->position() != position;
 }
 
 void Player::pause() {
@@ -271,20 +536,30 @@ void Player::pause() {
 
 void Player::execute(context_callback_t callback) {
     execution_finished_.store(false);
-    replace_callback([this, callback] () {
-        callback(decoder_.get());
+    yield_prefetch();
+    push_command([this, callback] () {
+        stop_decode_ahead(true);
+        // the export reads each frame once, through the cache it would only evict the frames being edited
+        callback(proxy_decoder_.get());
+        decoder_->follow_source();
         execution_finished_.store(true);
     });
 }
 
 void Player::run() {
+    present();
     while (!finished_) {
-        run_callback();
-        if (grab_frame()) {
+        commands_.run_pending();
+        // the seeks between the commands are for the last request
+        decoder_->claim_seek_generation(decoder_->seek_generation());
+        attach_proxy();
+        if (grab_frame() || prefetch()) {
             continue;
         }
-        boost::this_thread::sleep_for(boost::chrono::milliseconds(5));
+        commands_.wait(kIDLE_WAIT_MS);
     }
+    // its thread uses the members
+    decode_ahead_.reset();
 }
 
 
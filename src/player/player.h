@@ -6,8 +6,19 @@
 
 #include <atomic>
 #include <functional>
+#include <string>
+#include <vector>
 #include <boost/thread.hpp>
+#include "src/common/triple_buffer.h"
 #include "src/vstream/video_stream.h"
+#include "src/player/cached_decoder.h"
+#include "src/player/command_queue.h"
+#include "src/player/decode_ahead.h"
+#include "src/player/frame_prefetcher.h"
+#include "src/player/playback_clock.h"
+#include "src/player/presented_info.h"
+#include "src/player/proxy_builder.h"
+#include "src/player/proxy_decoder.h"
 
 namespace vcutter {
 
@@ -19,10 +30,22 @@ typedef std::function<void(vs::Decoder *decoder)> context_callback_t;
 
 typedef std::function<void(Player *player)> frame_callback_t;
 
+typedef struct {
+    uint32_t presented;  // the frames shown since the playback started
+    uint32_t dropped;    // the frames skipped for being late
+} playback_stats_t;
+
+/*
+ * Decodes on its own thread. The actions are queued to that thread and return at once,
+ * the frame changed callback tells when their frames are ready.
+ * The playback decodes a few frames ahead on another thread and shows them when the clock
+ * says they are due, the late ones are dropped. info() describes the frame on the screen.
+ * While paused and idle it decodes the frames around the current one into the cache.
+ */
 class Player {
  public:
     Player(const char *path);
-    Player(const char *path, frame_callback_t frame_changed_cb);
+    Player(const char *path, frame_callback_t frame_changed_cb, const char *keyframe_index_path=NULL);
     virtual ~Player();
     vs::StreamInfo *info();
     void play();
@@ -35,40 +58,96 @@ class Player {
     void prior();
     void change_speed(bool increment);
     void seek_frame(int64_t frame);
+    // ui thread: seek frames away from the target of the pending seek_frame (the current frame when there is none),
+    // so the repeated presses add up. return false when the target is out of the video
+    bool seek_relative(int64_t frames);
     void seek_time(int64_t ms_time);
+    // the player shows the key frame before frame (for dragging the seek bar).
+    // seek_frame() goes to the exact frame at the end
+    void scrub_frame(int64_t frame);
     bool is_playing();
     bool is_playing_interval();
     bool execution_finished();
     void execute(context_callback_t callback);
     void set_frame_changed_callback(frame_callback_t frame_changed_cb);
     void clear_frame_changed_callback();
+    bool save_keyframe_index(const char *path);
+    // any thread
+    playback_stats_t playback_stats();
+    // any thread: the frames of the keys next to the current one, they are prefetched while paused
+    void prefetch_key_frames(const std::vector<uint32_t>& frames);
+    FrameCache *frame_cache();
+    // any thread: the bands of the rgb conversion (0 = one by core, the default of the player)
+    void convert_threads(int count);
+    // the frames handed to the ui are resized to fit in w x h (0 x 0 = the full frame)
+    void display_size(uint32_t w, uint32_t h);
+    // ui thread: the last frame the player thread presented (converted and fit in the display size).
+    // the full frames for export are read through execute()
+    vs::frame_ref_t display_frame();
+    // edit a reduced copy of the video (built in background at proxy_path when the video is large)
+    void use_proxy(const char *proxy_path);
+    // true once the proxy is built and attached. the scaled display frames come from it
+    bool has_proxy();
   private:
-    void init(const char *path);
+    void init(const char *path, const char *keyframe_index_path=NULL);
     void init_frame_changed_notifier();
-    static void timeout_handler(void* ud);
+    static void check_handler(void* ud);
     bool frame_changed(bool clear_flag);
-    void replace_callback(async_callback_t callback);
-    void wait_callback();
-    void call_async(async_callback_t callback);
+    // the command seeks for the generation current when it's pushed: the later seeks interrupt it
+    void push_command(async_callback_t callback, uint32_t coalesce_key=0);
+    // the pending seeks are replaced by the new one
+    void push_seek(async_callback_t callback);
     void run();
-    void noop();
     void stop_playing();
-    void run_callback();
     bool grab_frame();
+    void start_decode_ahead(bool skip_non_reference);
+    // restore_position: the decoder goes back to the frame on the screen
+    void stop_decode_ahead(bool restore_position);
+    bool advance(vs::Decoder *decoder);
+    // decodes a frame ahead of the commands. return false when there is nothing to do
+    bool prefetch();
+    // the command being pushed goes before the prefetch in progress
+    void yield_prefetch();
     void notify_frame_changed();
+    // the current frame converted for the ui
+    vs::frame_ref_t display_conversion(vs::Decoder *decoder);
+    // hand the current frame to the ui
+    void present();
+    void present(vs::frame_ref_t frame);
+    void attach_proxy();
   private:
-    bool finished_;
-    bool playing_;
-    bool playing_interval_;
+    std::atomic_bool finished_;
+    std::atomic_bool playing_;
+    std::atomic_bool playing_interval_;
     std::atomic_int speed_;
     std::atomic_bool frame_changed_;
     std::atomic_bool execution_finished_;
-    unsigned int start_;
-    unsigned int end_;
-    std::shared_ptr<vs::Decoder> decoder_;
+    std::atomic<uint32_t> display_w_;
+    std::atomic<uint32_t> display_h_;
+    std::atomic_uint start_;
+    std::atomic_uint end_;
+    std::atomic_bool reset_stats_;
+    std::atomic<int64_t> seek_target_;  // the frame of the pending seek_frame (0 = none)
+    std::atomic_uint presented_frames_;
+    std::atomic_uint dropped_frames_;
+    uint32_t late_frames_;  // dropped by the player thread and by the former decode aheads
+    std::shared_ptr<CachedDecoder> decoder_;
+    std::unique_ptr<PresentedInfo> info_;
+    PlaybackClock clock_;
+    std::unique_ptr<DecodeAhead> decode_ahead_;  // accessed by the player thread only
+    bool skipping_non_reference_;
+    std::unique_ptr<FramePrefetcher> prefetcher_;  // accessed by the player thread only
+    std::atomic_bool prefetching_;
+    boost::mutex mtx_prefetch_;
+    std::vector<uint32_t> prefetch_keys_;  // protected by mtx_prefetch_
+    std::shared_ptr<ProxyDecoder> proxy_decoder_;
+    std::unique_ptr<ProxyBuilder> proxy_builder_;  // accessed by the player thread only
+    boost::mutex mtx_proxy_;
+    std::string proxy_path_;  // the proxy to build (protected by mtx_proxy_)
+    std::string video_path_;
     std::shared_ptr<boost::thread> thread_;
-    boost::mutex mtx_run_;
-    async_callback_t callback_;
+    CommandQueue commands_;
+    TripleBuffer<vs::frame_ref_t> presented_;  // written by the player thread, read by the ui
     frame_callback_t frame_changed_cb_;
 };
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/player/presented_info.h"
+
+namespace vcutter {
+
+PresentedInfo::PresentedInfo(std::shared_ptr<vs::StreamInfo> decoder) : decoder_(decoder) {
+    presented_ = false;
+    position_ = 0;
+    time_ = 0;
+    pts_ = 0;
+    key_frame_ = false;
+}
+
+void PresentedInfo::present(vs::frame_ref_t frame) {
+    if (!frame) {
+        presented_ = false;
+        return;
+    }
+    // the readers may see the fields of two frames for a moment, never a torn value
+    position_ = frame->position();
+    time_ = frame->time();
+    pts_ = frame->pts();
+    key_frame_ = frame->key_frame();
+    presented_ = true;
+}
+
+vs::source_type PresentedInfo::source() {
+    return decoder_->source();
+}
+
+uint32_t PresentedInfo::w() {
+    return decoder_->w();
+}
+
+uint32_t PresentedInfo::h() {
+    return decoder_->h();
+}
+
+const char* PresentedInfo::error() {
+    return decoder_->error();
+}
+
+uint32_t PresentedInfo::position() {
+    if (presented_) {
+        return position_;
+    }
+    return decoder_->position();
+}
+
+uint32_t PresentedInfo::count() {
+    return decoder_->count();
+}
+
+double PresentedInfo::fps() {
+    return decoder_->fps();
+}
+
+double PresentedInfo::duration() {
+    return decoder_->duration();
+}
+
+double PresentedInfo::time() {
+    if (presented_) {
+        return time_;
+    }
+    return decoder_->time();
+}
+
+int64_t PresentedInfo::pts() {
+    if (presented_) {
+        return pts_;
+    }
+    return decoder_->pts();
+}
+
+int PresentedInfo::ratio_den() {
+    return decoder_->ratio_den();
+}
+
+int PresentedInfo::ratio_num() {
+    return decoder_->ratio_num();
+}
+
+int PresentedInfo::time_den() {
+    return decoder_->time_den();
+}
+
+int PresentedInfo::time_num() {
+    return decoder_->time_num();
+}
+
+bool PresentedInfo::key_frame() {
+    if (presented_) {
+        return key_frame_;
+    }
+    return decoder_->key_frame();
+}
+
+vs::decoder_thread_type PresentedInfo::thread_type() {
+    return decoder_->thread_type();
+}
+
+int PresentedInfo::thread_count() {
+    return decoder_->thread_count();
+}
+
+}  // namespace vcutter
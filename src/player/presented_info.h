@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_PRESENTED_INFO_H_
+#define SRC_PLAYER_PRESENTED_INFO_H_
+
+#include <atomic>
+#include <memory>
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+/*
+ * The stream information of the frame on the screen.
+ * The playback decodes ahead, so the decoder is a few frames past the one shown:
+ * the position, the time, the pts and the key frame flag come from the last frame presented,
+ * the rest from the decoder. The pixels shown are in Player::display_frame(), not in the decoder buffer.
+ */
+class PresentedInfo: public vs::StreamInfo {
+    PresentedInfo(const PresentedInfo&) = delete;
+    PresentedInfo& operator=(const PresentedInfo&) = delete;
+ public:
+    explicit PresentedInfo(std::shared_ptr<vs::StreamInfo> decoder);
+    virtual ~PresentedInfo() {}
+    // the player thread: frame is on the screen (empty = follow the decoder)
+    void present(vs::frame_ref_t frame);
+    vs::source_type source() override;
+    uint32_t w() override;
+    uint32_t h() override;
+    const char* error() override;
+    uint32_t position() override;
+    uint32_t count() override;
+    double fps() override;
+    double duration() override;
+    double time() override;
+    int64_t pts() override;
+    int ratio_den() override;
+    int ratio_num() override;
+    int time_den() override;
+    int time_num() override;
+    bool key_frame() override;
+    vs::decoder_thread_type thread_type() override;
+    int thread_count() override;
+ private:
+    std::shared_ptr<vs::StreamInfo> decoder_;
+    std::atomic_bool presented_;
+    std::atomic<uint32_t> position_;
+    std::atomic<double> time_;
+    std::atomic<int64_t> pts_;
+    std::atomic_bool key_frame_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_PRESENTED_INFO_H_
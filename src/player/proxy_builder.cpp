@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <boost/filesystem.hpp>
+#include "src/common/buffers.h"
+#include "src/player/proxy_builder.h"
+
+namespace vcutter {
+
+namespace {
+
+// intra only h264 decodes fast and keeps the proxy small
+const char *kPROXY_FORMAT = "mp4-x264";
+const char *kKEYFRAME_INDEX_EXTENSION = ".keyframes";
+
+void remove_path(const std::string& path) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+}
+
+}  // namespace
+
+ProxyBuilder::ProxyBuilder(const char *source_path, const char *proxy_path, uint32_t max_w, uint32_t max_h) {
+    source_path_ = source_path;
+    proxy_path_ = proxy_path;
+    max_w_ = max_w;
+    max_h_ = max_h;
+    finished_ = false;
+    cancel_ = false;
+    progress_ = 0;
+    thread_.reset(new boost::thread([this] () {
+        run();
+    }));
+}
+
+ProxyBuilder::~ProxyBuilder() {
+    cancel_ = true;
+    thread_->join();
+}
+
+bool ProxyBuilder::finished() {
+    return finished_;
+}
+
+const char *ProxyBuilder::error() {
+    if (!finished_) {
+        return NULL;
+    }
+    if (error_.length()) {
+        return error_.c_str();
+    }
+    return NULL;
+}
+
+float ProxyBuilder::progress() {
+    return progress_;
+}
+
+const std::string& ProxyBuilder::proxy_path() const {
+    return proxy_path_;
+}
+
+std::string ProxyBuilder::keyframe_index_path() const {
+    return proxy_path_ + kKEYFRAME_INDEX_EXTENSION;
+}
+
+bool ProxyBuilder::report_error(const std::string& error) {
+    error_ = error;
+    return false;
+}
+
+void ProxyBuilder::run() {
+    if (!up_to_date()) {
+        build();
+    }
+    progress_ = 1;
+    finished_ = true;
+}
+
+bool ProxyBuilder::up_to_date() {
+    boost::system::error_code ec;
+    std::time_t source_time = boost::filesystem::last_write_time(source_path_, ec);
+    if (ec) {
+        return false;
+    }
+    std::time_t proxy_time = boost::filesystem::last_write_time(proxy_path_, ec);
+    return !ec && proxy_time >= source_time;
+}
+
+bool ProxyBuilder::build() {
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(source_path_.c_str());
+    if (decoder->error()) {
+        return report_error(decoder->error());
+    }
+
+    uint32_t count = decoder->count();
+    if (count < 1) {
+        return report_error("The video has no frames");
+    }
+
+    std::string temp_path = boost::filesystem::unique_path(proxy_path_ + ".%%%%%%.tmp").string();
+    std::shared_ptr<vs::Encoder> encoder;
+    std::unique_ptr<CharBuffer> packed;
+    uint32_t proxy_w = 0;
+    uint32_t proxy_h = 0;
+
+    for (;;) {
+        if (cancel_) {
+            encoder.reset();
+            remove_path(temp_path);
+            return report_error("The proxy was cancelled");
+        }
+
+        vs::frame_ref_t frame = decoder->scaled_frame(max_w_, max_h_);
+        if (!frame) {
+            break;
+        }
+
+        if (!encoder) {
+            // the encoder takes even sizes. the frames are scaled with the same factor, so they keep this size
+            proxy_w = frame->w() & ~1u;
+            proxy_h = frame->h() & ~1u;
+            if (proxy_w < 2 || proxy_h < 2) {
+                return report_error("The video is too small for a proxy");
+            }
+
+            vs::encoder_options_t options = vs::default_encoder_options();
+            options.profile = vs::encoder_profile_draft;
+
+            double fps = decoder->fps();
+            encoder = vs::encoder(
+                kPROXY_FORMAT, temp_path.c_str(), proxy_w, proxy_h, 1000, fps * 1000,
+                vs::Encoder::default_bitrate(kPROXY_FORMAT, proxy_w, proxy_h, fps),
+                NULL, NULL, NULL, 1, options);
+
+            if (encoder->error()) {
+                std::string error = encoder->error();
+                encoder.reset();
+                remove_path(temp_path);
+                return report_error(error);
+            }
+
+            if (proxy_w != frame->w() || proxy_h != frame->h()) {
+                packed.reset(new CharBuffer(proxy_w * proxy_h * 3));
+            }
+        }
+
+        if (frame->w() < proxy_w || frame->h() < proxy_h) {
+            break;
+        }
+
+        const unsigned char *data = frame->data();
+        if (packed) {
+            for (uint32_t y = 0; y < proxy_h; ++y) {
+                memcpy(packed->data + y * proxy_w * 3, frame->data() + y * frame->stride(), proxy_w * 3);
+            }
+            data = packed->data;
+        }
+
+        if (!encoder->frame(data)) {
+            break;
+        }
+
+        uint32_t position = decoder->position();
+        progress_ = position / static_cast<float>(count);
+
+        if (position >= count) {
+            break;
+        }
+
+        decoder->next();
+        if (decoder->position() <= position) {
+            break;
+        }
+    }
+
+    bool failed = !encoder || encoder->error() || !encoder->finish();
+    std::string error = encoder && encoder->error() ? encoder->error() : "Could not transcode the video";
+    encoder.reset();
+
+    if (failed) {
+        remove_path(temp_path);
+        return report_error(error);
+    }
+
+    // the index of a former proxy does not match the new one
+    remove_path(keyframe_index_path());
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temp_path, proxy_path_, ec);
+    if (ec) {
+        remove_path(temp_path);
+        return report_error(std::string("Could not store the proxy: ") + ec.message());
+    }
+
+    return true;
+}
+
+}  // namespace vcutter
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_PROXY_BUILDER_H_
+#define SRC_PLAYER_PROXY_BUILDER_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <boost/thread.hpp>
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+/*
+ * Transcodes a video in background into a reduced copy (a proxy) that fits in max_w x max_h.
+ * Every frame of the proxy is a key frame, so seeking it decodes a single small frame.
+ * The proxy is written to a temporary file renamed to proxy_path at the end, so an interrupted
+ * build is never loaded. A proxy_path newer than the video is reused without transcoding.
+ */
+class ProxyBuilder {
+    ProxyBuilder(const ProxyBuilder&) = delete;
+    ProxyBuilder& operator=(const ProxyBuilder&) = delete;
+ public:
+    ProxyBuilder(const char *source_path, const char *proxy_path, uint32_t max_w, uint32_t max_h);
+    // cancels the build
+    virtual ~ProxyBuilder();
+    bool finished();
+    // NULL when the proxy is ready (valid after finished() returns true)
+    const char *error();
+    // from 0 to 1
+    float progress();
+    const std::string& proxy_path() const;
+    // the keyframe index of the proxy, kept beside it
+    std::string keyframe_index_path() const;
+
+ private:
+    void run();
+    bool up_to_date();
+    bool build();
+    bool report_error(const std::string& error);
+
+ private:
+    std::string source_path_;
+    std::string proxy_path_;
+    std::string error_;
+    uint32_t max_w_;
+    uint32_t max_h_;
+    std::atomic_bool finished_;
+    std::atomic_bool cancel_;
+    std::atomic<float> progress_;
+    std::unique_ptr<boost::thread> thread_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_PROXY_BUILDER_H_
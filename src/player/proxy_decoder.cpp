@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <math.h>
+#include "src/player/proxy_decoder.h"
+
+namespace vcutter {
+
+namespace {
+
+// the frame count comes from the duration, the proxy container may round it differently
+const uint32_t kMAX_MISSING_FRAMES = 2;
+const double kMAX_RATIO_DIFFERENCE = 0.02;
+
+// the pixels of a proxy frame with the pts and the key frame flag of the original
+class ProxyFrame: public vs::Frame {
+ public:
+    ProxyFrame(vs::frame_ref_t frame, int64_t pts, bool key_frame) : frame_(frame), pts_(pts), key_frame_(key_frame) {}
+    uint32_t w() const override { return frame_->w(); }
+    uint32_t h() const override { return frame_->h(); }
+    vs::pixel_format format() const override { return frame_->format(); }
+    const unsigned char *data(int plane) const override { return frame_->data(plane); }
+    int stride(int plane) const override { return frame_->stride(plane); }
+    uint32_t position() const override { return frame_->position(); }
+    int64_t pts() const override { return pts_; }
+    double time() const override { return frame_->time(); }
+    bool key_frame() const override { return key_frame_; }
+ private:
+    vs::frame_ref_t frame_;
+    int64_t pts_;
+    bool key_frame_;
+};
+
+}  // namespace
+
+ProxyDecoder::ProxyDecoder(std::shared_ptr<vs::Decoder> source) {
+    source_ = source;
+    position_ = 0;
+    start_pts_ = 0;
+}
+
+bool ProxyDecoder::attach(std::shared_ptr<vs::Decoder> proxy) {
+    if (source_->error() || proxy->error() || !proxy->w() || !proxy->h() || !source_->h()) {
+        return false;
+    }
+
+    if (proxy->count() + kMAX_MISSING_FRAMES < source_->count() || proxy->count() > source_->count() + kMAX_MISSING_FRAMES) {
+        return false;
+    }
+
+    double source_ratio = source_->w() / static_cast<double>(source_->h());
+    double proxy_ratio = proxy->w() / static_cast<double>(proxy->h());
+    if (fabs(source_ratio - proxy_ratio) > kMAX_RATIO_DIFFERENCE * source_ratio) {
+        return false;
+    }
+
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    position_ = source_->position();
+    proxy_ = proxy;
+    // the original may not start at 0
+    start_pts_ = source_->pts() - time_to_pts(source_->time());
+
+    return true;
+}
+
+bool ProxyDecoder::has_proxy() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return proxy_.get() != NULL;
+}
+
+bool ProxyDecoder::proxy_covers(uint32_t position) {
+    return proxy_ && position > 0 && position <= proxy_->count();
+}
+
+void ProxyDecoder::sync(vs::Decoder *decoder, uint32_t position) {
+    uint32_t current = decoder->position();
+    if (current == position) {
+        return;
+    }
+    if (current + 1 == position) {
+        decoder->next();
+    } else {
+        decoder->seek_frame(position);
+    }
+}
+
+vs::Decoder *ProxyDecoder::synced_source() {
+    if (proxy_) {
+        sync(source_.get(), position_);
+    }
+    return source_.get();
+}
+
+int64_t ProxyDecoder::time_to_pts(double time) {
+    // the time base of the stream is time_den() / time_num() seconds
+    if (!source_->time_den()) {
+        return 0;
+    }
+    return llround(time * source_->time_num() / source_->time_den());
+}
+
+vs::frame_ref_t ProxyDecoder::original_timing(vs::frame_ref_t frame) {
+    if (!frame) {
+        return frame;
+    }
+    // the same rules as pts() and key_frame()
+    bool key_frame = source_->position() == frame->position() && source_->key_frame();
+    return vs::frame_ref_t(new ProxyFrame(frame, start_pts_ + time_to_pts(frame->time()), key_frame));
+}
+
+vs::frame_ref_t ProxyDecoder::proxy_frame(uint32_t position) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_covers(position)) {
+        return vs::frame_ref_t();
+    }
+
+    sync(proxy_.get(), position);
+
+    return original_timing(proxy_->frame());
+}
+
+vs::source_type ProxyDecoder::source() {
+    return source_->source();
+}
+
+uint32_t ProxyDecoder::w() {
+    return source_->w();
+}
+
+uint32_t ProxyDecoder::h() {
+    return source_->h();
+}
+
+const char* ProxyDecoder::error() {
+    return source_->error();
+}
+
+unsigned char *ProxyDecoder::buffer() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return synced_source()->buffer();
+}
+
+uint32_t ProxyDecoder::buffer_size() {
+    return source_->buffer_size();
+}
+
+uint32_t ProxyDecoder::position() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (proxy_) {
+        return position_;
+    }
+    return source_->position();
+}
+
+uint32_t ProxyDecoder::count() {
+    return source_->count();
+}
+
+double ProxyDecoder::fps() {
+    return source_->fps();
+}
+
+double ProxyDecoder::duration() {
+    return source_->duration();
+}
+
+double ProxyDecoder::time() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the proxy has the same timing, reading it there does not decode the original
+    if (proxy_covers(position_) && source_->position() != position_) {
+        sync(proxy_.get(), position_);
+        return proxy_->time();
+    }
+    return synced_source()->time();
+}
+
+int64_t ProxyDecoder::pts() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the proxy has another time base, its time is converted to the one of the original
+    if (proxy_covers(position_) && source_->position() != position_) {
+        sync(proxy_.get(), position_);
+        return start_pts_ + time_to_pts(proxy_->time());
+    }
+    return synced_source()->pts();
+}
+
+int ProxyDecoder::ratio_den() {
+    return source_->ratio_den();
+}
+
+int ProxyDecoder::ratio_num() {
+    return source_->ratio_num();
+}
+
+int ProxyDecoder::time_den() {
+    return source_->time_den();
+}
+
+int ProxyDecoder::time_num() {
+    return source_->time_num();
+}
+
+bool ProxyDecoder::key_frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // every frame of the proxy is a key frame, the original knows only once it decodes the frame
+    if (proxy_ && source_->position() != position_) {
+        return false;
+    }
+    return source_->key_frame();
+}
+
+vs::decoder_thread_type ProxyDecoder::thread_type() {
+    return source_->thread_type();
+}
+
+int ProxyDecoder::thread_count() {
+    return source_->thread_count();
+}
+
+void ProxyDecoder::next() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_) {
+        source_->next();
+        return;
+    }
+    if (position_ < count()) {
+        ++position_;
+    }
+}
+
+void ProxyDecoder::prior() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_) {
+        source_->prior();
+        return;
+    }
+    if (position_ > 1) {
+        --position_;
+    }
+}
+
+void ProxyDecoder::seek_frame(int64_t frame) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_) {
+        source_->seek_frame(frame);
+        return;
+    }
+    if (frame < 1) {
+        frame = 1;
+    } else if (frame > count()) {
+        frame = count();
+    }
+    position_ = frame;
+}
+
+void ProxyDecoder::seek_time(int64_t ms_time) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_) {
+        source_->seek_time(ms_time);
+        return;
+    }
+    proxy_->seek_time(ms_time);
+    position_ = proxy_->position();
+}
+
+void ProxyDecoder::seek_keyframe(int64_t frame) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (!proxy_) {
+        source_->seek_keyframe(frame);
+        return;
+    }
+    // the proxy has only key frames, the exact frame costs the same
+    seek_frame(frame);
+}
+
+void ProxyDecoder::interrupt_seek() {
+    // no lock, the seek holds it. the proxy seeks decode a single frame
+    source_->interrupt_seek();
+}
+
+uint32_t ProxyDecoder::seek_generation() {
+    return source_->seek_generation();
+}
+
+void ProxyDecoder::claim_seek_generation(uint32_t generation) {
+    source_->claim_seek_generation(generation);
+}
+
+void ProxyDecoder::skip_non_reference(bool skip) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the proxy has only key frames
+    source_->skip_non_reference(skip);
+}
+
+void ProxyDecoder::convert_threads(int count) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    // the proxy frames are small
+    source_->convert_threads(count);
+}
+
+bool ProxyDecoder::save_keyframe_index(const char *path) {
+    return source_->save_keyframe_index(path);
+}
+
+bool ProxyDecoder::yuv_planes(vs::yuv_planes_t *planes) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return synced_source()->yuv_planes(planes);
+}
+
+vs::frame_ref_t ProxyDecoder::frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return synced_source()->frame();
+}
+
+vs::frame_ref_t ProxyDecoder::partial_frame(const vs::frame_area_t& area) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return synced_source()->partial_frame(area);
+}
+
+vs::frame_ref_t ProxyDecoder::scaled_frame(uint32_t max_w, uint32_t max_h) {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    if (proxy_covers(position_)) {
+        sync(proxy_.get(), position_);
+        vs::frame_ref_t frame = proxy_->scaled_frame(max_w, max_h);
+        if (frame) {
+            return original_timing(frame);
+        }
+    }
+    return synced_source()->scaled_frame(max_w, max_h);
+}
+
+vs::frame_ref_t ProxyDecoder::source_frame() {
+    boost::lock_guard<boost::recursive_mutex> lock(mtx_);
+    return synced_source()->source_frame();
+}
+
+}  // namespace vcutter
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_PROXY_DECODER_H_
+#define SRC_PLAYER_PROXY_DECODER_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <boost/thread.hpp>
+#include "src/vstream/video_stream.h"
+
+namespace vcutter {
+
+/*
+ * Decoder of a video that may have a reduced copy (a proxy, see ProxyBuilder).
+ * It reports the size and the frame numbers of the original video. Once a proxy is attached
+ * moving around does not decode: the proxy decodes the frames scaled_frame() hands out and
+ * the original decodes only when its pixels are requested (buffer(), frame(), partial_frame(),
+ * source_frame() and yuv_planes()), so the export keeps reading the original.
+ * Meanwhile pts() comes from the time of the proxy and key_frame() is false until the original decodes the frame,
+ * the proxy frames handed out report the same.
+ */
+class ProxyDecoder: public vs::Decoder {
+    ProxyDecoder(const ProxyDecoder&) = delete;
+    ProxyDecoder& operator=(const ProxyDecoder&) = delete;
+ public:
+    explicit ProxyDecoder(std::shared_ptr<vs::Decoder> source);
+    virtual ~ProxyDecoder() {}
+    // return false when the proxy does not match the original video
+    bool attach(std::shared_ptr<vs::Decoder> proxy);
+    bool has_proxy();
+    // the proxy frame at position (empty without a proxy)
+    vs::frame_ref_t proxy_frame(uint32_t position);
+    vs::source_type source() override;
+    uint32_t w() override;
+    uint32_t h() override;
+    const char* error() override;
+    unsigned char *buffer() override;
+    uint32_t buffer_size() override;
+    uint32_t position() override;
+    uint32_t count() override;
+    double fps() override;
+    double duration() override;
+    double time() override;
+    int64_t pts() override;
+    int ratio_den() override;
+    int ratio_num() override;
+    int time_den() override;
+    int time_num() override;
+    bool key_frame() override;
+    vs::decoder_thread_type thread_type() override;
+    int thread_count() override;
+    void next() override;
+    void prior() override;
+    void seek_frame(int64_t frame) override;
+    void seek_time(int64_t ms_time) override;
+    void seek_keyframe(int64_t frame) override;
+    void interrupt_seek() override;
+    uint32_t seek_generation() override;
+    void claim_seek_generation(uint32_t generation) override;
+    void skip_non_reference(bool skip) override;
+    void convert_threads(int count) override;
+    bool save_keyframe_index(const char *path) override;
+    bool yuv_planes(vs::yuv_planes_t *planes) override;
+    vs::frame_ref_t frame() override;
+    vs::frame_ref_t partial_frame(const vs::frame_area_t& area) override;
+    vs::frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) override;
+    vs::frame_ref_t source_frame() override;
+
+ private:
+    // move the decoder to the frame (a single step when it is the next one)
+    void sync(vs::Decoder *decoder, uint32_t position);
+    vs::Decoder *synced_source();
+    bool proxy_covers(uint32_t position);
+    int64_t time_to_pts(double time);
+    // the proxy frame reports the pts and the key frame flag of the original
+    vs::frame_ref_t original_timing(vs::frame_ref_t frame);
+
+ private:
+    std::shared_ptr<vs::Decoder> source_;
+    std::shared_ptr<vs::Decoder> proxy_;
+    boost::recursive_mutex mtx_;
+    uint32_t position_;  // the current frame while a proxy is attached
+    int64_t start_pts_;  // the pts of the original at time 0
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_PROXY_DECODER_H_
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <stdio.h>
+#include <string.h>
+#include <boost/filesystem.hpp>
+#include "src/vstream/video_stream.h"
+#include "src/player/thumbnail_strip.h"
+
+namespace vcutter {
+
+namespace {
+
+const char kSTRIP_MAGIC[4] = {'V', 'C', 'T', 'S'};
+const uint32_t kSTRIP_VERSION = 1;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    int64_t video_size;
+    int64_t video_time;
+    uint32_t frame_count;
+    uint32_t slots;
+    uint32_t thumbnail_w;
+    uint32_t thumbnail_h;
+} strip_header_t;
+
+// position 0 marks an empty slot
+typedef struct {
+    uint32_t position;
+    uint32_t w;
+    uint32_t h;
+} slot_header_t;
+
+std::shared_ptr<FILE> open_strip_file(const char *path, const char *mode) {
+    FILE *fp = fopen(path, mode);
+    if (!fp) {
+        return std::shared_ptr<FILE>();
+    }
+    return std::shared_ptr<FILE>(fp, [] (FILE *fp) {
+        fclose(fp);
+    });
+}
+
+}  // namespace
+
+ThumbnailStrip::ThumbnailStrip(
+    const char *video_path, const char *cache_path, uint32_t slots, uint32_t thumbnail_w, uint32_t thumbnail_h
+) : thumbnails_(slots > 0 ? slots : 1), frame_count_(0), version_(0), finished_(false), canceled_(false) {
+    video_path_ = video_path;
+    cache_path_ = cache_path ? cache_path : "";
+    thumbnail_w_ = thumbnail_w;
+    thumbnail_h_ = thumbnail_h;
+
+    boost::system::error_code ec;
+    video_size_ = boost::filesystem::file_size(video_path_, ec);
+    if (ec) {
+        video_size_ = 0;
+    }
+
+    video_time_ = boost::filesystem::last_write_time(video_path_, ec);
+    if (ec) {
+        video_time_ = 0;
+    }
+}
+
+std::shared_ptr<ThumbnailStrip> ThumbnailStrip::open(
+    const char *video_path, const char *cache_path, uint32_t slots, uint32_t thumbnail_w, uint32_t thumbnail_h
+) {
+    std::shared_ptr<ThumbnailStrip> strip(new ThumbnailStrip(video_path, cache_path, slots, thumbnail_w, thumbnail_h));
+
+    // the thread holds the strip until it stops, the last one to let it go deletes it
+    std::shared_ptr<ThumbnailStrip> worker = strip;
+    strip->thread_.reset(new boost::thread([worker] () mutable {
+        std::shared_ptr<ThumbnailStrip> strip;
+        strip.swap(worker);
+        strip->run();
+    }));
+
+    // the owners share a handle that cancels the decoding when they are done with it
+    return std::shared_ptr<ThumbnailStrip>(strip.get(), [strip] (ThumbnailStrip *released) mutable {
+        released->canceled_ = true;
+        strip.reset();
+    });
+}
+
+ThumbnailStrip::~ThumbnailStrip() {
+    // the thread deletes the strip when the owners released it before the decoding stopped
+    if (thread_->get_id() == boost::this_thread::get_id()) {
+        thread_->detach();
+    } else {
+        thread_->join();
+    }
+}
+
+const std::string& ThumbnailStrip::video_path() const {
+    return video_path_;
+}
+
+uint32_t ThumbnailStrip::slots() const {
+    return thumbnails_.size();
+}
+
+uint32_t ThumbnailStrip::thumbnail_w() const {
+    return thumbnail_w_;
+}
+
+uint32_t ThumbnailStrip::thumbnail_h() const {
+    return thumbnail_h_;
+}
+
+uint32_t ThumbnailStrip::frame_count() {
+    return frame_count_;
+}
+
+uint32_t ThumbnailStrip::version() {
+    return version_;
+}
+
+bool ThumbnailStrip::finished() {
+    return finished_;
+}
+
+uint32_t ThumbnailStrip::slot_of(uint32_t frame) {
+    uint32_t count = frame_count_;
+    if (count < 1 || frame < 1) {
+        return 0;
+    }
+    if (frame > count) {
+        frame = count;
+    }
+    return (static_cast<uint64_t>(frame - 1) * thumbnails_.size()) / count;
+}
+
+thumbnail_ref_t ThumbnailStrip::thumbnail(uint32_t frame) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    for (int64_t slot = slot_of(frame); slot >= 0; --slot) {
+        if (thumbnails_[slot]) {
+            return thumbnails_[slot];
+        }
+    }
+    return thumbnail_ref_t();
+}
+
+void ThumbnailStrip::set_thumbnail(uint32_t slot, thumbnail_ref_t thumbnail) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    thumbnails_[slot] = thumbnail;
+    ++version_;
+}
+
+void ThumbnailStrip::run() {
+    if (cache_path_.empty() || !load()) {
+        decode();
+        if (!canceled_ && !cache_path_.empty()) {
+            save();
+        }
+    }
+    finished_ = true;
+}
+
+void ThumbnailStrip::decode() {
+    // a single thread, the player decoders keep the other cores
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = vs::decoder_threads_none;
+    options.thread_count = 1;
+    options.convert_threads = 1;
+    options.key_frames_only = true;
+
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(video_path_.c_str(), NULL, options);
+    if (decoder->error() || decoder->count() < 1) {
+        return;
+    }
+
+    frame_count_ = decoder->count();
+
+    while (!canceled_) {
+        uint32_t position = decoder->position();
+        if (position < 1) {
+            break;
+        }
+
+        uint32_t slot = slot_of(position);
+        bool empty = false;
+        {
+            boost::lock_guard<boost::mutex> lock(mtx_);
+            empty = !thumbnails_[slot];
+        }
+
+        if (empty) {
+            vs::frame_ref_t frame = decoder->scaled_frame(thumbnail_w_, thumbnail_h_);
+            if (!frame || !frame->w() || !frame->h()) {
+                break;
+            }
+
+            std::shared_ptr<thumbnail_t> thumbnail(new thumbnail_t());
+            thumbnail->position = position;
+            thumbnail->w = frame->w();
+            thumbnail->h = frame->h();
+            thumbnail->pixels.reset(new CharBuffer(frame->w() * frame->h() * 3));
+            for (uint32_t y = 0; y < frame->h(); ++y) {
+                memcpy(thumbnail->pixels->data + y * frame->w() * 3, frame->data() + y * frame->stride(), frame->w() * 3);
+            }
+
+            set_thumbnail(slot, thumbnail);
+        }
+
+        decoder->next();
+        if (decoder->position() <= position) {
+            break;
+        }
+    }
+}
+
+bool ThumbnailStrip::load() {
+    std::shared_ptr<FILE> fp = open_strip_file(cache_path_.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+
+    strip_header_t header;
+    if (fread(&header, sizeof(header), 1, fp.get()) != 1) {
+        return false;
+    }
+
+    if (memcmp(header.magic, kSTRIP_MAGIC, sizeof(kSTRIP_MAGIC)) != 0 ||
+        header.version != kSTRIP_VERSION ||
+        header.video_size != video_size_ ||
+        header.video_time != video_time_ ||
+        header.frame_count == 0 ||
+        header.slots != thumbnails_.size() ||
+        header.thumbnail_w != thumbnail_w_ ||
+        header.thumbnail_h != thumbnail_h_) {
+        return false;
+    }
+
+    std::vector<thumbnail_ref_t> thumbnails(thumbnails_.size());
+    for (size_t i = 0; i < thumbnails.size(); ++i) {
+        slot_header_t slot;
+        if (fread(&slot, sizeof(slot), 1, fp.get()) != 1) {
+            return false;
+        }
+        if (!slot.position) {
+            continue;
+        }
+        if (!slot.w || !slot.h || slot.w > thumbnail_w_ || slot.h > thumbnail_h_) {
+            return false;
+        }
+
+        std::shared_ptr<thumbnail_t> thumbnail(new thumbnail_t());
+        thumbnail->position = slot.position;
+        thumbnail->w = slot.w;
+        thumbnail->h = slot.h;
+        thumbnail->pixels.reset(new CharBuffer(slot.w * slot.h * 3));
+        if (fread(thumbnail->pixels->data, slot.w * slot.h * 3, 1, fp.get()) != 1) {
+            return false;
+        }
+        thumbnails[i] = thumbnail;
+    }
+
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    thumbnails_.swap(thumbnails);
+    frame_count_ = header.frame_count;
+    ++version_;
+
+    return true;
+}
+
+bool ThumbnailStrip::save() {
+    if (!frame_count_) {
+        return false;
+    }
+
+    std::vector<thumbnail_ref_t> thumbnails;
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        thumbnails = thumbnails_;
+    }
+
+    // other windows may be loading the strip, so it's replaced at once
+    std::string temp_path = boost::filesystem::unique_path(cache_path_ + ".%%%%%%.tmp").string();
+    std::shared_ptr<FILE> fp = open_strip_file(temp_path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+
+    strip_header_t header;
+    memcpy(header.magic, kSTRIP_MAGIC, sizeof(kSTRIP_MAGIC));
+    header.version = kSTRIP_VERSION;
+    header.video_size = video_size_;
+    header.video_time = video_time_;
+    header.frame_count = frame_count_;
+    header.slots = thumbnails.size();
+    header.thumbnail_w = thumbnail_w_;
+    header.thumbnail_h = thumbnail_h_;
+
+    bool written = fwrite(&header, sizeof(header), 1, fp.get()) == 1;
+    for (size_t i = 0; written && i < thumbnails.size(); ++i) {
+        slot_header_t slot = {0, 0, 0};
+        if (thumbnails[i]) {
+            slot.position = thumbnails[i]->position;
+            slot.w = thumbnails[i]->w;
+            slot.h = thumbnails[i]->h;
+        }
+        written = fwrite(&slot, sizeof(slot), 1, fp.get()) == 1;
+        if (written && slot.position) {
+            written = fwrite(thumbnails[i]->pixels->data, slot.w * slot.h * 3, 1, fp.get()) == 1;
+        }
+    }
+    fp.reset();
+
+    boost::system::error_code ec;
+    if (written) {
+        boost::filesystem::rename(temp_path, cache_path_, ec);
+    }
+
+    if (!written || ec) {
+        boost::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace vcutter
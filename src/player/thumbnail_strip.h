@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_PLAYER_THUMBNAIL_STRIP_H_
+#define SRC_PLAYER_THUMBNAIL_STRIP_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "src/common/buffers.h"
+
+namespace vcutter {
+
+typedef struct {
+    uint32_t position;  // the key frame in the thumbnail
+    uint32_t w;
+    uint32_t h;
+    std::shared_ptr<CharBuffer> pixels;  // rgb24, packed rows
+} thumbnail_t;
+
+typedef std::shared_ptr<const thumbnail_t> thumbnail_ref_t;
+
+/*
+ * Thumbnails of a video split in slots of the same number of frames.
+ * A thread with its own decoder walks the key frames only and fills the slots as it goes,
+ * a slot keeps the first key frame inside it (the slots without key frames stay empty).
+ * The finished strip is stored at cache_path and loaded from there while the video does not change.
+ * Releasing the strip does not wait for the thread (it may be opening the video), the thread frees it once it stops.
+ */
+class ThumbnailStrip {
+    ThumbnailStrip(const ThumbnailStrip&) = delete;
+    ThumbnailStrip& operator=(const ThumbnailStrip&) = delete;
+ public:
+    // starts the decoding, releasing the last reference cancels it
+    static std::shared_ptr<ThumbnailStrip> open(
+        const char *video_path, const char *cache_path, uint32_t slots, uint32_t thumbnail_w, uint32_t thumbnail_h);
+    virtual ~ThumbnailStrip();
+    const std::string& video_path() const;
+    uint32_t slots() const;
+    uint32_t thumbnail_w() const;
+    uint32_t thumbnail_h() const;
+    // the frames of the video (0 until the decoder opens it)
+    uint32_t frame_count();
+    // the thumbnail of the slot with the frame, or of the nearest slot before it with one (empty when there is none)
+    thumbnail_ref_t thumbnail(uint32_t frame);
+    // incremented on every new thumbnail
+    uint32_t version();
+    bool finished();
+
+ private:
+    ThumbnailStrip(const char *video_path, const char *cache_path, uint32_t slots, uint32_t thumbnail_w, uint32_t thumbnail_h);
+    void run();
+    void decode();
+    uint32_t slot_of(uint32_t frame);
+    void set_thumbnail(uint32_t slot, thumbnail_ref_t thumbnail);
+    bool load();
+    bool save();
+
+ private:
+    std::string video_path_;
+    std::string cache_path_;
+    uint32_t thumbnail_w_;
+    uint32_t thumbnail_h_;
+    int64_t video_size_;
+    int64_t video_time_;
+    boost::mutex mtx_;
+    std::vector<thumbnail_ref_t> thumbnails_;
+    std::atomic<uint32_t> frame_count_;
+    std::atomic<uint32_t> version_;
+    std::atomic_bool finished_;
+    std::atomic_bool canceled_;
+    std::unique_ptr<boost::thread> thread_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_PLAYER_THUMBNAIL_STRIP_H_
@@ -2,8 +2,6 @@
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
 #include <GL/gl.h>
-#include <opencv2/opencv.hpp>
-#include <opencv2/video/video.hpp>
 #include <FL/Fl.H>
 #include <FL/gl.h>
 
@@ -34,8 +32,6 @@ void BufferViewer::init(BufferSupplier *supplier, DrawHandler *observer) {
     mouse_down_right_ = false;
     mouse_down_x_ = 0;
     mouse_down_y_ = 0;
-    buffer_usage_ = 0;
-    buffer_size_ = 0;
     valid(0);
     vp_[0] = 0;
     vp_[1] = 0;
@@ -44,6 +40,10 @@ void BufferViewer::init(BufferSupplier *supplier, DrawHandler *observer) {
 }
 
 BufferViewer::~BufferViewer() {
+    if (context()) {
+        make_current();
+        texture_.release();
+    }
 }
 
 void BufferViewer::cancel_operations() {
@@ -163,52 +163,34 @@ const viewport_t & BufferViewer::view_port() const {
 }
 
 void BufferViewer::draw_buffer(const unsigned char* buffer, uint32_t w, uint32_t h) {
-    update_cache(&buffer, &w, &h);
-
+    // the buffer goes to a texture the sampler scales to the view port. the suppliers that can (the clipping editor
+    // while playing) hand out frames the decoder already resized to the view port
     float pixel_zoom = vp_.raster_zoom(w, h);
     point_t raster = vp_.raster_coords(w, h);
 
-    glRasterPos2f(-1.0 + raster.x, 1.0 - raster.y);
-    glPixelZoom(pixel_zoom, -pixel_zoom);
-    if (w % 4 == 0)
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    else
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    glDrawPixels(w, h, GL_RGB, GL_UNSIGNED_BYTE, buffer);
-
-    glRasterPos2f(0.0f, 0.0f);
-    glPixelZoom(1.0f, 1.0f);
-}
-
-void BufferViewer::update_cache(const unsigned char** buffer, uint32_t *w, uint32_t *h) {
-    unsigned int nw = *w, nh = *h;
-    view_port().fit(&nw, &nh);
-    unsigned int required_size = nw * nh * 3;
-
-    unsigned int vp_size = nw * nh * 3;
-
-    if (required_size > vp_size * 0.6) {
-        buffer_.reset(); // do not keep cache data
-        buffer_size_ = 0;
+    if (!pixel_zoom || !texture_.upload(buffer, w, h)) {
         return;
     }
 
-    if (buffer_size_ < required_size || !buffer_) {
-        // allocate only if preview buffer is not enough to store
-        buffer_size_ = required_size;
-        buffer_.reset(new unsigned char[buffer_size_], [](unsigned char* b) { delete[] b;});
-    }
+    float left = -1.0 + raster.x;
+    float top = 1.0 - raster.y;
+    float right = left + (2.0 / vp_[2]) * (w * pixel_zoom);
+    float bottom = top - (2.0 / vp_[3]) * (h * pixel_zoom);
+
+    glEnable(GL_TEXTURE_2D);
+    texture_.bind();
 
-    buffer_usage_ = required_size;
-    cv::Mat target(nw, nh, CV_8UC3, buffer_.get());
-    cv::Mat source(*h, *w, CV_8UC3, const_cast<unsigned char *>(*buffer));
+    glDisable(GL_LIGHTING);
+    glColor4f(1.0, 1.0, 1.0, 1.0);
 
-    cv::resize(source, target, target.size(), CV_INTER_LINEAR);
+    glBegin(GL_QUADS);
+    glTexCoord2d(0.0, 0.0); glVertex2d(left, top);
+    glTexCoord2d(1.0, 0.0); glVertex2d(right, top);
+    glTexCoord2d(1.0, 1.0); glVertex2d(right, bottom);
+    glTexCoord2d(0.0, 1.0); glVertex2d(left, bottom);
+    glEnd();
 
-    *w = nw;
-    *h = nh;
-    *buffer = buffer_.get();
+    glDisable(GL_TEXTURE_2D);
 }
 
 }  // namespace vcutter
@@ -9,6 +9,7 @@
 #include <FL/Fl_Gl_Window.H>
 
 #include "src/common/view_port.h"
+#include "src/viewer/texture_stream.h"
 
 namespace vcutter {
 
@@ -51,7 +52,6 @@ class BufferViewer: public Fl_Gl_Window {
  private:
     void init(BufferSupplier *supplier, DrawHandler *observer);
     void draw_buffer(const unsigned char* buffer, uint32_t w, uint32_t h);
-    void update_cache(const unsigned char** buffer, uint32_t *w, uint32_t *h);
  protected:
     int handle(int event) override;
     void draw() override;
@@ -59,15 +59,13 @@ class BufferViewer: public Fl_Gl_Window {
 
  private:
     viewport_t vp_;
+    TextureStream texture_;
     BufferSupplier *supplier_;
     DrawHandler *observer_;
     bool mouse_down_left_;
     bool mouse_down_right_;
     int mouse_down_x_;
     int mouse_down_y_;
-    unsigned int buffer_size_;
-    unsigned int buffer_usage_;
-    std::shared_ptr<unsigned char> buffer_;
 };
 
 } //namespace vcutter
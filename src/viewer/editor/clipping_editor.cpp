@@ -105,7 +105,7 @@ void ClippingEditor::viewer_draw(BufferViewer *viewer, bool *handled, const unsi
         if (clipping_->player()->info()->position() == clipping_->first_frame()) {
             frame_numbers_[0] = clipping_->player()->info()->position();
             if (should_update_ || !initialized_caches_[0]) {
-                text_first_frame_->draw(view_port(), buffer, w, h, true);
+                text_first_frame_->draw(view_port(), buffer, w, h);
                 initialized_caches_[0] = true;
             }
 
@@ -113,14 +113,14 @@ void ClippingEditor::viewer_draw(BufferViewer *viewer, bool *handled, const unsi
         } else if (clipping_->player()->info()->position() == clipping_->last_frame()) {
             frame_numbers_[2] = clipping_->player()->info()->position();
             if (should_update_ || !initialized_caches_[2]) {
-                text_last_frame_->draw(view_port(), buffer, w, h, true);
+                text_last_frame_->draw(view_port(), buffer, w, h);
                 initialized_caches_[0] = true;
             }
             text_last_frame_->draw(view_port());
         } else {
             frame_numbers_[1] = clipping_->player()->info()->position();
             if (should_update_ || !initialized_caches_[1]) {
-                text_curr_frame_->draw(view_port(), buffer, w, h, true);
+                text_curr_frame_->draw(view_port(), buffer, w, h);
                 initialized_caches_[1] = true;
             }
             text_curr_frame_->draw(view_port());
@@ -180,10 +180,26 @@ void ClippingEditor::draw_compare_box() {
 }
 
 void ClippingEditor::viewer_buffer(BufferViewer *viewer, const unsigned char** buffer, uint32_t *w, uint32_t *h) {
-    if (clipping_) {
-        *buffer = clipping_->player()->info()->buffer();
-        *w = clipping_->player()->info()->w();
-        *h = clipping_->player()->info()->h();
+    display_frame_.reset();
+
+    if (!clipping_) {
+        return;
+    }
+
+    // the decoder resizes the frames to the view port while playing. with a proxy the editing
+    // never decodes the original video, the keys keep the coordinates of the original size
+    if (clipping_->player()->is_playing() || clipping_->player()->has_proxy()) {
+        clipping_->player()->display_size(view_port()[2], view_port()[3]);
+    } else {
+        clipping_->player()->display_size(0, 0);
+    }
+
+    // the player thread presents the frames, the ui never reads the decoder while it decodes
+    display_frame_ = clipping_->player()->display_frame();
+    if (display_frame_) {
+        *buffer = display_frame_->data();
+        *w = display_frame_->w();
+        *h = display_frame_->h();
     }
 }
 
@@ -64,6 +64,7 @@ private:
     bool compare_box_wink_;
     Fl_RGB_Image *last_cursor_;
     Clipping *clipping_;
+    vs::frame_ref_t display_frame_;  // keeps the pixels drawn while playing
 
     ClippingOperationSet operation_set_;
 
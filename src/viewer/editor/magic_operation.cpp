@@ -31,13 +31,13 @@ namespace vcutter {
     near_apply_ = false;
     cursor_ = xpm::image(xpm::cursor_dot);
     auto img = xpm::image(xpm::editor_apply);
-    apply_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));
+    apply_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));
     img = xpm::image(xpm::editor_apply_off);
-    apply_off_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));
+    apply_off_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));
     img = xpm::image(xpm::editor_target1);
-    target1_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));;
+    target1_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));;
     img = xpm::image(xpm::editor_target2);
-    target2_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));;
+    target2_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));;
  }
 
 MagicOperation::~MagicOperation() {
@@ -15,7 +15,7 @@ ResizeOperation::ResizeOperation(const char *name) : ClippingOperation(name) {
     should_redraw_ = false;
     cursor_ = xpm::image(xpm::cursor_resize);
     auto img = xpm::image(xpm::editor_resize, 0);
-    resize_point_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));
+    resize_point_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));
     mouse_distance_ = 100;
 }
 
@@ -15,7 +15,7 @@ RotateOperation::RotateOperation(const char *name) : ClippingOperation(name) {
     should_redraw_ = false;
     cursor_ = xpm::image(xpm::cursor_rotate);
     auto img = xpm::image(xpm::editor_rotate, 0);
-    rotate_point_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), false, true));
+    rotate_point_.reset(new ViewerTexture(reinterpret_cast<const uint8_t*>(img->data()[0]), img->w(), img->h(), true));
     mouse_distance_ = 100;
 }
 
@@ -29,11 +29,14 @@ void MiniatureViewer::update_preview(Clipping *clipping) {
     if (miniature_buffer_w_ != clipping_->w() || miniature_buffer_h_ != clipping_->h() || !render_buffer_) {
         miniature_buffer_w_ = clipping_->w();
         miniature_buffer_h_ = clipping_->h();
-        uint32_t required_size = clipping_->req_buffer_size();
-        render_buffer_.reset(new uint8_t[required_size], [](uint8_t *b) { delete[] b;});
+        if (render_buffer_) {
+            render_buffer_->resize(clipping_->req_buffer_size());
+        } else {
+            render_buffer_.reset(new CharBuffer(clipping_->req_buffer_size()));
+        }
     }
 
-    clipping_->render(clipping_->at(clipping_->player()->info()->position()), render_buffer_.get());
+    clipping_->render(clipping_->at(clipping_->player()->info()->position()), render_buffer_->data);
     modified_ = true;
     redraw();
 }
@@ -48,7 +51,7 @@ void MiniatureViewer::viewer_draw(BufferViewer *viewer, bool *handled, const uns
            viewer_texture_.reset(new ViewerTexture());
         }
 
-        viewer_texture_->draw(viewer->view_port(), render_buffer_.get(), miniature_buffer_w_, miniature_buffer_h_, true);
+        viewer_texture_->draw(viewer->view_port(), render_buffer_->data, miniature_buffer_w_, miniature_buffer_h_);
     } else {
         viewer_texture_->draw(viewer->view_port());
     }
@@ -58,11 +61,11 @@ void MiniatureViewer::viewer_draw(BufferViewer *viewer, bool *handled, const uns
 }
 
 void MiniatureViewer::viewer_buffer(BufferViewer *viewer, const unsigned char** buffer, uint32_t *w, uint32_t *h) {
-    if (!clipping_) {
+    if (!clipping_ || !render_buffer_) {
         return;
     }
 
-    *buffer = render_buffer_.get();
+    *buffer = render_buffer_->data;
     *w = miniature_buffer_w_;
     *h = miniature_buffer_h_;
 }
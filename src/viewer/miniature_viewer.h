@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "src/common/buffers.h"
 #include "src/player/player.h"
 #include "src/clippings/clipping.h"
 #include "src/viewer/buffer_viewer.h"
@@ -30,7 +31,7 @@ private:
     bool modified_;
     uint32_t miniature_buffer_w_;
     uint32_t miniature_buffer_h_;
-    std::shared_ptr<unsigned char> render_buffer_;
+    std::unique_ptr<CharBuffer> render_buffer_;
 };
 
 }  // namespace vcutter
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <FL/gl.h>
+#include <GL/glext.h>
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <GL/glx.h>
+#endif
+
+#include "src/viewer/texture_stream.h"
+
+namespace vcutter {
+
+namespace {
+
+typedef struct {
+    PFNGLGENBUFFERSPROC gen_buffers;
+    PFNGLDELETEBUFFERSPROC delete_buffers;
+    PFNGLBINDBUFFERPROC bind_buffer;
+    PFNGLBUFFERDATAPROC buffer_data;
+    PFNGLMAPBUFFERPROC map_buffer;
+    PFNGLUNMAPBUFFERPROC unmap_buffer;
+} buffer_functions_t;
+
+buffer_functions_t gl;
+bool gl_loaded = false;
+
+void *gl_function(const char *name) {
+#if defined(_WIN32)
+    return reinterpret_cast<void *>(wglGetProcAddress(name));
+#elif defined(__APPLE__)
+    return NULL;
+#else
+    return reinterpret_cast<void *>(glXGetProcAddressARB(reinterpret_cast<const GLubyte *>(name)));
+#endif
+}
+
+template<class T> bool load_function(T *function, const char *name) {
+    *function = reinterpret_cast<T>(gl_function(name));
+    if (!*function) {
+        *function = reinterpret_cast<T>(gl_function((std::string(name) + "ARB").c_str()));
+    }
+    return *function != NULL;
+}
+
+bool has_pixel_buffers() {
+    const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+    const char *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+    int major = 0, minor = 0;
+
+    if (version && sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 2 || (major == 2 && minor >= 1))) {
+        return true;
+    }
+
+    return extensions && strstr(extensions, "GL_ARB_pixel_buffer_object") != NULL;
+}
+
+bool load_pixel_buffers() {
+    if (gl_loaded) {
+        return true;
+    }
+
+    // glXGetProcAddress returns an address even for the functions the driver lacks, check the version first
+    if (!has_pixel_buffers()) {
+        return false;
+    }
+
+    gl_loaded = load_function(&gl.gen_buffers, "glGenBuffers") &&
+        load_function(&gl.delete_buffers, "glDeleteBuffers") &&
+        load_function(&gl.bind_buffer, "glBindBuffer") &&
+        load_function(&gl.buffer_data, "glBufferData") &&
+        load_function(&gl.map_buffer, "glMapBuffer") &&
+        load_function(&gl.unmap_buffer, "glUnmapBuffer");
+
+    return gl_loaded;
+}
+
+}  // namespace
+
+TextureStream::TextureStream() {
+    texture_id_ = 0;
+    pixel_buffers_[0] = 0;
+    pixel_buffers_[1] = 0;
+    next_buffer_ = 0;
+    w_ = 0;
+    h_ = 0;
+    rgba_ = false;
+    checked_pixel_buffers_ = false;
+    pixel_buffers_supported_ = false;
+}
+
+TextureStream::~TextureStream() {
+    // the context may be gone here, the owner calls release() while it is current
+}
+
+uint32_t TextureStream::w() const {
+    return w_;
+}
+
+uint32_t TextureStream::h() const {
+    return h_;
+}
+
+bool TextureStream::uses_pixel_buffers() const {
+    return pixel_buffers_[0] != 0;
+}
+
+bool TextureStream::allocate(uint32_t w, uint32_t h, bool rgba) {
+    if (!checked_pixel_buffers_) {
+        checked_pixel_buffers_ = true;
+        pixel_buffers_supported_ = load_pixel_buffers();
+    }
+
+    if (pixel_buffers_supported_ && !pixel_buffers_[0]) {
+        gl.gen_buffers(2, pixel_buffers_);
+        if (!pixel_buffers_[0] || !pixel_buffers_[1]) {
+            gl.delete_buffers(2, pixel_buffers_);
+            pixel_buffers_[0] = 0;
+            pixel_buffers_[1] = 0;
+            pixel_buffers_supported_ = false;
+        }
+    }
+
+    if (!texture_id_) {
+        glGenTextures(1, &texture_id_);
+        if (!texture_id_) {
+            return false;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, rgba ? GL_RGBA : GL_RGB, w, h, 0, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, NULL);
+
+    w_ = w;
+    h_ = h;
+    rgba_ = rgba;
+
+    return true;
+}
+
+bool TextureStream::upload(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba) {
+    if (!buffer || !w || !h) {
+        return false;
+    }
+
+    if (!texture_id_ || w != w_ || h != h_ || rgba != rgba_) {
+        if (!allocate(w, h, rgba)) {
+            return false;
+        }
+    } else {
+        glBindTexture(GL_TEXTURE_2D, texture_id_);
+    }
+
+    uint32_t line_size = w * (rgba ? 4 : 3);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, line_size % 4 == 0 ? 4 : 1);
+
+    if (pixel_buffers_[0] && upload_pixel_buffer(buffer, line_size * h)) {
+        return true;
+    }
+
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, buffer);
+
+    return true;
+}
+
+bool TextureStream::upload_pixel_buffer(const uint8_t *buffer, uint32_t size) {
+    gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffers_[next_buffer_]);
+    next_buffer_ = (next_buffer_ + 1) % 2;
+
+    // orphan the storage: the driver may still be reading the previous frame from it
+    gl.buffer_data(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+    void *target = gl.map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+    if (!target) {
+        gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    memcpy(target, buffer, size);
+
+    if (!gl.unmap_buffer(GL_PIXEL_UNPACK_BUFFER)) {
+        gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    // with a bound unpack buffer the pointer is an offset inside it
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w_, h_, rgba_ ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    return true;
+}
+
+bool TextureStream::bind() {
+    if (!texture_id_) {
+        return false;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture_id_);
+
+    return true;
+}
+
+void TextureStream::release() {
+    if (pixel_buffers_[0]) {
+        gl.delete_buffers(2, pixel_buffers_);
+        pixel_buffers_[0] = 0;
+        pixel_buffers_[1] = 0;
+    }
+
+    if (texture_id_) {
+        glDeleteTextures(1, &texture_id_);
+        texture_id_ = 0;
+    }
+
+    w_ = 0;
+    h_ = 0;
+    next_buffer_ = 0;
+}
+
+}  // namespace vcutter
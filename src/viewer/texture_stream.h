@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VIEWER_TEXTURE_STREAM_H_
+#define SRC_VIEWER_TEXTURE_STREAM_H_
+
+#include <inttypes.h>
+
+namespace vcutter {
+
+/*
+ * A texture that receives a new picture on every frame.
+ * The texture storage is allocated once per size and the pictures are copied with glTexSubImage2D
+ * through two pixel buffer objects used in turns, so the driver copies one frame while the next is written.
+ * Without pixel buffer objects (GL < 2.1 and no ARB_pixel_buffer_object) it uploads from client memory.
+ * Every method but the destructor needs the GL context current. call release() before the context goes away.
+ */
+class TextureStream {
+    TextureStream(const TextureStream&) = delete;
+    TextureStream& operator=(const TextureStream&) = delete;
+ public:
+    TextureStream();
+    virtual ~TextureStream();
+    bool upload(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba=false);
+    // bind the texture with linear filtering, so the sampler scales the picture to the quad
+    bool bind();
+    void release();
+    uint32_t w() const;
+    uint32_t h() const;
+    bool uses_pixel_buffers() const;
+
+ private:
+    bool allocate(uint32_t w, uint32_t h, bool rgba);
+    bool upload_pixel_buffer(const uint8_t *buffer, uint32_t size);
+
+ private:
+    uint32_t texture_id_;
+    uint32_t pixel_buffers_[2];
+    uint32_t next_buffer_;
+    uint32_t w_;
+    uint32_t h_;
+    bool rgba_;
+    bool checked_pixel_buffers_;
+    bool pixel_buffers_supported_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_VIEWER_TEXTURE_STREAM_H_
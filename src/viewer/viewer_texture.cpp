@@ -1,9 +1,8 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <string.h>
 #include <GL/gl.h>
-#include <opencv2/opencv.hpp>
-#include <opencv2/video/video.hpp>
 #include <FL/Fl.H>
 #include <FL/gl.h>
 
@@ -14,52 +13,45 @@ namespace vcutter {
 
 
 ViewerTexture::ViewerTexture() {
-    texture_id_ = 0;
     texture_w_ = 0;
     texture_h_ = 0;
-    resize_texture_ = false;
     rgba_ = false;
     buffer_w_ = 0;
     buffer_h_ = 0;
-    view_w_ = 0;
-    view_h_ = 0;
 }
 
-ViewerTexture::ViewerTexture(const uint8_t *buffer, uint32_t w, uint32_t h, bool resize_texture, bool rgba) {
-    texture_id_ = 0;
+ViewerTexture::ViewerTexture(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba) {
     texture_w_ = 0;
     texture_h_ = 0;
-    resize_texture_ = false;
     rgba_ = false;
     buffer_w_ = 0;
     buffer_h_ = 0;
-    view_w_ = 0;
-    view_h_ = 0;
-    update(buffer, w, h, resize_texture, rgba);
+    update(buffer, w, h, rgba);
 }
 
 ViewerTexture::~ViewerTexture() {
-    if (texture_id_) {
+    if (texture_w_) {
         gl_start();
-        glDeleteTextures(1, &texture_id_);
+        texture_.release();
         gl_finish();
     }
 }
 
-void ViewerTexture::update(const uint8_t *buffer, uint32_t w, uint32_t h, bool resize_texture, bool rgba) {
+void ViewerTexture::update(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba) {
     auto buffer_size = w * h * (rgba ? 4 : 3);
-    buffer_.reset(new uint8_t[buffer_size], [](const uint8_t *b) { delete[] b;});
+    if (buffer_) {
+        buffer_->resize(buffer_size);
+    } else {
+        buffer_.reset(new CharBuffer(buffer_size));
+    }
     buffer_w_ = w;
     buffer_h_ = h;
-    resize_texture_ = resize_texture;
     rgba_ = rgba;
-    memcpy(buffer_.get(), buffer, buffer_size);
+    memcpy(buffer_->data, buffer, buffer_size);
 }
 
 void ViewerTexture::draw(const viewport_t &vp, float x, float y, float zoom) {
-    update_texture(vp, NULL, 0, 0, resize_texture_, rgba_);
-
-    if (!texture_w_ || !texture_h_ || !texture_id_) {
+    if (!update_texture(NULL, 0, 0, rgba_)) {
         return;
     }
 
@@ -75,7 +67,7 @@ void ViewerTexture::draw(const viewport_t &vp, float x, float y, float zoom) {
     }
 
     glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    texture_.bind();
 
     glDisable(GL_LIGHTING);
     glColor4f(1.0, 1.0, 1.0, 1.0);
@@ -94,10 +86,8 @@ void ViewerTexture::draw(const viewport_t &vp, float x, float y, float zoom) {
     }
 }
 
-void ViewerTexture::draw(const viewport_t &vp, const uint8_t *buffer, uint32_t w, uint32_t h, bool resize_texture, bool rgba) {
-    update_texture(vp, buffer, w, h, resize_texture, rgba);
-
-    if (!texture_w_ || !texture_h_ || !texture_id_) {
+void ViewerTexture::draw(const viewport_t &vp, const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba) {
+    if (!update_texture(buffer, w, h, rgba)) {
         return;
     }
 
@@ -131,7 +121,7 @@ void ViewerTexture::draw(const viewport_t &vp, const uint8_t *buffer, uint32_t w
     }
 
     glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    texture_.bind();
 
     glDisable(GL_LIGHTING);
     glColor4f(1.0, 1.0, 1.0, 1.0);
@@ -151,9 +141,7 @@ void ViewerTexture::draw(const viewport_t &vp, const uint8_t *buffer, uint32_t w
 }
 
 void ViewerTexture::draw(const viewport_t &vp, uint32_t vw, uint32_t vh, box_t texture_coords, box_t view_coords, float alpha) {
-    update_texture(vp, NULL, 0, 0, resize_texture_, rgba_);
-
-    if (!texture_w_ || !texture_h_ || !texture_id_) {
+    if (!update_texture(NULL, 0, 0, rgba_)) {
         return;
     }
 
@@ -169,7 +157,7 @@ void ViewerTexture::draw(const viewport_t &vp, uint32_t vw, uint32_t vh, box_t t
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    texture_.bind();
 
     glDisable(GL_LIGHTING);
     glColor4f(1.0, 1.0, 1.0, alpha);
@@ -187,69 +175,25 @@ void ViewerTexture::draw(const viewport_t &vp, uint32_t vw, uint32_t vh, box_t t
 }
 
 
-void ViewerTexture::update_texture(const viewport_t &vp, const uint8_t* buffer, uint32_t w, uint32_t h, bool resize_texture, bool rgba) {
-    if (!buffer && !buffer_) {
-        return;
-    }
-
-    if (!buffer) {
-        buffer = buffer_.get();
+bool ViewerTexture::update_texture(const uint8_t* buffer, uint32_t w, uint32_t h, bool rgba) {
+    if (!buffer && buffer_) {
+        buffer = buffer_->data;
         w = buffer_w_;
         h = buffer_h_;
-        resize_texture = resize_texture_;
         rgba = rgba_;
-    } else {
-        resize_texture_ = resize_texture;
+    } else if (buffer) {
         rgba_ = rgba;
     }
 
-    if (texture_id_ == 0 || (resize_texture && (static_cast<uint32_t>(vp[2]) != view_w_ || static_cast<uint32_t>(vp[3]) != view_h_)) || w != texture_w_ || h != texture_h_) {
-        if (texture_id_) {
-            glDeleteTextures(1, &texture_id_);
-        }
-
-        glGenTextures(1, &texture_id_);
-
-        if (!texture_id_) {
-            buffer_.reset();
-            return;
-        }
-
-        view_w_ = vp[2];
-        view_h_ = vp[3];
-        texture_w_ = w;
-        texture_h_ = h;
-
-        if (resize_texture) {
-            vp.fit(&texture_w_, &texture_h_);
+    if (buffer) {
+        if (texture_.upload(buffer, w, h, rgba)) {
+            texture_w_ = w;
+            texture_h_ = h;
         }
-    }
-
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
-
-    if (texture_w_ % 4 == 0) {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    } else {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    }
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-
-    if (w == texture_w_ && h == texture_h_) {
-        glTexImage2D(GL_TEXTURE_2D, 0, rgba ? GL_RGBA : GL_RGB , texture_w_, texture_h_, 0, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, buffer);
-    } else {
-        cv::Mat texture(texture_h_, texture_w_, CV_8UC3);
-        cv::Mat source(h, w, rgba ? CV_8UC4 : CV_8UC3, const_cast<unsigned char *>(buffer));
-        cv::resize(source, texture, texture.size(), CV_INTER_LINEAR);
-        glTexImage2D(GL_TEXTURE_2D, 0, rgba ? GL_RGBA : GL_RGB, texture_w_, texture_h_, 0, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, texture.data);
-    }
-
-    if (buffer_) {
         buffer_.reset();
     }
+
+    return texture_w_ && texture_h_;
 }
 
 }  // namespace vcutter
@@ -7,33 +7,34 @@
 #include <inttypes.h>
 #include <memory>
 
+#include "src/common/buffers.h"
 #include "src/common/view_port.h"
+#include "src/viewer/texture_stream.h"
 
 namespace vcutter {
 
 class ViewerTexture {
  public:
     ViewerTexture();
-    ViewerTexture(const uint8_t *buffer, uint32_t w, uint32_t h, bool resize_texture=false, bool rgba=false);
+    ViewerTexture(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba=false);
     virtual ~ViewerTexture();
-    void update(const uint8_t *buffer, uint32_t w, uint32_t h, bool resize_texture=false, bool rgba=false);
+    // keep a copy of the buffer until the next draw (it may happen without a gl context)
+    void update(const uint8_t *buffer, uint32_t w, uint32_t h, bool rgba=false);
     void draw(const viewport_t &vp, float x, float y, float zoom);
-    void draw(const viewport_t &vp, const uint8_t *buffer=NULL, uint32_t w=0, uint32_t h=0, bool resize_texture=false, bool rgba=false);
+    // the texture keeps the buffer size, the sampler scales it to the view port
+    void draw(const viewport_t &vp, const uint8_t *buffer=NULL, uint32_t w=0, uint32_t h=0, bool rgba=false);
     void draw(const viewport_t &vp, uint32_t vw, uint32_t vh, box_t texture_coords, box_t view_coords, float alpha);
  private:
-    void update_texture(const viewport_t &vp, const uint8_t* buffer, uint32_t w, uint32_t h, bool resize_texture, bool rgba);
+    bool update_texture(const uint8_t* buffer, uint32_t w, uint32_t h, bool rgba);
 
  private:
-    uint32_t texture_id_;
+    TextureStream texture_;
     uint32_t texture_w_;
     uint32_t texture_h_;
-    bool resize_texture_;
-    std::shared_ptr<uint8_t> buffer_;
+    std::unique_ptr<CharBuffer> buffer_;
     bool rgba_;
     uint32_t buffer_w_;
     uint32_t buffer_h_;
-    uint32_t view_w_;
-    uint32_t view_h_;
 };
 
 }  // namespace vcutter
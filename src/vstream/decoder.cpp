@@ -1,17 +1,35 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <algorithm>
 #include "src/vstream/decoder.h"
+#include "src/vstream/frame.h"
 
 namespace vs {
 
-DecoderImp::DecoderImp(const char* path, source_type origin) {
+namespace {
+
+const uint64_t kREVERSE_MEMORY = 268435456;
+
+}  // namespace
+
+DecoderImp::DecoderImp(
+    const char* path, source_type origin, const char *keyframe_index_path, const decoder_options_t& options
+) {
     origin_ = origin;
+    reversed_ = NULL;
     stream_.reset(new vs::FFMpegStream());
+    stream_->set_decoder_options(options);
     if (!stream_->open(path)) {
         error_ = "Could not open ";
         error_ += path;
         stream_.reset();
+    } else {
+        // the key frames only decoders do not seek
+        if (!options.key_frames_only) {
+            stream_->index_keyframes(path, keyframe_index_path);
+        }
+        reverse_.reset(new vs::ReverseDecoder(stream_.get(), kREVERSE_MEMORY));
     }
 }
 
@@ -45,8 +63,12 @@ const char* DecoderImp::error() {
 }
 
 unsigned char *DecoderImp::buffer() {
+    if (reversed_) {
+        return reverse_->buffer(reversed_);
+    }
     if (stream_) {
-        return *(stream_->get_picture());
+        unsigned char **picture = stream_->get_picture();
+        return picture ? *picture : NULL;
     }
     return NULL;
 }
@@ -59,6 +81,9 @@ uint32_t DecoderImp::buffer_size() {
 }
 
 uint32_t DecoderImp::position() {
+    if (reversed_) {
+        return reversed_->frame;
+    }
     if (stream_) {
         return stream_->get_frame_number();
     }
@@ -87,6 +112,9 @@ double DecoderImp::duration() {
 }
 
 double DecoderImp::time() {
+    if (reversed_) {
+        return reversed_->time;
+    }
     if (stream_) {
         return stream_->get_frame_time();
     }
@@ -94,6 +122,9 @@ double DecoderImp::time() {
 }
 
 int64_t DecoderImp::pts() {
+    if (reversed_) {
+        return reversed_->pts;
+    }
     if (stream_) {
         return stream_->get_frame_pts();
     }
@@ -130,35 +161,206 @@ int DecoderImp::time_num() {
 }
 
 bool DecoderImp::key_frame() {
+    if (reversed_) {
+        return reversed_->key_frame;
+    }
     if (stream_) {
         return stream_->is_key_frame();
     }
     return false;
 }
 
-void DecoderImp::next() {
+decoder_thread_type DecoderImp::thread_type() {
+    if (stream_) {
+        return stream_->get_thread_type();
+    }
+    return decoder_threads_none;
+}
+
+int DecoderImp::thread_count() {
     if (stream_) {
-        stream_->next_frame();
+        return stream_->get_thread_count();
+    }
+    return 0;
+}
+
+void DecoderImp::next() {
+    if (!stream_) {
+        return;
+    }
+
+    frame_.reset();
+
+    if (reversed_) {
+        int64_t frame = reversed_->frame + 1;
+        reversed_ = reverse_->find(frame);
+
+        if (reversed_) {
+            return;
+        }
+
+        // the stream goes on from here, the ring would only pin the pictures
+        reverse_->clear();
+
+        if (stream_->get_frame_number() + 1 != frame) {
+            stream_->seek_frame(frame);
+            return;
+        }
     }
+
+    stream_->next_frame();
 }
 
 void DecoderImp::prior() {
     uint32_t frame_number = position();
+    frame_.reset();
+
+    if (stream_ && frame_number > 1) {
+        reversed_ = reverse_->fetch(frame_number - 1);
+        if (reversed_) {
+            return;
+        }
+    }
+
     if (frame_number > 0) {
         seek_frame(frame_number - 1);
     }
 }
 
 void DecoderImp::seek_frame(int64_t frame) {
+    reversed_ = NULL;
+    frame_.reset();
     if (stream_) {
+        reverse_->clear();
         stream_->seek_frame(frame);
     }
 }
 
 void DecoderImp::seek_time(int64_t ms_time) {
+    reversed_ = NULL;
+    frame_.reset();
     if (stream_) {
+        reverse_->clear();
         stream_->seek_time(ms_time);
     }
 }
 
+void DecoderImp::seek_keyframe(int64_t frame) {
+    reversed_ = NULL;
+    frame_.reset();
+    if (stream_) {
+        reverse_->clear();
+        stream_->seek_nearest_keyframe(frame);
+    }
+}
+
+void DecoderImp::interrupt_seek() {
+    if (stream_) {
+        stream_->interrupt_seek();
+    }
+}
+
+uint32_t DecoderImp::seek_generation() {
+    if (stream_) {
+        return stream_->seek_generation();
+    }
+    return 0;
+}
+
+void DecoderImp::claim_seek_generation(uint32_t generation) {
+    if (stream_) {
+        stream_->claim_seek_generation(generation);
+    }
+}
+
+void DecoderImp::skip_non_reference(bool skip) {
+    if (stream_) {
+        stream_->set_skip_non_reference(skip);
+    }
+}
+
+void DecoderImp::convert_threads(int count) {
+    if (stream_) {
+        stream_->set_convert_threads(count);
+    }
+}
+
+bool DecoderImp::yuv_planes(yuv_planes_t *planes) {
+    // the frames handed out backwards are kept only in rgb
+    if (stream_ && !reversed_) {
+        return stream_->get_yuv_planes(planes);
+    }
+    return false;
+}
+
+frame_ref_t DecoderImp::frame() {
+    if (reversed_) {
+        return reversed_->picture;
+    }
+
+    if (!frame_ && stream_) {
+        AVFramePtr picture = stream_->get_picture_ref();
+        if (picture) {
+            frame_.reset(new FrameImp(picture, position(), pts(), time(), key_frame()));
+        }
+    }
+
+    return frame_;
+}
+
+frame_ref_t DecoderImp::partial_frame(const frame_area_t& area) {
+    if (reversed_ || frame_ || !stream_) {
+        return frame();
+    }
+
+    AVFramePtr picture = stream_->get_picture_ref(area);
+    if (!picture) {
+        return frame_ref_t();
+    }
+
+    // not kept in frame_, it's not the full frame
+    return frame_ref_t(new FrameImp(picture, position(), pts(), time(), key_frame()));
+}
+
+frame_ref_t DecoderImp::scaled_frame(uint32_t max_w, uint32_t max_h) {
+    uint32_t frame_w = w();
+    uint32_t frame_h = h();
+
+    // the frames stepped backwards are kept in full size only
+    if (reversed_ || !stream_ || frame_w < 1 || frame_h < 1 || (frame_w <= max_w && frame_h <= max_h)) {
+        return frame();
+    }
+
+    double scale = std::min(max_w / static_cast<double>(frame_w), max_h / static_cast<double>(frame_h));
+    int scaled_w = std::max(1, static_cast<int>(frame_w * scale));
+    int scaled_h = std::max(1, static_cast<int>(frame_h * scale));
+
+    AVFramePtr picture = stream_->get_scaled_picture_ref(scaled_w, scaled_h);
+    if (!picture) {
+        return frame_ref_t();
+    }
+
+    return frame_ref_t(new FrameImp(picture, position(), pts(), time(), key_frame()));
+}
+
+frame_ref_t DecoderImp::source_frame() {
+    if (!stream_ || reversed_) {
+        return frame_ref_t();
+    }
+
+    AVFramePtr decoded = stream_->get_frame_ref();
+    if (!decoded) {
+        return frame_ref_t();
+    }
+
+    return frame_ref_t(new FrameImp(decoded, position(), pts(), time(), key_frame()));
+}
+
+bool DecoderImp::save_keyframe_index(const char *path) {
+    if (stream_) {
+        return stream_->save_keyframe_index(path);
+    }
+    return false;
+}
+
 }  // namespace vs
@@ -8,12 +8,17 @@
 
 #include "src/vstream/video_stream.h"
 #include "src/vstream/ffmpeg_stream.h"
+#include "src/vstream/reverse_decoder.h"
 
 namespace vs {
 
 class DecoderImp: public vs::Decoder {
  public:
-    DecoderImp(const char* path, source_type origin);
+    DecoderImp(
+        const char* path,
+        source_type origin,
+        const char *keyframe_index_path=NULL,
+        const decoder_options_t& options=default_decoder_options());
     virtual ~DecoderImp();
     source_type source() override;
     uint32_t w() override;
@@ -32,12 +37,29 @@ class DecoderImp: public vs::Decoder {
     int time_den() override;
     int time_num() override;
     bool key_frame() override;
+    decoder_thread_type thread_type() override;
+    int thread_count() override;
     void next() override;
     void prior() override;
     void seek_frame(int64_t frame) override;
     void seek_time(int64_t ms_time) override;
+    void seek_keyframe(int64_t frame) override;
+    void interrupt_seek() override;
+    uint32_t seek_generation() override;
+    void claim_seek_generation(uint32_t generation) override;
+    void skip_non_reference(bool skip) override;
+    void convert_threads(int count) override;
+    bool save_keyframe_index(const char *path) override;
+    bool yuv_planes(yuv_planes_t *planes) override;
+    frame_ref_t frame() override;
+    frame_ref_t partial_frame(const frame_area_t& area) override;
+    frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) override;
+    frame_ref_t source_frame() override;
  private:
     std::unique_ptr<vs::FFMpegStream> stream_;
+    std::unique_ptr<vs::ReverseDecoder> reverse_;
+    const reverse_frame_t *reversed_;  // the current frame when stepping backwards
+    frame_ref_t frame_;  // the handle of the current frame, created on the first request
     source_type origin_;
     std::string error_;
 };
@@ -12,6 +12,22 @@ const char *kX264_CODEC = "mp4-x264";
 const char *kX265_CODEC = "mp4-x265";
 const char *kAV1_CODEC = "aom-av1";
 const char *kMJPEG_CODEC = "mjpeg";
+const int kKEY_FRAME_INTERVAL = 10;
+const int kVP9_MIN_TILE_WIDTH = 256;
+const int kVP9_MAX_TILE_COLUMNS_LOG2 = 6;
+
+typedef struct {
+    const char *x26x_preset;
+    const char *vp9_deadline;
+    const char *vp9_cpu_used;
+} profile_settings_t;
+
+// indexed by encoder_profile
+const profile_settings_t kPROFILE_SETTINGS[] = {
+    {"veryfast", "realtime", "6"},
+    {"medium", "good", "3"},
+    {"slow", "good", "1"},
+};
 
 const char *kFORMAT_NAMES[] = {
     kVP9_CODEC,
@@ -60,8 +76,11 @@ EncoderImp::EncoderImp(
     unsigned int frame_height,
     int fps_numerator,
     int fps_denominator,
-    int bit_rate
+    int bit_rate,
+    int key_frame_interval,
+    const encoder_options_t& options
 ) {
+    options_ = options;
     opened_ = false;
     finished_ = false;
     should_close_file_ = false;
@@ -79,7 +98,7 @@ EncoderImp::EncoderImp(
     fps_numerator_ = fps_numerator;
     fps_denominator_ = fps_denominator;
     bit_rate_ = bit_rate;
-    key_frame_interval_ = 10;
+    key_frame_interval_ = key_frame_interval > 0 ? key_frame_interval : kKEY_FRAME_INTERVAL;
     max_bidirectional_frames_ = 1;
     frame_align_ = 32;
     init_encoder();
@@ -95,18 +114,10 @@ EncoderImp::~EncoderImp() {
 }
 
 bool EncoderImp::frame(const unsigned char* buffer) {
-    if (!opened_) {
-        report_error("Encoder is not opened");
+    if (!prepare_frame()) {
         return false;
     }
 
-    int ret = av_frame_make_writable(frame_.get());
-    if (ret < 0) {
-        return false;
-    }
-
-    frame_->pts = frame_pts_++;
-
     AVFrame source_frame;
     memset(&source_frame, 0, sizeof(source_frame));
     source_frame.data[0] =  const_cast<unsigned char*>(buffer);
@@ -124,6 +135,52 @@ bool EncoderImp::frame(const unsigned char* buffer) {
             frame_->data,
             frame_->linesize);
 
+    return submit_frame();
+}
+
+bool EncoderImp::yuv_frame(const yuv_planes_t& planes) {
+    if (!accepts_yuv()) {
+        report_error("The encoder does not accept yuv 4:2:0 frames");
+        return false;
+    }
+
+    if (!prepare_frame()) {
+        return false;
+    }
+
+    // the planes are copied as they are, there is no color conversion
+    av_image_copy(
+        frame_->data,
+        frame_->linesize,
+        planes.data,
+        planes.linesize,
+        AV_PIX_FMT_YUV420P,
+        frame_width_,
+        frame_height_);
+
+    return submit_frame();
+}
+
+bool EncoderImp::accepts_yuv() {
+    return opened_ && codec_ctx_->pix_fmt == AV_PIX_FMT_YUV420P;
+}
+
+bool EncoderImp::prepare_frame() {
+    if (!opened_) {
+        report_error("Encoder is not opened");
+        return false;
+    }
+
+    if (av_frame_make_writable(frame_.get()) < 0) {
+        return false;
+    }
+
+    frame_->pts = frame_pts_++;
+
+    return true;
+}
+
+bool EncoderImp::submit_frame() {
     if (!encode_frame(frame_.get())) {
         return false;
     }
@@ -161,20 +218,48 @@ bool EncoderImp::finish() {
     return true;
 }
 
+AVCodecID EncoderImp::codec_id(const char *codec_name) {
+    if (strcmp(kMJPEG_CODEC, codec_name) == 0) {
+        return AV_CODEC_ID_MJPEG;
+    } else if (strcmp(kX264_CODEC, codec_name) == 0) {
+        return AV_CODEC_ID_H264;
+    } else if (strcmp(kX265_CODEC, codec_name) == 0) {
+        return AV_CODEC_ID_HEVC;
+    } else if (strcmp(kVP9_CODEC, codec_name) == 0) {
+        return AV_CODEC_ID_VP9;
+    // } else  if (strcmp(kAV1_CODEC, codec_name) == 0) {
+        // return AV_CODEC_ID_AV1;
+    }
+    return AV_CODEC_ID_NONE;
+}
+
+const char *EncoderImp::container_name(const char *codec_name) {
+    if (strcmp(kMJPEG_CODEC, codec_name) == 0) {
+        return "mp4";
+    } else if (strcmp(kX264_CODEC, codec_name) == 0) {
+        return "mp4";
+    } else if (strcmp(kX265_CODEC, codec_name) == 0) {
+        return "mp4";
+    } else if (strcmp(kVP9_CODEC, codec_name) == 0 ||
+               strcmp(kAV1_CODEC, codec_name) == 0) {
+        return "webm";
+    }
+    return NULL;
+}
+
+void EncoderImp::set_metadata(AVFormatContext *format_ctx, const char *title, const char *author, const char *tags) {
+    if (strcmp(format_ctx->oformat->name, "mp4") == 0) {
+        av_dict_set(&format_ctx->metadata , "title", title, 0);
+        av_dict_set(&format_ctx->metadata , "artist", author, 0);
+        av_dict_set(&format_ctx->metadata , "comment", tags, 0);
+        av_dict_set(&format_ctx->metadata , "description", "encoded using https://github.com/rodjjo/smart-vcutter", 0);
+    }
+}
+
 bool EncoderImp::find_codec() {
-    AVCodecID codec_id = AV_CODEC_ID_NONE;
-
-    if (strcmp(kMJPEG_CODEC, codec_name_.c_str()) == 0) {
-        codec_id = AV_CODEC_ID_MJPEG;
-    } else if (strcmp(kX264_CODEC, codec_name_.c_str()) == 0) {
-        codec_id = AV_CODEC_ID_H264;
-    } else if (strcmp(kX265_CODEC, codec_name_.c_str()) == 0) {
-        codec_id = AV_CODEC_ID_HEVC;
-    } else if (strcmp(kVP9_CODEC, codec_name_.c_str()) == 0) {
-        codec_id = AV_CODEC_ID_VP9;
-    // } else  if (strcmp(kAV1_CODEC, codec_name_.c_str()) == 0) {
-        // codec_id = AV_CODEC_ID_AV1;
-    } else {
+    AVCodecID codec_id = EncoderImp::codec_id(codec_name_.c_str());
+
+    if (codec_id == AV_CODEC_ID_NONE) {
         report_error("Invalid codec name");
         return NULL;
     }
@@ -189,18 +274,11 @@ bool EncoderImp::find_codec() {
 }
 
 const char *EncoderImp::find_format() {
-    if (strcmp(kMJPEG_CODEC, codec_name_.c_str()) == 0) {
-        return "mp4";
-    } else if (strcmp(kX264_CODEC, codec_name_.c_str()) == 0) {
-        return "mp4";
-    } else if (strcmp(kX265_CODEC, codec_name_.c_str()) == 0) {
-        return "mp4";
-    } else if (strcmp(kVP9_CODEC, codec_name_.c_str()) == 0 ||
-               strcmp(kAV1_CODEC, codec_name_.c_str()) == 0) {
-        return "webm";
+    const char *format_name = container_name(codec_name_.c_str());
+    if (!format_name) {
+        report_error("Could not find a supported output format");
     }
-    report_error("Could not find a supported output format");
-    return NULL;
+    return format_name;
 }
 
 
@@ -221,12 +299,7 @@ bool EncoderImp::allocate_format() {
 
     format_ctx_ = vs::allocate_format_context(context);
 
-    if (strcmp(format_name, "mp4") == 0) {
-        av_dict_set(&format_ctx_->metadata , "title", title_.c_str(), 0);
-        av_dict_set(&format_ctx_->metadata , "artist", author_.c_str(), 0);
-        av_dict_set(&format_ctx_->metadata , "comment", tags_.c_str(), 0);
-        av_dict_set(&format_ctx_->metadata , "description", "encoded using https://github.com/rodjjo/smart-vcutter", 0);
-    }
+    set_metadata(format_ctx_.get(), title_.c_str(), author_.c_str(), tags_.c_str());
 
     return true;
 }
@@ -285,11 +358,7 @@ bool EncoderImp::configure_codec() {
     if (format_ctx_->oformat->flags & AVFMT_GLOBALHEADER)
         codec_ctx_->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
-    if (codec_->id == AV_CODEC_ID_H264 || codec_->id == AV_CODEC_ID_HEVC) {
-        av_opt_set(codec_ctx_->priv_data, "preset", "slow", 0);
-    } else if (codec_->id == AV_CODEC_ID_VP9) {
-        av_opt_set(codec_ctx_->priv_data, "cpu-used", "1", AV_OPT_SEARCH_CHILDREN);
-    }
+    configure_speed();
 
     int ret;
     if ((ret = avcodec_open2(codec_ctx_.get(), codec_, NULL)) < 0) {
@@ -305,6 +374,43 @@ bool EncoderImp::configure_codec() {
     return true;
 }
 
+void EncoderImp::configure_speed() {
+    int profile = options_.profile;
+    if (profile < encoder_profile_draft || profile > encoder_profile_archival) {
+        profile = encoder_profile_archival;
+    }
+    const profile_settings_t& settings = kPROFILE_SETTINGS[profile];
+
+    // 0 lets ffmpeg (or x264/x265) pick one thread by core
+    codec_ctx_->thread_count = options_.thread_count;
+
+    if (codec_->id == AV_CODEC_ID_H264 || codec_->id == AV_CODEC_ID_HEVC) {
+        av_opt_set(codec_ctx_->priv_data, "preset", settings.x26x_preset, 0);
+        if (codec_->id == AV_CODEC_ID_HEVC && options_.thread_count > 0) {
+            // libx265 ignores thread_count
+            char params[32] = "";
+            snprintf(params, sizeof(params), "pools=%d", options_.thread_count);
+            av_opt_set(codec_ctx_->priv_data, "x265-params", params, 0);
+        }
+    } else if (codec_->id == AV_CODEC_ID_VP9) {
+        av_opt_set(codec_ctx_->priv_data, "deadline", settings.vp9_deadline, AV_OPT_SEARCH_CHILDREN);
+        av_opt_set(codec_ctx_->priv_data, "cpu-used", settings.vp9_cpu_used, AV_OPT_SEARCH_CHILDREN);
+
+        // libvpx runs a single thread when thread_count is 0. the threads split the tile columns
+        // (at least 256 pixels wide each) and the rows inside them (row-mt)
+        if (codec_ctx_->thread_count < 1) {
+            codec_ctx_->thread_count = av_cpu_count();
+        }
+        int tile_columns = 0;
+        while (tile_columns < kVP9_MAX_TILE_COLUMNS_LOG2 &&
+               (static_cast<int>(frame_width_) >> (tile_columns + 1)) >= kVP9_MIN_TILE_WIDTH) {
+            ++tile_columns;
+        }
+        av_opt_set_int(codec_ctx_->priv_data, "tile-columns", tile_columns, AV_OPT_SEARCH_CHILDREN);
+        av_opt_set_int(codec_ctx_->priv_data, "row-mt", 1, AV_OPT_SEARCH_CHILDREN);
+    }
+}
+
 void EncoderImp::init_encoder() {
     if (frame_width_ % 2 != 0) {
         report_error("The video width must be multiple of 2");
@@ -25,20 +25,33 @@ class EncoderImp: public Encoder {
         unsigned int frame_height,
         int fps_numerator,
         int fps_denominator,
-        int bit_rate);
+        int bit_rate,
+        int key_frame_interval=0,
+        const encoder_options_t& options=default_encoder_options());
     virtual ~EncoderImp();
     bool frame(const unsigned char* buffer) override;
+    bool yuv_frame(const yuv_planes_t& planes) override;
+    bool accepts_yuv() override;
     const char* error() override;
     bool finish() override;
+    // AV_CODEC_ID_NONE when the codec name is unknown
+    static AVCodecID codec_id(const char *codec_name);
+    // the container of the codec name (NULL when it is unknown)
+    static const char *container_name(const char *codec_name);
+    // stores the metadata on the containers that support it
+    static void set_metadata(AVFormatContext *format_ctx, const char *title, const char *author, const char *tags);
  private:
     void init_encoder();
     bool find_codec();
     bool allocate_stream();
     const char *find_format();
     bool configure_codec();
+    void configure_speed();
     bool open_output_file();
     bool allocate_frame();
     bool allocate_format();
+    bool prepare_frame();
+    bool submit_frame();
     bool encode_frame(AVFrame *frame_data);
     void report_error(const char *error);
     bool flush_frames();
@@ -72,6 +85,7 @@ class EncoderImp: public Encoder {
     int fps_numerator_;
     int fps_denominator_;
     int bit_rate_;
+    encoder_options_t options_;
 };
 
 }  // namespace vs
@@ -34,6 +34,10 @@ AVFramePtr allocate_frame(bool free_image_data) {
     return AVFramePtr(tmp, free_image_data ? freeDataAndAVFrame : freeAvFrame);
 }
 
+AVFramePtr reference_frame(const AVFrame *frame) {
+    return AVFramePtr(av_frame_clone(frame), freeAvFrame);
+}
+
 AVFrame *alloc_picture(enum AVPixelFormat pix_fmt, int width, int height) {
     AVFrame *picture;
     int ret;
@@ -73,14 +77,14 @@ AVCodecContextPtr allocate_codec_context(AVCodec *codec) {
         freeCodecContext);
 }
 
-SwsContextPtr allocate_sws_rgb_context(const AVFrame* source_frame) {
+SwsContextPtr allocate_sws_rgb_context(enum AVPixelFormat source_format, int width, int height) {
     return SwsContextPtr(
         sws_getContext(
-            source_frame->width,
-            source_frame->height,
-            static_cast<AVPixelFormat>(source_frame->format),
-            source_frame->width,
-            source_frame->height,
+            width,
+            height,
+            source_format,
+            width,
+            height,
             AV_PIX_FMT_RGB24,
             SWS_FAST_BILINEAR,
             NULL,
@@ -89,9 +93,20 @@ SwsContextPtr allocate_sws_rgb_context(const AVFrame* source_frame) {
         &sws_freeContext);
 }
 
-void free_picture(AVPicture* picture) {
-  avpicture_free(picture);
-  delete picture;
+SwsContextPtr allocate_sws_gray_context(enum AVPixelFormat source_format, int width, int height) {
+    return SwsContextPtr(
+        sws_getContext(
+            width,
+            height,
+            source_format,
+            width,
+            height,
+            AV_PIX_FMT_GRAY8,
+            SWS_FAST_BILINEAR,
+            NULL,
+            NULL,
+            NULL),
+        &sws_freeContext);
 }
 
 SwsContextPtr allocate_sws_ycbcr_context(int width, int height) {
@@ -125,39 +140,49 @@ SwsContextPtr allocate_sws_yuvj_context(int width, int height) {
             NULL),
         &sws_freeContext);
 }
-AVPicturePtr allocate_rgb_picture(const AVFrame *source_frame) {
-  AVPicturePtr picture(new AVPicture, free_picture);
-  avpicture_alloc(
-      picture.get(),
-      AV_PIX_FMT_RGB24,
-      source_frame->width,
-        source_frame->height);
-  return picture;
-}
 
-SwsContextPtr allocate_sws_gray_context(const AVFrame* source_frame) {
+SwsContextPtr allocate_sws_scaled_rgb_context(const AVFrame* source_frame, int width, int height) {
     return SwsContextPtr(
         sws_getContext(
             source_frame->width,
             source_frame->height,
             static_cast<AVPixelFormat>(source_frame->format),
-            source_frame->width,
-            source_frame->height,
+            width,
+            height,
             AV_PIX_FMT_RGB24,
-            SWS_FAST_BILINEAR,
+            SWS_BILINEAR,
             NULL,
             NULL,
             NULL),
         &sws_freeContext);
 }
 
-AVPicturePtr allocate_gray_picture(const AVFrame *source_frame) {
-  AVPicturePtr picture(new AVPicture, free_picture);
-  avpicture_alloc(
-      picture.get(),
-      AV_PIX_FMT_RGB24,
-      source_frame->width,
-        source_frame->height);
+AVBufferPoolPtr allocate_picture_pool(int width, int height, enum AVPixelFormat pixel_format) {
+    int size = av_image_get_buffer_size(pixel_format, width, height, 1);
+    return AVBufferPoolPtr(av_buffer_pool_init(size, NULL), [] (AVBufferPool *pool) {
+        // the buffers still referenced are freed when they are released
+        av_buffer_pool_uninit(&pool);
+    });
+}
+
+AVFramePtr allocate_pooled_picture(AVBufferPool *pool, int width, int height, enum AVPixelFormat pixel_format) {
+    AVFramePtr picture = allocate_frame();
+    if (!picture) {
+        return picture;
+    }
+
+    picture->buf[0] = av_buffer_pool_get(pool);
+    if (!picture->buf[0]) {
+        return AVFramePtr();
+    }
+
+    picture->format = pixel_format;
+    picture->width = width;
+    picture->height = height;
+    av_image_fill_arrays(
+        picture->data, picture->linesize, picture->buf[0]->data,
+        pixel_format, picture->width, picture->height, 1);
+
     return picture;
 }
 
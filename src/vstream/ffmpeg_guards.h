@@ -13,20 +13,30 @@ typedef std::shared_ptr<AVFormatContext> FormatContextPtr;
 typedef std::shared_ptr<AVFrame> AVFramePtr;
 typedef std::shared_ptr<AVCodecContext> AVCodecContextPtr;
 typedef std::shared_ptr<SwsContext> SwsContextPtr;
-typedef std::shared_ptr<AVPicture> AVPicturePtr;
+typedef std::shared_ptr<AVBufferPool> AVBufferPoolPtr;
 
 AVCodecContextPtr allocate_codec_context(AVCodec *codec);
 FormatContextPtr allocate_format_context(AVFormatContext *ctx=NULL);
 
 AVFramePtr allocate_frame(bool free_image_data=false);
+// a new reference to the buffers of frame
+AVFramePtr reference_frame(const AVFrame *frame);
 AVFramePtr allocate_picture(enum AVPixelFormat pixel_format, int width, int height);
 SwsContextPtr allocate_sws_ycbcr_context(int width, int height);
 SwsContextPtr allocate_sws_yuvj_context(int width, int height);
 
-SwsContextPtr allocate_sws_rgb_context(const AVFrame* source_frame);
-AVPicturePtr allocate_rgb_picture(const AVFrame *source_frame);
-SwsContextPtr allocate_sws_gray_context(const AVFrame* source_frame);
-AVPicturePtr allocate_gray_picture(const AVFrame *source_frame);
+// rgb24 conversion of width x height pixels (the whole frame or a part of it)
+SwsContextPtr allocate_sws_rgb_context(enum AVPixelFormat source_format, int width, int height);
+// gray8 conversion of width x height pixels, one byte by pixel
+SwsContextPtr allocate_sws_gray_context(enum AVPixelFormat source_format, int width, int height);
+// rgb24 conversion that resizes the frame to width x height
+SwsContextPtr allocate_sws_scaled_rgb_context(const AVFrame* source_frame, int width, int height);
+
+// pool of buffers for pictures of width x height (rgb24 or gray8)
+AVBufferPoolPtr allocate_picture_pool(int width, int height, enum AVPixelFormat pixel_format=AV_PIX_FMT_RGB24);
+// picture (packed rows) with its data taken from the pool. it's returned to the pool when the last reference is freed
+AVFramePtr allocate_pooled_picture(
+    AVBufferPool *pool, int width, int height, enum AVPixelFormat pixel_format=AV_PIX_FMT_RGB24);
 
 }  // namespace vs
 
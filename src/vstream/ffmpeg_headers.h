@@ -18,6 +18,7 @@ extern "C" {
 #include <libavutil/samplefmt.h>
 #include <libavutil/avassert.h>
 #include <libavutil/time.h>
+#include <libavutil/cpu.h>
 #include <libavformat/avformat.h>
 #include <libavdevice/avdevice.h>
 #include <libswscale/swscale.h>
@@ -1,12 +1,35 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <algorithm>
 #include "src/vstream/video_stream.h"
 #include "src/vstream/ffmpeg_stream.h"
 
 
 namespace vs {
 
+namespace {
+
+const int kAREA_STEP = 32;       // granularity of the converted areas
+const int kMIN_BAND_ROWS = 64;   // smaller bands are not worth a thread
+
+bool contains_area(const frame_area_t& outer, const frame_area_t& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+        inner.x + inner.w <= outer.x + outer.w &&
+        inner.y + inner.h <= outer.y + outer.h;
+}
+
+frame_area_t bounding_area(const frame_area_t& a, const frame_area_t& b) {
+    frame_area_t result;
+    result.x = std::min(a.x, b.x);
+    result.y = std::min(a.y, b.y);
+    result.w = std::max(a.x + a.w, b.x + b.w) - result.x;
+    result.h = std::max(a.y + a.h, b.y + b.h) - result.y;
+    return result;
+}
+
+}  // namespace
+
 FFMpegStream::FFMpegStream(int color_type) {
     color_type_ = color_type;
     init();
@@ -21,6 +44,12 @@ void FFMpegStream::init() {
     video_stream_index_ = 0;
     is_open_ = false;
     is_mjpeg_ = false;
+    draining_ = false;
+    skip_non_reference_ = false;
+    seek_generation_ = 0;
+    claimed_generation_ = -1;
+    running_generation_ = 0;
+    options_ = default_decoder_options();
     video_stream_ = NULL;
     video_codec_ = NULL;
     frame_width_ = 0;
@@ -33,6 +62,13 @@ void FFMpegStream::init() {
     frame_pts_ = 0;
     exit_ = false;
     have_new_frame_ = false;
+    have_new_scaled_ = false;
+    scaled_w_ = 0;
+    scaled_h_ = 0;
+    converted_.x = 0;
+    converted_.y = 0;
+    converted_.w = 0;
+    converted_.h = 0;
     frame_ = allocate_frame();
 }
 
@@ -40,6 +76,21 @@ FFMpegStream::~FFMpegStream() {
     cancel();
 }
 
+void FFMpegStream::index_keyframes(const char *location, const char *cache_path) {
+    keyframe_index_.reset(new KeyframeIndex(location, cache_path));
+}
+
+bool FFMpegStream::save_keyframe_index(const char *cache_path) {
+    if (keyframe_index_) {
+        return keyframe_index_->save(cache_path);
+    }
+    return false;
+}
+
+void FFMpegStream::set_decoder_options(const decoder_options_t& options) {
+    options_ = options;
+}
+
 bool FFMpegStream::cancel() {
     exit_ = true;
 }
@@ -101,6 +152,8 @@ bool FFMpegStream::init_codec() {
     frame_width_ = codec_ctx_->width;
     frame_height_ = codec_ctx_->height;
 
+    configure_threads();
+
     if (avcodec_open2(codec_ctx_.get(), video_codec_, NULL) < 0) {
       codec_ctx_.reset();
       return false;
@@ -132,83 +185,100 @@ bool FFMpegStream::init_codec() {
     return false;
 }
 
-bool FFMpegStream::next_frame(bool ignore_capture) {
-    if (!is_open_) {
-        return false;
+void FFMpegStream::configure_threads() {
+    codec_ctx_->thread_count = options_.thread_count;
+
+    if (options_.key_frames_only) {
+        codec_ctx_->skip_frame = AVDISCARD_NONKEY;
     }
 
-    if (frame_number_ + 1 == frame_count_) {
-        return false;
+    switch (options_.thread_type) {
+        case decoder_threads_frame:
+            codec_ctx_->thread_type = FF_THREAD_FRAME;
+            break;
+        case decoder_threads_slice:
+            codec_ctx_->thread_type = FF_THREAD_SLICE;
+            break;
+        case decoder_threads_none:
+            codec_ctx_->thread_count = 1;
+            break;
+        default:
+            // ffmpeg prefers frame threads when the codec supports both
+            codec_ctx_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+            break;
     }
+}
 
-    bool have_frame = false;
-    int status = 0;
+void FFMpegStream::flush_codec() {
+    avcodec_flush_buffers(codec_ctx_.get());
+    draining_ = false;
+}
 
+bool FFMpegStream::send_next_packet() {
     AVPacket packet;
     av_init_packet(&packet);
     packet.data = NULL;
     packet.size = 0;
 
-    auto pts = AV_NOPTS_VALUE;
-    auto dts = AV_NOPTS_VALUE;
-    int stream_index;
-    do {
+    for (;;) {
         if (exit_) {
             return false;
         }
-        pts = AV_NOPTS_VALUE;
-        dts = AV_NOPTS_VALUE;
 
-        int status = av_read_frame(format_ctx_.get(), &packet);
-        if (status < 0) {
-            return false;
+        if (av_read_frame(format_ctx_.get(), &packet) < 0) {
+            // the end of the file: the empty packet makes the decoder return the frames it's holding
+            // (frame threads and reordered frames)
+            draining_ = true;
+            return avcodec_send_packet(codec_ctx_.get(), NULL) >= 0;
         }
 
-        stream_index = packet.stream_index;
-
-        if (packet.stream_index != video_stream_index_) {
-            av_packet_unref(&packet);
-            av_init_packet(&packet);
-            packet.data = NULL;
-            packet.size = 0;
-            continue;
+        // the other packets would be discarded by the codec anyway
+        if (packet.stream_index == video_stream_index_ &&
+            (!options_.key_frames_only || (packet.flags & AV_PKT_FLAG_KEY))) {
+            break;
         }
 
-        pts = packet.pts;
-        dts = packet.dts;
+        av_packet_unref(&packet);
+    }
 
-        status = avcodec_send_packet(codec_ctx_.get(), &packet);
+    int status = avcodec_send_packet(codec_ctx_.get(), &packet);
+    av_packet_unref(&packet);
 
-        av_packet_unref(&packet);
-        av_init_packet(&packet);
-        packet.data = NULL;
-        packet.size = 0;
+    return status >= 0;
+}
 
-        if (status == AVERROR(EAGAIN)) {
-            continue;
+bool FFMpegStream::next_frame(bool ignore_capture) {
+    if (!is_open_) {
+        return false;
+    }
+
+    if (frame_number_ + 1 == frame_count_) {
+        return false;
+    }
+
+    // the frames are received before sending more packets, so avcodec_send_packet never returns EAGAIN
+    for (;;) {
+        if (exit_) {
+            return false;
         }
 
-         if (status == AVERROR_EOF) {
+        int status = avcodec_receive_frame(codec_ctx_.get(), frame_.get());
+        if (status == 0) {
             break;
         }
 
-        if (status < 0) {
+        // AVERROR_EOF: the decoder has returned all the frames
+        if (status != AVERROR(EAGAIN) || draining_) {
             return false;
         }
 
-        while (!have_frame) {
-            status = avcodec_receive_frame(codec_ctx_.get(), frame_.get());
-            if (status == AVERROR(EAGAIN) || status == AVERROR_EOF) {
-                break;
-            } else if (status < 0) {
-                return false;
-            }
-            have_frame = true;
+        if (!send_next_packet()) {
+            return false;
         }
-
-    } while (stream_index != video_stream_index_ || have_frame == false);
+    }
 
     have_new_frame_ = true;
+    have_new_scaled_ = true;
     frame_count_ = video_stream_->nb_frames;
 
     if (frame_count_ == 0) {
@@ -219,10 +289,17 @@ bool FFMpegStream::next_frame(bool ignore_capture) {
         frame_count_ = (int64_t)floor(duration * fps_ + 0.5);
     }
 
-    frame_pts_ =  pts != static_cast<int64_t>(AV_NOPTS_VALUE) && pts ? pts : dts;
+    // the timestamps of the frame: frame threads and reordering delay it from the packet that was just sent
+    int64_t pts = frame_->best_effort_timestamp;
+    frame_pts_ =  pts != static_cast<int64_t>(AV_NOPTS_VALUE) && pts ? pts : frame_->pkt_dts;
 
-    // frame_number_ = get_frame_from_pts() - first_frame_;
-    ++frame_number_;
+    if ((options_.key_frames_only || skip_non_reference_) && frame_number_ > 0) {
+        // the codec skipped frames, only the timestamp tells the number
+        frame_number_ = get_frame_from_pts() - first_frame_ + 1;
+    } else {
+        // frame_number_ = get_frame_from_pts() - first_frame_;
+        ++frame_number_;
+    }
 
     return true;
 }
@@ -232,63 +309,386 @@ unsigned char **FFMpegStream::get_picture() {
         return NULL;
     }
 
-    if (!picture_) {
-        have_new_frame_ = true;
-        if (color_type_ == video_color_rgb) {
-            picture_ = allocate_rgb_picture(frame_.get());
-        } else if (color_type_ == video_color_gray) {
-            picture_ = allocate_gray_picture(frame_.get());
-        }
+    frame_area_t area = {0, 0, frame_->width, frame_->height};
+    return get_picture(area);
+}
+
+unsigned char **FFMpegStream::get_picture(const frame_area_t& area) {
+    if (!codec_ctx_) {
+        return NULL;
     }
 
-    if (!sws_ctx_) {
-        if (color_type_ == video_color_rgb) {
-            sws_ctx_ = allocate_sws_rgb_context(frame_.get());
-        } else if (color_type_ == video_color_gray) {
-            sws_ctx_ = allocate_sws_gray_context(frame_.get());
-        }
+    if (color_type_ != video_color_rgb && color_type_ != video_color_gray) {
+        return frame_->data;
+    }
+
+    if (frame_->width < 1 || frame_->height < 1) {
+        return NULL;
     }
 
-    if (have_new_frame_ && picture_) {
+    if (have_new_frame_) {
         have_new_frame_ = false;
-        sws_scale(
-            sws_ctx_.get(),
-            frame_->data,
-            frame_->linesize,
-            0,
-            frame_->height,
-            picture_->data,
-            picture_->linesize);
+        converted_.w = 0;
+        converted_.h = 0;
     }
 
-    if (!picture_) {
-        return frame_->data;
+    frame_area_t target = align_area(area);
+    if (picture_ && contains_area(converted_, target)) {
+        return picture_->data;
+    }
+
+    if (converted_.w && converted_.h) {
+        // keep the pixels converted before (a new picture from the pool needs them again)
+        target = align_area(bounding_area(converted_, target));
+    }
+
+    // a picture referenced by a frame handle is never written again, the next one comes from the pool
+    if (!picture_ || !av_frame_is_writable(picture_.get())) {
+        if (!picture_pool_) {
+            picture_pool_ = allocate_picture_pool(frame_->width, frame_->height, picture_format());
+        }
+        picture_ = allocate_pooled_picture(picture_pool_.get(), frame_->width, frame_->height, picture_format());
+        if (!picture_) {
+            return NULL;
+        }
+    }
+
+    converted_.w = 0;
+    converted_.h = 0;
+    if (!convert_area(target)) {
+        return NULL;
     }
 
+    converted_ = target;
+
     return picture_->data;
 }
 
+AVPixelFormat FFMpegStream::picture_format() {
+    return color_type_ == video_color_gray ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_RGB24;
+}
+
+bool FFMpegStream::can_split_picture() {
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame_->format));
+    return desc && !(desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL));
+}
+
+frame_area_t FFMpegStream::align_area(const frame_area_t& area) {
+    frame_area_t result = {0, 0, frame_->width, frame_->height};
+    if (!can_split_picture()) {
+        return result;
+    }
+
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame_->format));
+    int align_x = 1 << desc->log2_chroma_w;
+    int align_y = 1 << desc->log2_chroma_h;
+
+    int left = std::max(0, area.x) / align_x * align_x;
+    int top = std::max(0, area.y) / align_y * align_y;
+    int right = std::min(frame_->width, area.x + area.w);
+    int bottom = std::min(frame_->height, area.y + area.h);
+    if (right <= left || bottom <= top) {
+        return result;
+    }
+
+    // the sizes are rounded up to reuse the contexts. the simd converters write the rows in
+    // blocks of 8 pixels, so the area moves back instead of being cut at the right border
+    int w = (right - left + kAREA_STEP - 1) / kAREA_STEP * kAREA_STEP;
+    int h = (bottom - top + kAREA_STEP - 1) / kAREA_STEP * kAREA_STEP;
+
+    int x = std::min(left, (frame_->width - w) / align_x * align_x);
+    if (w < frame_->width && x + w >= right) {
+        result.x = x;
+        result.w = w;
+    }
+
+    int y = std::min(top, (frame_->height - h) / align_y * align_y);
+    if (h < frame_->height && y + h >= bottom) {
+        result.y = y;
+        result.h = h;
+    }
+
+    return result;
+}
+
+bool FFMpegStream::convert_area(const frame_area_t& area) {
+    AVPixelFormat format = static_cast<AVPixelFormat>(frame_->format);
+    int threads = options_.convert_threads > 0 ? options_.convert_threads : av_cpu_count();
+    int bands = 1;
+
+    if (can_split_picture()) {
+        bands = std::max(1, std::min(threads, area.h / kMIN_BAND_ROWS));
+    }
+
+    // the chroma rows of a band must start at a luma row multiple of the subsampling
+    int align_y = 1 << av_pix_fmt_desc_get(format)->log2_chroma_h;
+    int band_h = ((area.h + bands - 1) / bands + align_y - 1) / align_y * align_y;
+    bands = (area.h + band_h - 1) / band_h;
+
+    if (static_cast<int>(sws_bands_.size()) < bands) {
+        sws_bands_.resize(bands);
+    }
+
+    // the contexts are created before the threads start, sws_getContext is not reentrant
+    for (int i = 0; i < bands; ++i) {
+        int h = std::min(band_h, area.h - i * band_h);
+        sws_band_t & band = sws_bands_[i];
+        if (!band.ctx || band.w != area.w || band.h != h) {
+            if (color_type_ == video_color_gray) {
+                band.ctx = allocate_sws_gray_context(format, area.w, h);
+            } else {
+                band.ctx = allocate_sws_rgb_context(format, area.w, h);
+            }
+            band.w = area.w;
+            band.h = h;
+        }
+        if (!band.ctx) {
+            return false;
+        }
+    }
+
+    if (bands > 1 && !slice_workers_) {
+        slice_workers_.reset(new SliceWorkers(threads - 1));
+    }
+
+    slice_cb_t convert = [this, &area, band_h] (int band) {
+        convert_band(band, area, area.y + band * band_h);
+    };
+
+    if (slice_workers_) {
+        slice_workers_->run(bands, convert);
+    } else {
+        convert(0);
+    }
+
+    return true;
+}
+
+void FFMpegStream::convert_band(int band, const frame_area_t& area, int y) {
+    AVPixelFormat format = static_cast<AVPixelFormat>(frame_->format);
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(format);
+    int planes = av_pix_fmt_count_planes(format);
+
+    const uint8_t *source[4];
+    for (int p = 0; p < 4; ++p) {
+        source[p] = frame_->data[p];
+        if (p < planes && source[p]) {
+            int shift_y = p == 1 || p == 2 ? desc->log2_chroma_h : 0;
+            source[p] += (y >> shift_y) * frame_->linesize[p] + av_image_get_linesize(format, area.x, p);
+        }
+    }
+
+    // three bytes by pixel in rgb24, one in gray8
+    int target_x = av_image_get_linesize(picture_format(), area.x, 0);
+    uint8_t *target[4] = {picture_->data[0] + y * picture_->linesize[0] + target_x, NULL, NULL, NULL};
+    int target_linesize[4] = {picture_->linesize[0], 0, 0, 0};
+
+    sws_scale(
+        sws_bands_[band].ctx.get(),
+        source,
+        frame_->linesize,
+        0,
+        sws_bands_[band].h,
+        target,
+        target_linesize);
+}
+
+AVFramePtr FFMpegStream::get_picture_ref() {
+    if (!get_picture() || !picture_) {
+        return AVFramePtr();
+    }
+    return reference_frame(picture_.get());
+}
+
+AVFramePtr FFMpegStream::get_picture_ref(const frame_area_t& area) {
+    if (!get_picture(area) || !picture_) {
+        return AVFramePtr();
+    }
+    return reference_frame(picture_.get());
+}
+
+AVFramePtr FFMpegStream::get_scaled_picture_ref(int width, int height) {
+    if (!codec_ctx_ || frame_->width < 1 || frame_->height < 1 || width < 1 || height < 1) {
+        return AVFramePtr();
+    }
+
+    if (width != scaled_w_ || height != scaled_h_) {
+        // the pictures of the former size are freed when their handles are released
+        scaled_ctx_ = allocate_sws_scaled_rgb_context(frame_.get(), width, height);
+        scaled_pool_ = allocate_picture_pool(width, height);
+        scaled_picture_.reset();
+        scaled_w_ = width;
+        scaled_h_ = height;
+    }
+
+    if (!scaled_ctx_ || !scaled_pool_) {
+        return AVFramePtr();
+    }
+
+    if (scaled_picture_ && !have_new_scaled_) {
+        return reference_frame(scaled_picture_.get());
+    }
+
+    if (!scaled_picture_ || !av_frame_is_writable(scaled_picture_.get())) {
+        scaled_picture_ = allocate_pooled_picture(scaled_pool_.get(), width, height);
+        if (!scaled_picture_) {
+            return AVFramePtr();
+        }
+    }
+
+    sws_scale(
+        scaled_ctx_.get(),
+        frame_->data,
+        frame_->linesize,
+        0,
+        frame_->height,
+        scaled_picture_->data,
+        scaled_picture_->linesize);
+
+    have_new_scaled_ = false;
+
+    return reference_frame(scaled_picture_.get());
+}
+
+AVFramePtr FFMpegStream::get_frame_ref() {
+    if (!codec_ctx_ || !frame_->buf[0]) {
+        return AVFramePtr();
+    }
+    return reference_frame(frame_.get());
+}
+
+bool FFMpegStream::get_yuv_planes(yuv_planes_t *planes) {
+    if (!codec_ctx_ || frame_->format != AV_PIX_FMT_YUV420P) {
+        return false;
+    }
+
+    // the encoders take limited range, the full range planes would lose contrast
+    if (frame_->color_range == AVCOL_RANGE_JPEG) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        planes->data[i] = frame_->data[i];
+        planes->linesize[i] = frame_->linesize[i];
+    }
+
+    return true;
+}
+
 double FFMpegStream::get_frame_time() {
   return static_cast<double>(frame_pts_ - video_stream_->start_time) * r2d(video_stream_->time_base);
 }
 
 int64_t FFMpegStream::get_frame_from_pts() {
-  double sec = get_frame_time();
+  return pts_to_frame(frame_pts_);
+}
+
+int64_t FFMpegStream::pts_to_frame(int64_t pts) {
+  double sec = static_cast<double>(pts - video_stream_->start_time) * r2d(video_stream_->time_base);
   return (int64_t)(fps_ * sec + 0.5);
 }
 
+bool FFMpegStream::find_keyframe(int64_t frame, keyframe_t *keyframe) {
+    if (!keyframe_index_) {
+        return false;
+    }
+
+    std::shared_ptr<const keyframe_list_t> keyframes = keyframe_index_->keyframes();
+    if (!keyframes || keyframes->empty()) {
+        return false;
+    }
+
+    auto it = std::upper_bound(keyframes->begin(), keyframes->end(), frame - 1, [this] (int64_t value, const keyframe_t& keyframe) {
+        return value < pts_to_frame(keyframe.pts) - first_frame_;
+    });
+
+    if (it == keyframes->begin()) {
+        return false;
+    }
+
+    *keyframe = *(--it);
+
+    return true;
+}
+
+int64_t FFMpegStream::keyframe_number(int64_t frame) {
+    keyframe_t keyframe;
+    if (find_keyframe(frame, &keyframe)) {
+        return pts_to_frame(keyframe.pts) - first_frame_ + 1;
+    }
+    return 0;
+}
+
+bool FFMpegStream::seek_keyframe(int64_t frame) {
+    keyframe_t keyframe;
+    if (!find_keyframe(frame, &keyframe)) {
+        return false;
+    }
+
+    // frame numbers start at 1, the frame indexes at 0
+    int64_t target = frame - 1;
+    int64_t current = frame_number_ - 1;
+    if (current < pts_to_frame(keyframe.pts) - first_frame_ || current >= target) {
+        // the target is not ahead in the current group of pictures
+        av_seek_frame(format_ctx_.get(), video_stream_index_, keyframe.pts, AVSEEK_FLAG_BACKWARD);
+        flush_codec();
+
+        if (!next_frame()) {
+            return false;
+        }
+
+        frame_number_ = get_frame_from_pts() - first_frame_;
+        if (frame_number_ < 0 || frame_number_ > target) {
+            return false;
+        }
+    } else {
+        frame_number_ = current;
+    }
+
+    while (frame_number_ < target) {
+        if (seek_interrupted() || !next_frame()) {
+            break;
+        }
+    }
+
+    frame_number_++;
+
+    return true;
+}
+
 void FFMpegStream::seek_frame(int64_t frame) {
+    if (!frame_) {
+        return;
+    }
+
+    // the seek counts the frames it decodes up to the target, the codec must not discard any of them
+    bool skip_non_reference = skip_non_reference_;
+    if (skip_non_reference) {
+        set_skip_non_reference(false);
+    }
+
+    decode_to_frame(frame);
+
+    if (skip_non_reference) {
+        set_skip_non_reference(true);
+    }
+}
+
+void FFMpegStream::decode_to_frame(int64_t frame) {
     int64_t frame2seek = frame;
     if (frame2seek > frame_count_) {
       frame2seek = frame_count_;
     }
 
-    frame_number_  = 0;
+    int64_t claimed = claimed_generation_.load();
+    running_generation_ = claimed >= 0 ? static_cast<uint32_t>(claimed) : seek_generation_.load();
 
-    if (!frame_) {
+    if (frame2seek > 1 && seek_keyframe(frame2seek)) {
         return;
     }
 
+    frame_number_  = 0;
+
     int delta = 16;
 
     for(;;) {
@@ -299,7 +699,7 @@ void FFMpegStream::seek_frame(int64_t frame) {
       time_stamp += (int64_t)(sec / time_base + 0.5);
 
       av_seek_frame(format_ctx_.get(), video_stream_index_, time_stamp, AVSEEK_FLAG_BACKWARD);
-      avcodec_flush_buffers(codec_ctx_.get());
+      flush_codec();
 
       if( frame2seek > 0 ) {
         next_frame();
@@ -314,8 +714,13 @@ void FFMpegStream::seek_frame(int64_t frame) {
                   delta = delta < 16 ? delta*2 : delta*3/2;
                   continue;
               }
+              if (options_.key_frames_only) {
+                  // the codec returns only the key frames, the seek stops at the one before the target
+                  frame_number_++;
+                  break;
+              }
               while( frame_number_ < frame2seek - 1 ) {
-                if (!next_frame())
+                if (seek_interrupted() || !next_frame())
                   break;
               }
               frame_number_++;
@@ -339,6 +744,75 @@ void FFMpegStream::seek_frame(int64_t frame) {
   }
 }
 
+void FFMpegStream::seek_nearest_keyframe(int64_t frame) {
+    if (!frame_) {
+        return;
+    }
+
+    if (frame > frame_count_) {
+        frame = frame_count_;
+    }
+    if (frame < 1) {
+        frame = 1;
+    }
+
+    int64_t time_stamp = 0;
+    keyframe_t keyframe;
+    if (find_keyframe(frame, &keyframe)) {
+        // already there
+        if (frame_number_ == pts_to_frame(keyframe.pts) - first_frame_ + 1) {
+            return;
+        }
+        time_stamp = keyframe.pts;
+    } else if (fps_ <= 0) {
+        seek_frame(frame);
+        return;
+    } else {
+        time_stamp = video_stream_->start_time + (int64_t)(((frame - 1) / fps_) / r2d(video_stream_->time_base) + 0.5);
+    }
+
+    av_seek_frame(format_ctx_.get(), video_stream_index_, time_stamp, AVSEEK_FLAG_BACKWARD);
+    flush_codec();
+
+    if (!next_frame()) {
+        seek_frame(frame);
+        return;
+    }
+
+    // the demuxer may land on a key frame after the time when it has no index
+    frame_number_ = std::max(get_frame_from_pts() - first_frame_ + 1, (int64_t)1);
+}
+
+void FFMpegStream::interrupt_seek() {
+    ++seek_generation_;
+}
+
+uint32_t FFMpegStream::seek_generation() {
+    return seek_generation_.load();
+}
+
+void FFMpegStream::claim_seek_generation(uint32_t generation) {
+    claimed_generation_ = generation;
+}
+
+bool FFMpegStream::seek_interrupted() {
+    return seek_generation_.load() != running_generation_;
+}
+
+void FFMpegStream::set_convert_threads(int count) {
+    options_.convert_threads = count;
+    // the workers are created again with the new count
+    slice_workers_.reset();
+}
+
+void FFMpegStream::set_skip_non_reference(bool skip) {
+    skip_non_reference_ = skip;
+    // the key frames only decoders discard more already
+    if (codec_ctx_ && !options_.key_frames_only) {
+        codec_ctx_->skip_frame = skip ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+    }
+}
+
 int64_t FFMpegStream::time_to_frame(int64_t time_value) {
     return (int64_t)((time_value / 1000.0f) * fps_ + 0.5);
 }
@@ -352,7 +826,7 @@ void FFMpegStream::seek_time(int64_t time) {
         frame_number_ = 0;
         av_seek_frame(format_ctx_.get(), video_stream_index_, 0, AVSEEK_FLAG_BACKWARD);
         // avformat_seek_file(format_ctx_.get(), video_stream_index_, 0, 0, 0, 0);
-        avcodec_flush_buffers(codec_ctx_.get());
+        flush_codec();
         return;
     }
 
@@ -434,6 +908,26 @@ int FFMpegStream::get_stream_color_format() {
     return 0;
 }
 
+decoder_thread_type FFMpegStream::get_thread_type() {
+    if (!codec_ctx_) {
+        return decoder_threads_none;
+    }
+    if (codec_ctx_->active_thread_type & FF_THREAD_FRAME) {
+        return decoder_threads_frame;
+    }
+    if (codec_ctx_->active_thread_type & FF_THREAD_SLICE) {
+        return decoder_threads_slice;
+    }
+    return decoder_threads_none;
+}
+
+int FFMpegStream::get_thread_count() {
+    if (codec_ctx_ && codec_ctx_->active_thread_type) {
+        return codec_ctx_->thread_count;
+    }
+    return 1;
+}
+
 bool FFMpegStream::is_key_frame() {
     if (frame_) {
         return frame_->key_frame != 0;
@@ -5,10 +5,15 @@
 #define SRC_VSTREAM_FFMPEG_STREAM_H_
 
 #include <inttypes.h>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 #include "src/vstream/ffmpeg_headers.h"
 #include "src/vstream/ffmpeg_guards.h"
+#include "src/vstream/keyframe_index.h"
+#include "src/vstream/slice_workers.h"
+#include "src/vstream/video_stream.h"
 
 namespace vs {
 
@@ -17,14 +22,40 @@ class FFMpegStream {
     FFMpegStream(int color_type);
     FFMpegStream();
     virtual ~FFMpegStream();
+    // call it before open()
+    void set_decoder_options(const decoder_options_t& options);
     bool open(const char *location);
+    void index_keyframes(const char *location, const char *cache_path);
+    bool save_keyframe_index(const char *cache_path);
+    // number of the last key frame before or at frame (0 when the keyframe index is not ready)
+    int64_t keyframe_number(int64_t frame);
+    // rgb24 pictures, gray8 for video_color_gray (the scaled pictures are always rgb24)
     unsigned char **get_picture();
+    // converts only the area (aligned to the chroma and rounded up). the other pixels are not defined
+    unsigned char **get_picture(const frame_area_t& area);
+    // references to the converted picture and to the decoded frame (empty when there is none)
+    AVFramePtr get_picture_ref();
+    AVFramePtr get_picture_ref(const frame_area_t& area);
+    // the frame resized to width x height by the color conversion
+    AVFramePtr get_scaled_picture_ref(int width, int height);
+    AVFramePtr get_frame_ref();
+    bool get_yuv_planes(yuv_planes_t *planes);
     unsigned int get_picture_buffer_size();
     bool is_mjpeg();
     bool next_frame(bool ignore_capture = false);
     bool init_codec();
     void seek_time(int64_t time);
+    // the key frames only streams stop at the key frame before frame
     void seek_frame(int64_t frame);
+    // decodes only the key frame at or before frame (the one the demuxer finds while the keyframe index is not ready)
+    void seek_nearest_keyframe(int64_t frame);
+    // thread safe. the seek_frame() in progress stops at the frame it reached (see vs::Decoder)
+    void interrupt_seek();
+    uint32_t seek_generation();
+    void claim_seek_generation(uint32_t generation);
+    // the codec discards the frames no other frame depends on, next_frame() numbers the frames by the timestamps
+    void set_skip_non_reference(bool skip);
+    void set_convert_threads(int count);
     int get_width();
     int get_height();
     double get_fps();
@@ -42,16 +73,43 @@ class FFMpegStream {
     int get_color_type();
     int get_stream_color_format();
     bool is_key_frame();
+    decoder_thread_type get_thread_type();
+    int get_thread_count();
     bool cancel();
  private:
+    typedef struct {
+        SwsContextPtr ctx;
+        int w;
+        int h;
+    } sws_band_t;
+
     void init();
+    void configure_threads();
+    bool send_next_packet();
+    void flush_codec();
     int64_t get_frame_from_pts();
+    int64_t pts_to_frame(int64_t pts);
+    bool find_keyframe(int64_t frame, keyframe_t *keyframe);
+    bool seek_interrupted();
+    bool seek_keyframe(int64_t frame);
+    void decode_to_frame(int64_t frame);
+    AVPixelFormat picture_format();
+    bool can_split_picture();
+    frame_area_t align_area(const frame_area_t& area);
+    bool convert_area(const frame_area_t& area);
+    void convert_band(int band, const frame_area_t& area, int y);
 
  protected:
     bool exit_;
     bool is_open_;
     bool have_new_frame_;
+    bool have_new_scaled_;
     bool is_mjpeg_;
+    bool draining_;  // the end of the file was reached, the decoder is returning its delayed frames
+    bool skip_non_reference_;
+    std::atomic<uint32_t> seek_generation_;  // the interrupt_seek() calls
+    std::atomic<int64_t> claimed_generation_;  // -1 when no generation was claimed
+    uint32_t running_generation_;  // the generation of the seek_frame() in progress
     int video_stream_index_;
     int frame_width_;
     int frame_height_;
@@ -62,14 +120,24 @@ class FFMpegStream {
     double duration_;
     double fps_;
     int color_type_;
+    decoder_options_t options_;
     AVStream *video_stream_;
     AVCodec *video_codec_;
     AVCodecContextPtr codec_ctx_;
-    SwsContextPtr sws_ctx_;
+    std::vector<sws_band_t> sws_bands_;  // one conversion context by band of the picture
+    std::unique_ptr<SliceWorkers> slice_workers_;
+    frame_area_t converted_;  // the area of picture_ converted from the current frame
+    SwsContextPtr scaled_ctx_;
+    AVBufferPoolPtr scaled_pool_;
+    AVFramePtr scaled_picture_;
+    int scaled_w_;
+    int scaled_h_;
     AVFramePtr frame_;
-    AVPicturePtr picture_;
+    AVBufferPoolPtr picture_pool_;
+    AVFramePtr picture_;
     std::vector<uint8_t> video_extra_data_;
     FormatContextPtr format_ctx_;
+    std::unique_ptr<KeyframeIndex> keyframe_index_;
 };
 
 }  // namespace vs
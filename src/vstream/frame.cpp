@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/vstream/frame.h"
+
+namespace vs {
+
+namespace {
+
+const int kMAX_PLANES = 3;
+
+}  // namespace
+
+FrameImp::FrameImp(AVFramePtr frame, uint32_t position, int64_t pts, double time, bool key_frame) {
+    frame_ = frame;
+    position_ = position;
+    pts_ = pts;
+    time_ = time;
+    key_frame_ = key_frame;
+}
+
+uint32_t FrameImp::w() const {
+    return frame_->width;
+}
+
+uint32_t FrameImp::h() const {
+    return frame_->height;
+}
+
+pixel_format FrameImp::format() const {
+    switch (frame_->format) {
+        case AV_PIX_FMT_RGB24:
+            return pixel_format_rgb24;
+        case AV_PIX_FMT_YUV420P:
+            return pixel_format_yuv420p;
+        default:
+            return pixel_format_other;
+    }
+}
+
+const unsigned char *FrameImp::data(int plane) const {
+    if (plane < 0 || plane >= kMAX_PLANES) {
+        return NULL;
+    }
+    return frame_->data[plane];
+}
+
+int FrameImp::stride(int plane) const {
+    if (plane < 0 || plane >= kMAX_PLANES) {
+        return 0;
+    }
+    return frame_->linesize[plane];
+}
+
+uint32_t FrameImp::position() const {
+    return position_;
+}
+
+int64_t FrameImp::pts() const {
+    return pts_;
+}
+
+double FrameImp::time() const {
+    return time_;
+}
+
+bool FrameImp::key_frame() const {
+    return key_frame_;
+}
+
+}  // namespace vs
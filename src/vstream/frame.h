@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VSTREAM_FRAME_H_
+#define SRC_VSTREAM_FRAME_H_
+
+#include <inttypes.h>
+#include "src/vstream/video_stream.h"
+#include "src/vstream/ffmpeg_guards.h"
+
+namespace vs {
+
+// holds a reference to the buffers of an AVFrame
+class FrameImp: public Frame {
+    FrameImp(const FrameImp&) = delete;
+    FrameImp& operator=(const FrameImp&) = delete;
+ public:
+    FrameImp(AVFramePtr frame, uint32_t position, int64_t pts, double time, bool key_frame);
+    virtual ~FrameImp() {}
+    uint32_t w() const override;
+    uint32_t h() const override;
+    pixel_format format() const override;
+    const unsigned char *data(int plane=0) const override;
+    int stride(int plane=0) const override;
+    uint32_t position() const override;
+    int64_t pts() const override;
+    double time() const override;
+    bool key_frame() const override;
+ private:
+    AVFramePtr frame_;
+    uint32_t position_;
+    int64_t pts_;
+    double time_;
+    bool key_frame_;
+};
+
+}  // namespace vs
+
+#endif  // SRC_VSTREAM_FRAME_H_
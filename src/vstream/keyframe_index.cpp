@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include "src/vstream/ffmpeg_guards.h"
+#include "src/vstream/keyframe_index.h"
+
+namespace vs {
+
+namespace {
+
+const char kINDEX_MAGIC[4] = {'V', 'C', 'K', 'I'};
+const uint32_t kINDEX_VERSION = 1;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    int64_t video_size;
+    int64_t video_time;
+    uint64_t count;
+} index_header_t;
+
+std::shared_ptr<FILE> open_index_file(const char *path, const char *mode) {
+    FILE *fp = fopen(path, mode);
+    if (!fp) {
+        return std::shared_ptr<FILE>();
+    }
+    return std::shared_ptr<FILE>(fp, [] (FILE *fp) {
+        fclose(fp);
+    });
+}
+
+}  // namespace
+
+KeyframeIndex::KeyframeIndex(const char *video_path, const char *cache_path) : canceled_(false) {
+    video_path_ = video_path;
+    cache_path_ = cache_path ? cache_path : "";
+
+    boost::system::error_code ec;
+    video_size_ = boost::filesystem::file_size(video_path_, ec);
+    if (ec) {
+        video_size_ = 0;
+    }
+
+    video_time_ = boost::filesystem::last_write_time(video_path_, ec);
+    if (ec) {
+        video_time_ = 0;
+    }
+
+    if (!cache_path_.empty() && load(cache_path_.c_str())) {
+        return;
+    }
+
+    thread_.reset(new boost::thread([this] () {
+        build();
+    }));
+}
+
+KeyframeIndex::~KeyframeIndex() {
+    canceled_ = true;
+    wait();
+}
+
+void KeyframeIndex::wait() {
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+std::shared_ptr<const keyframe_list_t> KeyframeIndex::keyframes() {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    return keyframes_;
+}
+
+void KeyframeIndex::set_keyframes(std::shared_ptr<const keyframe_list_t> keyframes) {
+    boost::lock_guard<boost::mutex> lock(mtx_);
+    keyframes_ = keyframes;
+}
+
+void KeyframeIndex::build() {
+    AVFormatContext *ctx = NULL;
+
+    if (avformat_open_input(&ctx, video_path_.c_str(), NULL, NULL) != 0) {
+        return;
+    }
+
+    FormatContextPtr format_ctx = allocate_format_context(ctx);
+
+    if (avformat_find_stream_info(ctx, NULL) < 0) {
+        return;
+    }
+
+    int stream_index = av_find_best_stream(ctx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (stream_index < 0) {
+        return;
+    }
+
+    // let the demuxer skip the packets of the other streams
+    for (unsigned int i = 0; i < ctx->nb_streams; ++i) {
+        if (static_cast<int>(i) != stream_index) {
+            ctx->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    std::shared_ptr<keyframe_list_t> keyframes(new keyframe_list_t());
+    int64_t frame = 0;
+
+    AVPacket packet;
+    av_init_packet(&packet);
+    packet.data = NULL;
+    packet.size = 0;
+
+    while (!canceled_ && av_read_frame(ctx, &packet) >= 0) {
+        if (packet.stream_index == stream_index) {
+            if (packet.flags & AV_PKT_FLAG_KEY) {
+                keyframe_t keyframe;
+                keyframe.pts = packet.pts != static_cast<int64_t>(AV_NOPTS_VALUE) ? packet.pts : packet.dts;
+                keyframe.position = packet.pos;
+                keyframe.frame = frame;
+                keyframes->push_back(keyframe);
+            }
+            ++frame;
+        }
+        av_packet_unref(&packet);
+    }
+
+    if (canceled_) {
+        return;
+    }
+
+    std::sort(keyframes->begin(), keyframes->end(), [] (const keyframe_t& a, const keyframe_t& b) {
+        return a.pts < b.pts;
+    });
+
+    set_keyframes(keyframes);
+
+    if (!cache_path_.empty()) {
+        save(cache_path_.c_str());
+    }
+}
+
+bool KeyframeIndex::load(const char *cache_path) {
+    std::shared_ptr<FILE> fp = open_index_file(cache_path, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    index_header_t header;
+    if (fread(&header, sizeof(header), 1, fp.get()) != 1) {
+        return false;
+    }
+
+    if (memcmp(header.magic, kINDEX_MAGIC, sizeof(kINDEX_MAGIC)) != 0 ||
+        header.version != kINDEX_VERSION ||
+        header.video_size != video_size_ ||
+        header.video_time != video_time_ ||
+        header.count == 0 ||
+        header.count > static_cast<uint64_t>(video_size_)) {
+        return false;
+    }
+
+    std::shared_ptr<keyframe_list_t> keyframes(new keyframe_list_t(header.count));
+    if (fread(&(*keyframes)[0], sizeof(keyframe_t), header.count, fp.get()) != header.count) {
+        return false;
+    }
+
+    set_keyframes(keyframes);
+
+    return true;
+}
+
+bool KeyframeIndex::save(const char *cache_path) {
+    std::shared_ptr<const keyframe_list_t> keyframes = this->keyframes();
+    if (!keyframes || keyframes->empty()) {
+        return false;
+    }
+
+    // other decoders of the same video may be using the file, so it's replaced at once
+    std::string temp_path = boost::filesystem::unique_path(std::string(cache_path) + ".%%%%%%.tmp").string();
+    std::shared_ptr<FILE> fp = open_index_file(temp_path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+
+    index_header_t header;
+    memcpy(header.magic, kINDEX_MAGIC, sizeof(kINDEX_MAGIC));
+    header.version = kINDEX_VERSION;
+    header.video_size = video_size_;
+    header.video_time = video_time_;
+    header.count = keyframes->size();
+
+    bool written = fwrite(&header, sizeof(header), 1, fp.get()) == 1 &&
+        fwrite(&(*keyframes)[0], sizeof(keyframe_t), keyframes->size(), fp.get()) == keyframes->size();
+    fp.reset();
+
+    boost::system::error_code ec;
+    if (written) {
+        boost::filesystem::rename(temp_path, cache_path, ec);
+    }
+
+    if (!written || ec) {
+        boost::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace vs
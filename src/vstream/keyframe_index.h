@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VSTREAM_KEYFRAME_INDEX_H_
+#define SRC_VSTREAM_KEYFRAME_INDEX_H_
+
+#include <inttypes.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+
+namespace vs {
+
+typedef struct {
+    int64_t pts;       // presentation time stamp (stream time base)
+    int64_t position;  // byte position of the packet in the file
+    int64_t frame;     // number of video packets before this one
+} keyframe_t;
+
+typedef std::vector<keyframe_t> keyframe_list_t;
+
+/*
+ * Index of the video key frames built by a demux-only pass (no decoding) that runs in background.
+ * The index is stored in cache_path and it's loaded from there when the video did not change.
+ */
+class KeyframeIndex {
+    KeyframeIndex(const KeyframeIndex&) = delete;
+    KeyframeIndex& operator=(const KeyframeIndex&) = delete;
+ public:
+    KeyframeIndex(const char *video_path, const char *cache_path);
+    virtual ~KeyframeIndex();
+
+    // return NULL until the index is ready
+    std::shared_ptr<const keyframe_list_t> keyframes();
+
+    bool save(const char *cache_path);
+
+    // block until the background pass finishes
+    void wait();
+
+ private:
+    bool load(const char *cache_path);
+    void build();
+    void set_keyframes(std::shared_ptr<const keyframe_list_t> keyframes);
+
+ private:
+    std::string video_path_;
+    std::string cache_path_;
+    int64_t video_size_;
+    int64_t video_time_;
+    std::atomic_bool canceled_;
+    boost::mutex mtx_;
+    std::shared_ptr<const keyframe_list_t> keyframes_;
+    std::unique_ptr<boost::thread> thread_;
+};
+
+}  // namespace vs
+
+#endif  // SRC_VSTREAM_KEYFRAME_INDEX_H_
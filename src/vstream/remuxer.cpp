@@ -0,0 +1,502 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <limits>
+#include "src/vstream/encoder.h"
+#include "src/vstream/remuxer.h"
+
+namespace vs {
+
+namespace {
+
+const int64_t kLAST_FRAME = std::numeric_limits<int64_t>::max();
+
+void reset_packet(AVPacket *packet) {
+    av_packet_unref(packet);
+    av_init_packet(packet);
+    packet->data = NULL;
+    packet->size = 0;
+}
+
+}  // namespace
+
+RemuxerImp::RemuxerImp(
+    const char *codec_name,
+    const char *source_path,
+    const char *path,
+    const char *keyframe_index_path,
+    const char *title,
+    const char *author,
+    const char *tags
+) {
+    codec_name_ = codec_name;
+    source_path_ = source_path;
+    path_ = path;
+    keyframe_index_path_ = keyframe_index_path ? keyframe_index_path : "";
+    title_ = title;
+    author_ = author;
+    tags_ = tags;
+    input_stream_ = NULL;
+    output_stream_ = NULL;
+    fps_ = 0;
+    first_pts_frame_ = 0;
+    ts_offset_ = AV_NOPTS_VALUE;
+    should_close_file_ = false;
+
+    if (open_source()) {
+        load_keyframes();
+    }
+}
+
+RemuxerImp::~RemuxerImp() {
+    close_output();
+}
+
+const char* RemuxerImp::error() {
+    if (error_.length()) {
+        return error_.c_str();
+    }
+    return NULL;
+}
+
+void RemuxerImp::report_error(const char *error) {
+    error_ = error;
+}
+
+bool RemuxerImp::open_source() {
+    AVFormatContext *ctx = NULL;
+
+    if (avformat_open_input(&ctx, source_path_.c_str(), NULL, NULL) != 0) {
+        report_error("Could not open the source video");
+        return false;
+    }
+
+    input_ctx_ = allocate_format_context(ctx);
+
+    if (avformat_find_stream_info(ctx, NULL) < 0) {
+        report_error("Could not find the source video stream");
+        return false;
+    }
+
+    int stream_index = av_find_best_stream(ctx, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (stream_index < 0) {
+        report_error("Could not find the source video stream");
+        return false;
+    }
+
+    input_stream_ = ctx->streams[stream_index];
+
+    // the other streams are not copied
+    for (unsigned int i = 0; i < ctx->nb_streams; ++i) {
+        if (static_cast<int>(i) != stream_index) {
+            ctx->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    return true;
+}
+
+bool RemuxerImp::load_keyframes() {
+    KeyframeIndex index(source_path_.c_str(), keyframe_index_path_.empty() ? NULL : keyframe_index_path_.c_str());
+    index.wait();
+    keyframes_ = index.keyframes();
+    if (!keyframes_ || keyframes_->empty()) {
+        return false;
+    }
+
+    fps_ = av_q2d(input_stream_->r_frame_rate);
+    if (fps_ < 0.000025) {
+        fps_ = av_q2d(input_stream_->avg_frame_rate);
+    }
+
+    // the index is sorted by pts, the first key frame is the first one shown (frame 0)
+    first_pts_frame_ = 0;
+    first_pts_frame_ = pts_to_frame(keyframes_->front().pts);
+
+    return fps_ > 0;
+}
+
+int64_t RemuxerImp::pts_to_frame(int64_t pts) {
+    int64_t start_time = input_stream_->start_time != AV_NOPTS_VALUE ? input_stream_->start_time : 0;
+    double sec = static_cast<double>(pts - start_time) * av_q2d(input_stream_->time_base);
+    return static_cast<int64_t>(fps_ * sec + 0.5) - first_pts_frame_;
+}
+
+int64_t RemuxerImp::packet_frame(AVPacket *packet) {
+    return pts_to_frame(packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts);
+}
+
+const keyframe_t *RemuxerImp::find_keyframe(int64_t frame) {
+    for (const auto & k : *keyframes_) {
+        if (pts_to_frame(k.pts) == frame) {
+            return &k;
+        }
+    }
+    return NULL;
+}
+
+bool RemuxerImp::is_keyframe(int64_t frame) {
+    return find_keyframe(frame) != NULL;
+}
+
+int64_t RemuxerImp::keyframe_before(int64_t frame) {
+    int64_t result = -1;
+    for (const auto & k : *keyframes_) {
+        int64_t key = pts_to_frame(k.pts);
+        if (key <= frame && key > result) {
+            result = key;
+        }
+    }
+    return result;
+}
+
+int64_t RemuxerImp::keyframe_after(int64_t frame) {
+    int64_t result = kLAST_FRAME;
+    for (const auto & k : *keyframes_) {
+        int64_t key = pts_to_frame(k.pts);
+        if (key > frame && key < result) {
+            result = key;
+        }
+    }
+    return result;
+}
+
+bool RemuxerImp::can_remux(int64_t first_frame, int64_t last_frame) {
+    if (!input_stream_ || !keyframes_ || keyframes_->empty() || fps_ <= 0 || first_frame < 1) {
+        return false;
+    }
+
+    AVCodecParameters *codec_par = input_stream_->codecpar;
+
+    if (!EncoderImp::container_name(codec_name_.c_str()) ||
+        codec_par->codec_id != EncoderImp::codec_id(codec_name_.c_str())) {
+        return false;
+    }
+
+    int64_t first = first_frame - 1;
+    int64_t last = last_frame > 0 ? last_frame - 1 : kLAST_FRAME;
+
+    if (last < first || keyframe_before(first) < 0) {
+        return false;
+    }
+
+    if (!is_keyframe(first) &&
+        (codec_par->codec_id != AV_CODEC_ID_VP9 || codec_par->format != AV_PIX_FMT_YUV420P)) {
+        return false;
+    }
+
+    // the frames after the cut may be references of the last ones when the codec reorders them
+    int64_t frame_count = input_stream_->nb_frames;
+    if (codec_par->video_delay > 0 && last != kLAST_FRAME && !is_keyframe(last + 1) &&
+        (frame_count < 1 || last + 1 < frame_count)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool RemuxerImp::open_output() {
+    AVFormatContext *context = NULL;
+    avformat_alloc_output_context2(&context, NULL, EncoderImp::container_name(codec_name_.c_str()), NULL);
+
+    if (!context) {
+        report_error("Could not allocate format context");
+        return false;
+    }
+
+    output_ctx_ = allocate_format_context(context);
+
+    EncoderImp::set_metadata(output_ctx_.get(), title_.c_str(), author_.c_str(), tags_.c_str());
+
+    output_stream_ = avformat_new_stream(output_ctx_.get(), NULL);
+    if (!output_stream_) {
+        report_error("Could not allocate the video stream");
+        return false;
+    }
+
+    if (avcodec_parameters_copy(output_stream_->codecpar, input_stream_->codecpar) < 0) {
+        report_error("Could not configure media stream");
+        return false;
+    }
+
+    output_stream_->codecpar->codec_tag = 0;
+    output_stream_->time_base = input_stream_->time_base;
+
+    AVDictionary *opt = NULL;
+    if (avio_open(&output_ctx_->pb, path_.c_str(), AVIO_FLAG_WRITE) < 0) {
+        report_error("Could not open the output file");
+        return false;
+    }
+
+    should_close_file_ = true;
+
+    if (avformat_write_header(output_ctx_.get(), &opt) < 0) {
+        report_error("Could write to the output file");
+        return false;
+    }
+
+    return true;
+}
+
+void RemuxerImp::close_output() {
+    if (output_ctx_ && should_close_file_) {
+        avio_closep(&output_ctx_->pb);
+    }
+    should_close_file_ = false;
+}
+
+bool RemuxerImp::open_head_codecs() {
+    AVCodec *decoder = avcodec_find_decoder(input_stream_->codecpar->codec_id);
+    AVCodec *encoder = avcodec_find_encoder(input_stream_->codecpar->codec_id);
+
+    if (!decoder || !encoder) {
+        report_error("Could not find a supported codec");
+        return false;
+    }
+
+    decoder_ctx_ = allocate_codec_context(decoder);
+    if (!decoder_ctx_ ||
+        avcodec_parameters_to_context(decoder_ctx_.get(), input_stream_->codecpar) < 0 ||
+        avcodec_open2(decoder_ctx_.get(), decoder, NULL) < 0) {
+        report_error("Could not open the source codec");
+        return false;
+    }
+
+    int64_t bit_rate = input_stream_->codecpar->bit_rate;
+    if (bit_rate < 1) {
+        bit_rate = input_ctx_->bit_rate;
+    }
+
+    if (bit_rate < 1) {
+        bit_rate = Encoder::default_bitrate(
+            codec_name_.c_str(), decoder_ctx_->width, decoder_ctx_->height, av_q2d(input_stream_->avg_frame_rate));
+    }
+
+    encoder_ctx_ = allocate_codec_context(encoder);
+    if (!encoder_ctx_) {
+        report_error("Could not allocate a context for the codec");
+        return false;
+    }
+
+    // the packets of the encoder share the time base of the copied ones
+    encoder_ctx_->codec_id = encoder->id;
+    encoder_ctx_->width = decoder_ctx_->width;
+    encoder_ctx_->height = decoder_ctx_->height;
+    encoder_ctx_->pix_fmt = AV_PIX_FMT_YUV420P;
+    encoder_ctx_->time_base = input_stream_->time_base;
+    encoder_ctx_->bit_rate = bit_rate;
+    encoder_ctx_->bit_rate_tolerance = bit_rate * 0.05;
+
+    av_opt_set(encoder_ctx_->priv_data, "cpu-used", "1", AV_OPT_SEARCH_CHILDREN);
+
+    if (avcodec_open2(encoder_ctx_.get(), encoder, NULL) < 0) {
+        report_error("Could not open codec");
+        return false;
+    }
+
+    frame_ = allocate_frame();
+    if (!frame_) {
+        report_error("Could not allocate the frame image");
+        return false;
+    }
+
+    return true;
+}
+
+bool RemuxerImp::encode_head_frame(AVFrame *frame) {
+    // a NULL frame flushes the encoder
+    int status = avcodec_send_frame(encoder_ctx_.get(), frame);
+    if (status < 0 && status != AVERROR_EOF) {
+        report_error("Error encoding frame");
+        return false;
+    }
+
+    AVPacket packet;
+    av_init_packet(&packet);
+    packet.data = NULL;
+    packet.size = 0;
+
+    while (true) {
+        status = avcodec_receive_packet(encoder_ctx_.get(), &packet);
+        if (status == AVERROR(EAGAIN) || status == AVERROR_EOF) {
+            break;
+        } else if (status < 0) {
+            report_error("Error encoding frame");
+            return false;
+        }
+
+        bool written = write_packet(&packet);
+        reset_packet(&packet);
+        if (!written) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RemuxerImp::decode_head_packet(AVPacket *packet, int64_t first_frame, int64_t last_frame) {
+    int status = avcodec_send_packet(decoder_ctx_.get(), packet);
+    if (status < 0 && status != AVERROR_EOF) {
+        report_error("Error decoding frame");
+        return false;
+    }
+
+    while (true) {
+        status = avcodec_receive_frame(decoder_ctx_.get(), frame_.get());
+        if (status == AVERROR(EAGAIN) || status == AVERROR_EOF) {
+            break;
+        } else if (status < 0) {
+            report_error("Error decoding frame");
+            return false;
+        }
+
+        // the frames of the group of pictures before the range are decoded only to be references
+        frame_->pts = av_frame_get_best_effort_timestamp(frame_.get());
+        int64_t frame = pts_to_frame(frame_->pts);
+        if (frame >= first_frame && frame <= last_frame) {
+            frame_->pict_type = AV_PICTURE_TYPE_NONE;
+            if (!encode_head_frame(frame_.get())) {
+                return false;
+            }
+        }
+
+        av_frame_unref(frame_.get());
+    }
+
+    return true;
+}
+
+bool RemuxerImp::write_packet(AVPacket *packet) {
+    if (ts_offset_ == AV_NOPTS_VALUE) {
+        ts_offset_ = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    }
+
+    if (packet->pts != AV_NOPTS_VALUE) {
+        packet->pts -= ts_offset_;
+    }
+
+    if (packet->dts != AV_NOPTS_VALUE) {
+        packet->dts -= ts_offset_;
+    }
+
+    av_packet_rescale_ts(packet, input_stream_->time_base, output_stream_->time_base);
+    packet->stream_index = output_stream_->index;
+    packet->pos = -1;
+
+    if (av_interleaved_write_frame(output_ctx_.get(), packet) < 0) {
+        report_error("Error writing frame");
+        return false;
+    }
+
+    return true;
+}
+
+bool RemuxerImp::remux(int64_t first_frame, int64_t last_frame, remux_progress_cb_t progress_cb) {
+    if (!can_remux(first_frame, last_frame)) {
+        if (!error()) {
+            report_error("The video range can not be copied without encoding it again");
+        }
+        return false;
+    }
+
+    int64_t first = first_frame - 1;
+    int64_t last = last_frame > 0 ? last_frame - 1 : kLAST_FRAME;
+    int64_t head_first = keyframe_before(first);
+    int64_t copy_first = is_keyframe(first) ? first : keyframe_after(first);
+
+    if (!open_output()) {
+        return false;
+    }
+
+    if (copy_first != first && !open_head_codecs()) {
+        return false;
+    }
+
+    // the demuxer starts at the group of pictures of the first frame
+    const keyframe_t *head_keyframe = find_keyframe(head_first);
+    if (av_seek_frame(input_ctx_.get(), input_stream_->index, head_keyframe->pts, AVSEEK_FLAG_BACKWARD) < 0) {
+        report_error("Could not seek the source video");
+        return false;
+    }
+
+    ts_offset_ = AV_NOPTS_VALUE;
+
+    AVPacket packet;
+    av_init_packet(&packet);
+    packet.data = NULL;
+    packet.size = 0;
+
+    bool success = true;
+    bool started = false;
+    bool head_open = copy_first != first;
+    bool reorders = input_stream_->codecpar->video_delay > 0;
+    uint32_t copied_frames = 0;
+
+    while (success && av_read_frame(input_ctx_.get(), &packet) >= 0) {
+        if (packet.stream_index != input_stream_->index) {
+            reset_packet(&packet);
+            continue;
+        }
+
+        int64_t frame = packet_frame(&packet);
+        bool key = (packet.flags & AV_PKT_FLAG_KEY) != 0;
+
+        // the seek may land before the key frame
+        if (!started && !(key && frame == head_first)) {
+            reset_packet(&packet);
+            continue;
+        }
+        started = true;
+
+        // the packets come in decoding order: the range ends at the next key frame
+        if (frame > last && (key || !reorders)) {
+            reset_packet(&packet);
+            break;
+        }
+
+        if (head_open && key && frame == copy_first) {
+            // the encoded head ends where the packets start to be copied
+            head_open = false;
+            success = decode_head_packet(NULL, first, last) && encode_head_frame(NULL);
+        }
+
+        bool in_range = frame >= first && frame <= last;
+
+        if (success && head_open) {
+            success = decode_head_packet(&packet, first, last);
+        } else if (success && in_range) {
+            success = write_packet(&packet);
+        }
+
+        if (success && in_range) {
+            ++copied_frames;
+            if (!progress_cb(copied_frames)) {
+                report_error("The conversion was canceled");
+                success = false;
+            }
+        }
+
+        reset_packet(&packet);
+    }
+
+    if (success && !started) {
+        report_error("Could not find the first key frame of the range");
+        success = false;
+    }
+
+    if (success && head_open) {
+        success = decode_head_packet(NULL, first, last) && encode_head_frame(NULL);
+    }
+
+    av_write_trailer(output_ctx_.get());
+    close_output();
+
+    encoder_ctx_.reset();
+    decoder_ctx_.reset();
+
+    return success;
+}
+
+}  // namespace vs
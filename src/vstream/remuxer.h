@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VSTREAM_REMUXER_H_
+#define SRC_VSTREAM_REMUXER_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <string>
+
+#include "src/vstream/video_stream.h"
+#include "src/vstream/ffmpeg_headers.h"
+#include "src/vstream/ffmpeg_guards.h"
+#include "src/vstream/keyframe_index.h"
+
+namespace vs {
+
+/*
+ * Copies the packets of the groups of pictures inside the range.
+ * The frames before the first key frame of the range are encoded again only for vp9,
+ * that has no global headers and accepts the splice. The other codecs require the range
+ * to start at a key frame and (when the codec reorders the frames) to end before one.
+ */
+class RemuxerImp: public Remuxer {
+ public:
+    RemuxerImp(
+        const char *codec_name,
+        const char *source_path,
+        const char *path,
+        const char *keyframe_index_path,
+        const char *title,
+        const char *author,
+        const char *tags);
+    virtual ~RemuxerImp();
+    bool can_remux(int64_t first_frame, int64_t last_frame) override;
+    bool remux(int64_t first_frame, int64_t last_frame, remux_progress_cb_t progress_cb) override;
+    const char* error() override;
+ private:
+    bool open_source();
+    bool load_keyframes();
+    // the frames are numbered by presentation time like the decoder does (0 is the first one)
+    int64_t pts_to_frame(int64_t pts);
+    int64_t packet_frame(AVPacket *packet);
+    const keyframe_t *find_keyframe(int64_t frame);
+    bool is_keyframe(int64_t frame);
+    int64_t keyframe_before(int64_t frame);
+    int64_t keyframe_after(int64_t frame);
+    bool open_output();
+    bool open_head_codecs();
+    bool decode_head_packet(AVPacket *packet, int64_t first_frame, int64_t last_frame);
+    bool encode_head_frame(AVFrame *frame);
+    bool write_packet(AVPacket *packet);
+    void close_output();
+    void report_error(const char *error);
+ private:
+    std::string codec_name_;
+    std::string source_path_;
+    std::string path_;
+    std::string keyframe_index_path_;
+    std::string title_;
+    std::string author_;
+    std::string tags_;
+    std::string error_;
+    vs::FormatContextPtr input_ctx_;
+    vs::FormatContextPtr output_ctx_;
+    vs::AVCodecContextPtr decoder_ctx_;
+    vs::AVCodecContextPtr encoder_ctx_;
+    vs::AVFramePtr frame_;
+    AVStream *input_stream_;
+    AVStream *output_stream_;
+    std::shared_ptr<const keyframe_list_t> keyframes_;
+    double fps_;
+    int64_t first_pts_frame_;
+    int64_t ts_offset_;
+    bool should_close_file_;
+};
+
+}  // namespace vs
+
+#endif  // SRC_VSTREAM_REMUXER_H_
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/vstream/frame.h"
+#include "src/vstream/reverse_decoder.h"
+
+namespace vs {
+
+namespace {
+
+const uint32_t kMAX_RING_FRAMES = 128;
+
+}  // namespace
+
+ReverseDecoder::ReverseDecoder(FFMpegStream *stream, uint64_t max_memory) {
+    stream_ = stream;
+    max_memory_ = max_memory;
+}
+
+uint32_t ReverseDecoder::frame_size() {
+    return stream_->get_width() * stream_->get_height() * 3;
+}
+
+uint32_t ReverseDecoder::capacity() {
+    uint64_t count = frame_size() ? max_memory_ / frame_size() : 1;
+
+    if (count < 1) {
+        return 1;
+    }
+
+    if (count > kMAX_RING_FRAMES) {
+        return kMAX_RING_FRAMES;
+    }
+
+    return count;
+}
+
+void ReverseDecoder::clear() {
+    frames_.clear();
+}
+
+const reverse_frame_t *ReverseDecoder::find(int64_t frame) {
+    if (frames_.empty() || frame < frames_.front().frame || frame > frames_.back().frame) {
+        return NULL;
+    }
+
+    for (auto it = frames_.rbegin(); it != frames_.rend(); ++it) {
+        if (it->frame == frame) {
+            return &(*it);
+        }
+    }
+
+    return NULL;
+}
+
+unsigned char *ReverseDecoder::buffer(const reverse_frame_t *frame) {
+    if (!frame->picture) {
+        return NULL;
+    }
+    return const_cast<unsigned char *>(frame->picture->data());
+}
+
+const reverse_frame_t *ReverseDecoder::fetch(int64_t frame) {
+    const reverse_frame_t *result = find(frame);
+    if (result || frame < 1) {
+        return result;
+    }
+
+    uint32_t count = capacity();
+
+    // start at the key frame, or as close to the frame as the ring allows
+    int64_t first_frame = frame - count + 1;
+    int64_t keyframe = stream_->keyframe_number(frame);
+    if (keyframe > first_frame) {
+        first_frame = keyframe;
+    }
+    if (first_frame < 1) {
+        first_frame = 1;
+    }
+
+    frames_.clear();
+
+    stream_->seek_frame(first_frame);
+
+    for (;;) {
+        reverse_frame_t decoded;
+        decoded.frame = stream_->get_frame_number();
+        decoded.pts = stream_->get_frame_pts();
+        decoded.time = stream_->get_frame_time();
+        decoded.key_frame = stream_->is_key_frame();
+
+        if (decoded.frame > frame || (!frames_.empty() && decoded.frame <= frames_.back().frame)) {
+            break;
+        }
+
+        if (frames_.size() >= count) {
+            frames_.pop_front();
+        }
+
+        AVFramePtr picture = stream_->get_picture_ref();
+        if (picture) {
+            decoded.picture.reset(new FrameImp(picture, decoded.frame, decoded.pts, decoded.time, decoded.key_frame));
+        }
+        frames_.push_back(decoded);
+
+        if (decoded.frame == frame || !stream_->next_frame()) {
+            break;
+        }
+    }
+
+    return find(frame);
+}
+
+}  // namespace vs
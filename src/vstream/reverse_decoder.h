@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VSTREAM_REVERSE_DECODER_H_
+#define SRC_VSTREAM_REVERSE_DECODER_H_
+
+#include <inttypes.h>
+#include <deque>
+#include <vector>
+#include "src/vstream/ffmpeg_stream.h"
+#include "src/vstream/video_stream.h"
+
+namespace vs {
+
+typedef struct {
+    int64_t frame;
+    int64_t pts;
+    double time;
+    bool key_frame;
+    frame_ref_t picture;
+} reverse_frame_t;
+
+/*
+ * Decodes a group of pictures forward into a ring of rgb frames so they can be handed out backwards.
+ * The ring holds references to the converted pictures (no copies).
+ * When the group does not fit in max_memory only its last frames are kept.
+ */
+class ReverseDecoder {
+    ReverseDecoder(const ReverseDecoder&) = delete;
+    ReverseDecoder& operator=(const ReverseDecoder&) = delete;
+ public:
+    ReverseDecoder(FFMpegStream *stream, uint64_t max_memory);
+    virtual ~ReverseDecoder() {}
+
+    // make the frame available decoding the frames before it when they are not in the ring
+    const reverse_frame_t *fetch(int64_t frame);
+    // return NULL when the frame is not in the ring
+    const reverse_frame_t *find(int64_t frame);
+    unsigned char *buffer(const reverse_frame_t *frame);
+    void clear();
+
+ private:
+    uint32_t frame_size();
+    uint32_t capacity();
+
+ private:
+    FFMpegStream *stream_;
+    uint64_t max_memory_;
+    std::deque<reverse_frame_t> frames_;
+};
+
+}  // namespace vs
+
+#endif  // SRC_VSTREAM_REVERSE_DECODER_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "src/vstream/slice_workers.h"
+
+namespace vs {
+
+SliceWorkers::SliceWorkers(int threads) {
+    generation_ = 0;
+    slices_ = 0;
+    next_slice_ = 0;
+    pending_ = 0;
+    stop_ = false;
+
+    for (int i = 0; i < threads; ++i) {
+        threads_.push_back(std::shared_ptr<boost::thread>(new boost::thread([this] () {
+            work();
+        })));
+    }
+}
+
+SliceWorkers::~SliceWorkers() {
+    {
+        boost::lock_guard<boost::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+
+    for (auto & t : threads_) {
+        t->join();
+    }
+}
+
+int SliceWorkers::threads() {
+    return threads_.size();
+}
+
+void SliceWorkers::run(int slices, slice_cb_t slice_cb) {
+    if (threads_.empty() || slices < 2) {
+        for (int i = 0; i < slices; ++i) {
+            slice_cb(i);
+        }
+        return;
+    }
+
+    boost::unique_lock<boost::mutex> lock(mtx_);
+    slice_cb_ = slice_cb;
+    slices_ = slices;
+    next_slice_ = 0;
+    pending_ = slices;
+    ++generation_;
+    work_cv_.notify_all();
+
+    run_slices(&lock);
+
+    while (pending_) {
+        done_cv_.wait(lock);
+    }
+
+    slice_cb_ = nullptr;
+}
+
+void SliceWorkers::run_slices(boost::unique_lock<boost::mutex> *lock) {
+    while (next_slice_ < slices_) {
+        int slice = next_slice_++;
+
+        lock->unlock();
+        slice_cb_(slice);
+        lock->lock();
+
+        if (--pending_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void SliceWorkers::work() {
+    uint64_t generation = 0;
+    boost::unique_lock<boost::mutex> lock(mtx_);
+
+    for (;;) {
+        while (!stop_ && generation == generation_) {
+            work_cv_.wait(lock);
+        }
+
+        if (stop_) {
+            return;
+        }
+
+        // a worker that wakes up late finds the slices taken and goes back to sleep
+        generation = generation_;
+        run_slices(&lock);
+    }
+}
+
+}  // namespace vs
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_VSTREAM_SLICE_WORKERS_H_
+#define SRC_VSTREAM_SLICE_WORKERS_H_
+
+#include <inttypes.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <boost/thread.hpp>
+
+namespace vs {
+
+typedef std::function<void(int slice)> slice_cb_t;
+
+/*
+ * Threads that split a job in slices (the bands of a picture).
+ * The thread calling run() works on the slices too, so the job uses threads() + 1 cores.
+ * The workers are kept alive between the jobs. run() is not thread safe.
+ */
+class SliceWorkers {
+    SliceWorkers(const SliceWorkers&) = delete;
+    SliceWorkers& operator=(const SliceWorkers&) = delete;
+ public:
+    explicit SliceWorkers(int threads);
+    virtual ~SliceWorkers();
+    int threads();
+    // call slice_cb for every slice from 0 to slices - 1 and wait them to finish
+    void run(int slices, slice_cb_t slice_cb);
+
+ private:
+    void work();
+    void run_slices(boost::unique_lock<boost::mutex> *lock);
+
+ private:
+    std::vector<std::shared_ptr<boost::thread> > threads_;
+    boost::mutex mtx_;
+    boost::condition_variable work_cv_;
+    boost::condition_variable done_cv_;
+    slice_cb_t slice_cb_;
+    uint64_t generation_;
+    int slices_;
+    int next_slice_;
+    int pending_;
+    bool stop_;
+};
+
+}  // namespace vs
+
+#endif  // SRC_VSTREAM_SLICE_WORKERS_H_
@@ -4,18 +4,57 @@
 #include "src/vstream/video_stream.h"
 #include "src/vstream/decoder.h"
 #include "src/vstream/encoder.h"
+#include "src/vstream/remuxer.h"
 
 namespace vs {
 
 // abastract classes destructors:
 
+Frame::~Frame() {}
 StreamInfo::~StreamInfo() {}
 Decoder::~Decoder() {}
 Encoder::~Encoder() {}
+Remuxer::~Remuxer() {}
 // instance creating functions:
 
-std::shared_ptr<vs::Decoder> open_file(const char* path) {
-    return std::shared_ptr<vs::Decoder>(new vs::DecoderImp(path, vs::file_source));
+decoder_options_t default_decoder_options() {
+    decoder_options_t options;
+    options.thread_type = decoder_threads_auto;
+    options.thread_count = 0;
+    // several decoders run at once (the proxy, the thumbnails, the batch workers), the player asks for the cores
+    options.convert_threads = 1;
+    options.key_frames_only = false;
+    return options;
+}
+
+const char *decoder_thread_type_name(decoder_thread_type thread_type) {
+    switch (thread_type) {
+        case decoder_threads_auto:
+            return "auto";
+        case decoder_threads_frame:
+            return "frame";
+        case decoder_threads_slice:
+            return "slice";
+        default:
+            return "none";
+    }
+}
+
+std::shared_ptr<vs::Decoder> open_file(const char* path, const char *keyframe_index_path, const decoder_options_t& options) {
+    return std::shared_ptr<vs::Decoder>(new vs::DecoderImp(path, vs::file_source, keyframe_index_path, options));
+}
+
+encoder_options_t default_encoder_options() {
+    encoder_options_t options;
+    // the settings the encoder always had, the faster profiles trade quality at the same bitrate
+    options.profile = encoder_profile_archival;
+    options.thread_count = 0;
+    return options;
+}
+
+const char **encoder_profile_names() {
+    static const char *names[] = {"draft", "balanced", "archival", NULL};
+    return names;
 }
 
 std::shared_ptr<Encoder> encoder(
@@ -28,7 +67,9 @@ std::shared_ptr<Encoder> encoder(
     int bit_rate,
     const char *title,
     const char *author,
-    const char *tags
+    const char *tags,
+    int key_frame_interval,
+    const encoder_options_t& options
 ) {
     return std::shared_ptr<vs::Encoder>(new vs::EncoderImp(
         codec_name,
@@ -40,7 +81,29 @@ std::shared_ptr<Encoder> encoder(
         frame_height,
         fps_numerator,
         fps_denominator,
-        bit_rate
+        bit_rate,
+        key_frame_interval,
+        options
+    ));
+}
+
+std::shared_ptr<Remuxer> remuxer(
+    const char *codec_name,
+    const char *source_path,
+    const char *path,
+    const char *keyframe_index_path,
+    const char *title,
+    const char *author,
+    const char *tags
+) {
+    return std::shared_ptr<vs::Remuxer>(new vs::RemuxerImp(
+        codec_name,
+        source_path,
+        path,
+        keyframe_index_path,
+        title ? title : "",
+        author ? author : "",
+        tags ? tags : ""
     ));
 }
 
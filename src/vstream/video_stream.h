@@ -5,6 +5,7 @@
 #define SRC_VSTREAM_VIDEO_STREAM_H_
 
 #include <inttypes.h>
+#include <functional>
 #include <memory>
 
 namespace vs {
@@ -20,6 +21,73 @@ typedef enum {
     video_color_rgb = 2
 } video_color_type;
 
+typedef enum {
+    decoder_threads_auto = 0,   // frame threads when the codec supports them, slice threads otherwise
+    decoder_threads_frame = 1,  // one frame by thread (it delays the output by thread_count frames)
+    decoder_threads_slice = 2,  // the slices of a frame in parallel (when the stream has slices)
+    decoder_threads_none = 3
+} decoder_thread_type;
+
+typedef struct {
+    decoder_thread_type thread_type;
+    int thread_count;  // 0 = one by core
+    int convert_threads;  // bands of the picture converted to rgb in parallel (0 = one by core, 1 by default)
+    bool key_frames_only;  // skip the other frames (AVDISCARD_NONKEY): next() goes to the next key frame, seek_frame() stops at the key frame before
+} decoder_options_t;
+
+typedef enum {
+    encoder_profile_draft = 0,     // the fastest settings, for previews
+    encoder_profile_balanced = 1,
+    encoder_profile_archival = 2   // the slowest settings, the best quality for the bitrate
+} encoder_profile;
+
+typedef struct {
+    encoder_profile profile;
+    int thread_count;  // 0 = one by core
+} encoder_options_t;
+
+typedef enum {
+    pixel_format_rgb24 = 0,
+    pixel_format_yuv420p = 1,
+    pixel_format_other = 2
+} pixel_format;
+
+// a rectangle of the frame (pixels)
+typedef struct {
+    int x;
+    int y;
+    int w;
+    int h;
+} frame_area_t;
+
+// planes of a frame in planar yuv 4:2:0 (limited range)
+typedef struct {
+    const unsigned char *data[3];
+    int linesize[3];
+} yuv_planes_t;
+
+
+/*
+ * A decoded picture shared by reference counting. The decoder never writes to a frame it
+ * handed out: holding the reference keeps the pixels valid while the decoder moves on.
+ */
+class Frame {
+ public:
+    virtual ~Frame();
+    virtual uint32_t w() const = 0;
+    virtual uint32_t h() const = 0;
+    virtual pixel_format format() const = 0;
+    // rgb24 has the plane 0, yuv420p the planes 0 (y), 1 (u) and 2 (v)
+    virtual const unsigned char *data(int plane=0) const = 0;
+    // bytes from a row to the next one
+    virtual int stride(int plane=0) const = 0;
+    virtual uint32_t position() const = 0;
+    virtual int64_t pts() const = 0;
+    virtual double time() const = 0;
+    virtual bool key_frame() const = 0;
+};
+
+typedef std::shared_ptr<const Frame> frame_ref_t;
 
 class StreamInfo {
   public:
@@ -28,8 +96,6 @@ class StreamInfo {
     virtual uint32_t w() = 0;
     virtual uint32_t h() = 0;
     virtual const char* error() = 0;
-    virtual unsigned char *buffer() = 0;
-    virtual uint32_t buffer_size() = 0;
     virtual uint32_t position() = 0;
     virtual uint32_t count() = 0;
     virtual double fps() = 0;
@@ -41,28 +107,97 @@ class StreamInfo {
     virtual int time_den() = 0;
     virtual int time_num() = 0;
     virtual bool key_frame() = 0;
+    // the threading the codec is really using (decoder_threads_none when it supports none of the requested)
+    virtual decoder_thread_type thread_type() = 0;
+    virtual int thread_count() = 0;
 };
 
 class Decoder: public StreamInfo {
  public:
     virtual ~Decoder();
+    virtual unsigned char *buffer() = 0;
+    virtual uint32_t buffer_size() = 0;
     virtual void next() = 0;
     virtual void prior() = 0;
     virtual void seek_frame(int64_t frame) = 0;
     virtual void seek_time(int64_t ms_time) = 0;
+    // moves to the key frame at or before frame decoding only that one (for scrubbing)
+    virtual void seek_keyframe(int64_t frame) = 0;
+    // called from another thread: the seek_frame() in progress stops at the frame it reached.
+    // every call ends a generation of seeks, the seek_generation() is the count of calls
+    virtual void interrupt_seek() = 0;
+    // any thread
+    virtual uint32_t seek_generation() = 0;
+    // the next seeks belong to generation (read when they were requested): the interrupt_seek() calls after it
+    // stop them, even the calls made before they start. the seeks of no claimed generation belong to the one they start in
+    virtual void claim_seek_generation(uint32_t generation) = 0;
+    // next() skips the frames no other frame depends on (AVDISCARD_NONREF), for playing at high speeds.
+    // the position jumps over them. the seeks decode them again and stay exact
+    virtual void skip_non_reference(bool skip) = 0;
+    // changes decoder_options_t::convert_threads
+    virtual void convert_threads(int count) = 0;
+    virtual bool save_keyframe_index(const char *path) = 0;
+    // the decoded frame without color conversion (return false if it's not limited range yuv 4:2:0)
+    virtual bool yuv_planes(yuv_planes_t *planes) = 0;
+    // the current frame in rgb24 with packed rows (stride is w * 3), the same pixels buffer() points to.
+    // empty when there is no frame
+    virtual frame_ref_t frame() = 0;
+    // like frame(), but only the pixels inside area (it may grow a bit to align with the chroma) are converted.
+    // the other pixels are not defined. the full frame is returned when it's already converted
+    virtual frame_ref_t partial_frame(const frame_area_t& area) = 0;
+    // the current frame in rgb24 (packed rows) resized by the color conversion to fit in max_w x max_h,
+    // keeping the aspect ratio. the frames that already fit are not resized (it returns frame())
+    virtual frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) = 0;
+    // the current frame as the codec decoded it (no color conversion, the codec strides).
+    // empty when the frame is not available in the source format (the frames stepped backwards)
+    virtual frame_ref_t source_frame() = 0;
 };
 
 class Encoder {
  public:
     virtual ~Encoder();
     virtual bool frame(const unsigned char* buffer) = 0;
+    // the planes must have the frame dimensions. it's only available when accepts_yuv() is true
+    virtual bool yuv_frame(const yuv_planes_t& planes) = 0;
+    virtual bool accepts_yuv() = 0;
     virtual const char* error() = 0;
     virtual bool finish() = 0;
     static const char **format_names();
     static int default_bitrate(const char *format_name, unsigned int w, unsigned int h, double fps);
 };
 
-std::shared_ptr<Decoder> open_file(const char* path);
+// return false to cancel the remux
+typedef std::function<bool(uint32_t copied_frames)> remux_progress_cb_t;
+
+/*
+ * Writes a range of frames of a video without decoding it: the compressed packets are copied to the output.
+ * Only the frames before the first key frame of the range are encoded again (when the codec allows it).
+ */
+class Remuxer {
+ public:
+    virtual ~Remuxer();
+    // frames are numbered from 1, like the decoder positions. return false when the range must be re-encoded
+    virtual bool can_remux(int64_t first_frame, int64_t last_frame) = 0;
+    virtual bool remux(int64_t first_frame, int64_t last_frame, remux_progress_cb_t progress_cb) = 0;
+    virtual const char* error() = 0;
+};
+
+// automatic threads, one by core
+decoder_options_t default_decoder_options();
+
+const char *decoder_thread_type_name(decoder_thread_type thread_type);
+
+// the keyframe index is loaded from keyframe_index_path or built in background and stored there
+std::shared_ptr<Decoder> open_file(
+    const char* path,
+    const char *keyframe_index_path=NULL,
+    const decoder_options_t& options=default_decoder_options());
+
+// archival profile, one thread by core
+encoder_options_t default_encoder_options();
+
+// in the encoder_profile order, terminated by NULL
+const char **encoder_profile_names();
 
 std::shared_ptr<Encoder> encoder(
     const char *codec_name,
@@ -74,9 +209,21 @@ std::shared_ptr<Encoder> encoder(
     int bit_rate,
     const char *title=NULL,
     const char *author=NULL,
-    const char *tags=NULL
+    const char *tags=NULL,
+    int key_frame_interval=0,  // 0 = the default interval
+    const encoder_options_t& options=default_encoder_options()
 );
 
+// the format (codec_name) is one of Encoder::format_names() and it must match the source codec
+std::shared_ptr<Remuxer> remuxer(
+    const char *codec_name,
+    const char *source_path,
+    const char *path,
+    const char *keyframe_index_path=NULL,
+    const char *title=NULL,
+    const char *author=NULL,
+    const char *tags=NULL
+);
 
 void initialize();
 
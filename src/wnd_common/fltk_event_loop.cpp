@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <FL/Fl.H>
+#include "src/common/event_loop.h"
+
+namespace vcutter {
+
+void wait_events(double timeout) {
+    Fl::wait(timeout);
+}
+
+void add_timeout(double timeout, timeout_handler_t handler, void *data) {
+    Fl::add_timeout(timeout, handler, data);
+}
+
+void repeat_timeout(double timeout, timeout_handler_t handler, void *data) {
+    Fl::repeat_timeout(timeout, handler, data);
+}
+
+void remove_timeout(timeout_handler_t handler, void *data) {
+    Fl::remove_timeout(handler, data);
+}
+
+void add_check(timeout_handler_t handler, void *data) {
+    Fl::add_check(handler, data);
+}
+
+void remove_check(timeout_handler_t handler, void *data) {
+    Fl::remove_check(handler, data);
+}
+
+void awake() {
+    // it takes effect once Fl::lock() was called (see main)
+    Fl::awake();
+}
+
+}  // namespace vcutter
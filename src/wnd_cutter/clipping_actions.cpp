@@ -64,6 +64,7 @@ bool ClippingActions::handle_opened_clipping() {
         handler_->handle_clipping_opened(false);
         return false;
     }
+    clipping_->edit_with_proxy();
     clipping_->player()->seek_frame(clipping_->first_frame());
     handler_->handle_clipping_opened(true);
     return true;
@@ -619,8 +620,7 @@ callback_t ClippingActions::action_scale_all() {
 
 callback_t ClippingActions::action_next() {
     return [this] () {
-        if (!player()->is_playing() && Fl::event_shift() && player()->info()->position() + 33 < player()->info()->count()) {
-            player()->seek_frame(player()->info()->position() + 33);
+        if (!player()->is_playing() && Fl::event_shift() && player()->seek_relative(33)) {
             handler_->handle_buffer_modified();
             return;
         }
@@ -631,8 +631,7 @@ callback_t ClippingActions::action_next() {
 
 callback_t ClippingActions::action_prior() {
     return [this] () {
-        if (!player()->is_playing() && Fl::event_shift() && player()->info()->position() - 33 > 0) {
-            player()->seek_frame(player()->info()->position() - 33);
+        if (!player()->is_playing() && Fl::event_shift() && player()->seek_relative(-33)) {
             handler_->handle_buffer_modified();
             return;
         }
@@ -2,6 +2,7 @@
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
 #include <cmath>
+#include <vector>
 #include <GL/gl.h>
 
 #include "src/common/utils.h"
@@ -86,7 +87,7 @@ void CutterWindow::resize_controls() {
     window_->position(0, 0);
     window_->size(parent_->w(), parent_->h());
     components_group_->position(0, 0);
-    components_group_->size(window_->w(), window_->h() - 30);
+    components_group_->size(window_->w(), window_->h() - player_bar_->h());
 
     player_bar_->resize_controls();
 
@@ -270,6 +271,7 @@ void CutterWindow::update_buffers(bool frame_changed) {
         side_bar_->update_selection();
         clipping_editor_->update(clipping());
         side_bar_->viewer()->update_preview(clipping());
+        prefetch_adjacent_keys();
     } else {
         if (clipping_editor_->current_clipping() != clipping()) {
             clipping_editor_->update(clipping());
@@ -288,6 +290,29 @@ void CutterWindow::update_buffers(bool frame_changed) {
     side_bar_->update(true);
 }
 
+void CutterWindow::prefetch_adjacent_keys() {
+    // going to the key before or after the current frame does not wait for the decoder
+    uint32_t position = player()->info()->position();
+    uint32_t prior = 0;
+    uint32_t next = 0;
+    for (const auto & k : clipping()->keys()) {
+        if (k.frame < position && k.frame > prior) {
+            prior = k.frame;
+        } else if (k.frame > position && (!next || k.frame < next)) {
+            next = k.frame;
+        }
+    }
+
+    std::vector<uint32_t> frames;
+    if (next) {
+        frames.push_back(next);
+    }
+    if (prior) {
+        frames.push_back(prior);
+    }
+    player()->prefetch_key_frames(frames);
+}
+
 void CutterWindow::handle_frame_changed(Player *player) {
     update_buffers(true);
 }
@@ -66,6 +66,7 @@ class CutterWindow : public ClippingActionsHandler {
 
  private:
     void update_buffers(bool frame_changed);
+    void prefetch_adjacent_keys();
     void double_click(void *component);
 
  private:
@@ -9,12 +9,23 @@
 
 namespace vcutter {
 
+namespace {
+
+// the thumbnails above the seek bar
+const int kTHUMBNAILS_H = 42;
+const uint32_t kTHUMBNAIL_SLOTS = 200;
+const uint32_t kTHUMBNAIL_W = 64;
+const uint32_t kTHUMBNAIL_H = 36;
+
+}  // namespace
+
 PlayerBar::PlayerBar(ClippingActions *actions, Fl_Group *parent) {
     in_seek_bar_callback_ = false;
+    scrubbing_ = false;
     actions_ = actions;
     parent_ = parent;
 
-    group_ = new Fl_Group(0,0, parent->w(), 30);
+    group_ = new Fl_Group(0,0, parent->w(), 30 + kTHUMBNAILS_H);
     group_->box(FL_UP_BOX);
 
     btn_speed_.reset(new Button("1.0", action_speed()));
@@ -28,10 +39,10 @@ PlayerBar::PlayerBar(ClippingActions *actions, Fl_Group *parent) {
     btn_cutoff12_.reset(new Button(xpm::image(xpm::button_scissor), actions_->action_cutoff12()));
     btn_cutoff2_.reset(new Button(xpm::image(xpm::button_end), actions_->action_cutoff2()));
 
-    frame_input_ = new Fl_Box(FL_DOWN_BOX, btn_cutoff2_->x() + 28, 3, 75, 25, "0");
-    frame_counter_ = new Fl_Box(FL_DOWN_BOX, frame_input_->x() + frame_input_->w() + 3, 3, 75, 25, "-");
-    frame_time_ = new Fl_Box(FL_DOWN_BOX, frame_counter_->x() + frame_counter_->w() + 3, 3, 75, 25, "-");
-    video_duration_ = new Fl_Box(FL_DOWN_BOX, frame_time_->x() + frame_time_->w() + 3, 3, 75, 25, "-");
+    frame_input_ = new Fl_Box(FL_DOWN_BOX, btn_cutoff2_->x() + 28, kTHUMBNAILS_H + 3, 75, 25, "0");
+    frame_counter_ = new Fl_Box(FL_DOWN_BOX, frame_input_->x() + frame_input_->w() + 3, kTHUMBNAILS_H + 3, 75, 25, "-");
+    frame_time_ = new Fl_Box(FL_DOWN_BOX, frame_counter_->x() + frame_counter_->w() + 3, kTHUMBNAILS_H + 3, 75, 25, "-");
+    video_duration_ = new Fl_Box(FL_DOWN_BOX, frame_time_->x() + frame_time_->w() + 3, kTHUMBNAILS_H + 3, 75, 25, "-");
 
     frame_input_->align(FL_ALIGN_INSIDE|FL_ALIGN_RIGHT);
     frame_counter_->align(FL_ALIGN_INSIDE|FL_ALIGN_LEFT);
@@ -40,8 +51,12 @@ PlayerBar::PlayerBar(ClippingActions *actions, Fl_Group *parent) {
     video_duration_->align(FL_ALIGN_INSIDE|FL_ALIGN_LEFT);
 
     int seek_bar_left = video_duration_->x() + video_duration_->w() + 3;
-    seek_bar_ = new Fl_Hor_Slider(seek_bar_left, 3, parent->w() - seek_bar_left - 5, 25);
+    seek_bar_ = new Fl_Hor_Slider(seek_bar_left, kTHUMBNAILS_H + 3, parent->w() - seek_bar_left - 5, 25);
     seek_bar_->step(1);
+    // the release refines the frames shown while dragging
+    seek_bar_->when(FL_WHEN_CHANGED | FL_WHEN_RELEASE);
+
+    thumbnail_bar_ = new ThumbnailBar(seek_bar_left, 3, seek_bar_->w(), kTHUMBNAILS_H - 2);
 
     seek_bar_->clear_visible_focus();
 
@@ -78,7 +93,7 @@ void PlayerBar::resize_controls() {
 
     parent_->position(0, 0);
     group_->position(0, 0);
-    group_->size(parent_->w(), 30);
+    group_->size(parent_->w(), 30 + kTHUMBNAILS_H);
 
     btn_speed_->size(35, 25);
     btn_play_->size(25, 25);
@@ -96,7 +111,7 @@ void PlayerBar::resize_controls() {
     video_duration_->size(75, 25);
 
     int position = 38;
-    btn_play_->position(0, 3);
+    btn_play_->position(0, kTHUMBNAILS_H + 3);
     btn_speed_->position(0, btn_play_->y());
     btn_play_->position(position, btn_play_->y());
     btn_pause_->position(position += 27, btn_play_->y());
@@ -115,9 +130,12 @@ void PlayerBar::resize_controls() {
     seek_bar_->position(position += 77,  btn_play_->y());
     seek_bar_->size(parent_->w() - seek_bar_->x() - 5, 25);
 
+    thumbnail_bar_->position(seek_bar_->x(), 3);
+    thumbnail_bar_->size(seek_bar_->w(), kTHUMBNAILS_H - 2);
+
     seek_bar_->callback(seek_bar_callback, this);
 
-    group_->position(0, parent_->h() - 30);
+    group_->position(0, parent_->h() - group_->h());
     parent_->position(parent_x, parent_y);
 }
 
@@ -147,13 +165,43 @@ void PlayerBar::seek_bar_callback(Fl_Widget* widget, void *userdata) {
         return;
     }
 
-    if (bar->actions_->clipping()) {
+    if (!bar->actions_->clipping()) {
+        return;
+    }
+
+    // dragging shows the key frames, the exact frame is decoded once the mouse is released
+    bar->scrubbing_ = Fl::event() == FL_PUSH || Fl::event() == FL_DRAG;
+    if (bar->scrubbing_) {
+        bar->actions_->player()->scrub_frame(bar->seek_bar_->value());
+    } else {
         bar->actions_->player()->seek_frame(bar->seek_bar_->value());
-        bar->actions_->handler()->handle_buffer_modified();
     }
+    bar->actions_->handler()->handle_buffer_modified();
+}
+
+void PlayerBar::update_thumbnails() {
+    Clipping *clipping = actions_->clipping();
+    if (!clipping || !clipping->good()) {
+        if (thumbnail_bar_->strip()) {
+            thumbnail_bar_->strip(std::shared_ptr<ThumbnailStrip>());
+        }
+        return;
+    }
+
+    // a strip by video, the same video keeps its strip between the clippings
+    std::shared_ptr<ThumbnailStrip> strip = thumbnail_bar_->strip();
+    if (!strip || strip->video_path() != clipping->video_path()) {
+        strip = ThumbnailStrip::open(
+            clipping->video_path().c_str(), clipping->thumbnails_path().c_str(), kTHUMBNAIL_SLOTS, kTHUMBNAIL_W, kTHUMBNAIL_H);
+        thumbnail_bar_->strip(strip);
+    }
+
+    thumbnail_bar_->current_frame(player()->info()->position());
 }
 
 void PlayerBar::update() {
+    update_thumbnails();
+
     if (!actions_->clipping()) {
         frame_input_->label("0");
         frame_counter_->label("0");
@@ -164,7 +212,8 @@ void PlayerBar::update() {
     if (seek_bar_->maximum() != player()->info()->count()) {
         seek_bar_->maximum(player()->info()->count());
     }
-    if (seek_bar_->value() !=  player()->info()->position()) {
+    // the frame shown while dragging is a key frame, the bar keeps the mouse position
+    if (!scrubbing_ && seek_bar_->value() !=  player()->info()->position()) {
         seek_bar_->value(player()->info()->position());
     }
     char temp[55] = "";
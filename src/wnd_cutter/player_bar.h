@@ -11,6 +11,7 @@
 #include <FL/Fl_Image.H>
 
 #include "src/wnd_cutter/clipping_actions.h"
+#include "src/wnd_cutter/thumbnail_bar.h"
 #include "src/controls/button.h"
 
 namespace vcutter {
@@ -28,9 +29,11 @@ class PlayerBar {
     callback_t action_speed();
     static void seek_bar_callback(Fl_Widget* widget, void *userdata);
     void display_speed();
+    void update_thumbnails();
 
  private:
     bool in_seek_bar_callback_;
+    bool scrubbing_;  // the seek bar is being dragged
     std::set<std::shared_ptr<Fl_Image> > images_;
     ClippingActions *actions_;
     Fl_Group *parent_;
@@ -40,6 +43,7 @@ class PlayerBar {
     Fl_Box *frame_time_;
     Fl_Box *video_duration_;
     Fl_Hor_Slider *seek_bar_;
+    ThumbnailBar *thumbnail_bar_;
     std::unique_ptr<Button> btn_speed_;
     std::unique_ptr<Button> btn_play_;
     std::unique_ptr<Button> btn_pause_;
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <FL/Fl.H>
+#include <FL/fl_draw.H>
+#include "src/wnd_cutter/thumbnail_bar.h"
+
+namespace vcutter {
+
+namespace {
+
+const double kTIMEOUT_INTERVAL = 0.25;
+
+}  // namespace
+
+ThumbnailBar::ThumbnailBar(int x, int y, int w, int h) : Fl_Widget(x, y, w, h) {
+    strip_version_ = 0;
+    current_frame_ = 0;
+    box(FL_DOWN_BOX);
+    color(FL_BLACK);
+}
+
+ThumbnailBar::~ThumbnailBar() {
+    Fl::remove_timeout(&ThumbnailBar::timeout_handler, this);
+}
+
+void ThumbnailBar::strip(std::shared_ptr<ThumbnailStrip> strip) {
+    Fl::remove_timeout(&ThumbnailBar::timeout_handler, this);
+    strip_ = strip;
+    strip_version_ = 0;
+    if (strip_) {
+        Fl::add_timeout(kTIMEOUT_INTERVAL, &ThumbnailBar::timeout_handler, this);
+    }
+    redraw();
+}
+
+std::shared_ptr<ThumbnailStrip> ThumbnailBar::strip() {
+    return strip_;
+}
+
+void ThumbnailBar::current_frame(uint32_t frame) {
+    if (current_frame_ != frame) {
+        current_frame_ = frame;
+        redraw();
+    }
+}
+
+void ThumbnailBar::timeout_handler(void *ud) {
+    ThumbnailBar *bar = static_cast<ThumbnailBar *>(ud);
+    if (!bar->strip_) {
+        return;
+    }
+
+    if (bar->strip_version_ != bar->strip_->version()) {
+        bar->redraw();
+    }
+
+    // the last thumbnails are drawn after the strip finishes
+    if (!bar->strip_->finished() || bar->strip_version_ != bar->strip_->version()) {
+        Fl::repeat_timeout(kTIMEOUT_INTERVAL, &ThumbnailBar::timeout_handler, ud);
+    }
+}
+
+void ThumbnailBar::draw() {
+    draw_box();
+
+    int area_x = x() + Fl::box_dx(box());
+    int area_y = y() + Fl::box_dy(box());
+    int area_w = w() - Fl::box_dw(box());
+    int area_h = h() - Fl::box_dh(box());
+
+    if (!strip_ || area_w < 1 || area_h < 1) {
+        return;
+    }
+
+    strip_version_ = strip_->version();
+    uint32_t count = strip_->frame_count();
+    if (count < 1) {
+        return;
+    }
+
+    fl_push_clip(area_x, area_y, area_w, area_h);
+
+    // as many cells as fit, each one shows the frame at its middle
+    int cells = area_w / static_cast<int>(strip_->thumbnail_w() > 0 ? strip_->thumbnail_w() : 1);
+    if (cells < 1) {
+        cells = 1;
+    }
+
+    for (int i = 0; i < cells; ++i) {
+        int cell_x = area_x + (i * area_w) / cells;
+        int cell_w = area_x + ((i + 1) * area_w) / cells - cell_x;
+
+        uint32_t frame = static_cast<uint32_t>(((i + 0.5) * count) / cells) + 1;
+        thumbnail_ref_t thumbnail = strip_->thumbnail(frame);
+        if (!thumbnail) {
+            continue;
+        }
+
+        int thumbnail_x = cell_x + (cell_w - static_cast<int>(thumbnail->w)) / 2;
+        int thumbnail_y = area_y + (area_h - static_cast<int>(thumbnail->h)) / 2;
+
+        fl_push_clip(cell_x, area_y, cell_w, area_h);
+        fl_draw_image(thumbnail->pixels->data, thumbnail_x, thumbnail_y, thumbnail->w, thumbnail->h, 3, thumbnail->w * 3);
+        fl_pop_clip();
+    }
+
+    if (current_frame_ > 0) {
+        int marker_x = area_x + static_cast<int>((static_cast<uint64_t>(current_frame_ - 1) * area_w) / count);
+        fl_color(FL_RED);
+        fl_line_style(FL_SOLID, 2);
+        fl_yxline(marker_x, area_y, area_y + area_h - 1);
+        fl_line_style(0);
+    }
+
+    fl_pop_clip();
+}
+
+}  // namespace vcutter
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef SRC_WND_CUTTER_THUMBNAIL_BAR_H_
+#define SRC_WND_CUTTER_THUMBNAIL_BAR_H_
+
+#include <inttypes.h>
+#include <memory>
+#include <FL/Fl_Widget.H>
+
+#include "src/player/thumbnail_strip.h"
+
+namespace vcutter {
+
+/*
+ * The key frames of the video side by side, above the seek bar.
+ * It redraws while the strip is filling in.
+ */
+class ThumbnailBar: public Fl_Widget {
+ public:
+    ThumbnailBar(int x, int y, int w, int h);
+    virtual ~ThumbnailBar();
+    // the bar takes the strip (empty to clear it)
+    void strip(std::shared_ptr<ThumbnailStrip> strip);
+    std::shared_ptr<ThumbnailStrip> strip();
+    // the frame marked on the bar
+    void current_frame(uint32_t frame);
+
+ protected:
+    void draw() override;
+
+ private:
+    static void timeout_handler(void *ud);
+
+ private:
+    std::shared_ptr<ThumbnailStrip> strip_;
+    uint32_t strip_version_;
+    uint32_t current_frame_;
+};
+
+}  // namespace vcutter
+
+#endif  // SRC_WND_CUTTER_THUMBNAIL_BAR_H_
@@ -615,6 +615,8 @@ int MainWindow::handle(int event) {
 int main(int argc, char **argv) {
     vs::initialize();
     Fl::scheme("gtk+");
+    // the players wake up the loop from their threads when a frame is ready
+    Fl::lock();
 
     auto main_window = new vcutter::MainWindow();
 
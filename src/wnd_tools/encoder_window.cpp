@@ -19,9 +19,10 @@ namespace {
 const char *kSOURCE_DIR_KEY = "ews-source-dir";
 const char *kCLIPPING_DIR_KEY = "ews-clipping-dir";
 const char *kCONVERSION_DIR_KEY = "ews-conversion-dir";
+const char *kMEASURED_FPS_KEY = "ews-fps";
 
 const int kWINDOW_WIDTH = 700;
-const int kWINDOW_HEIGHT = 410;
+const int kWINDOW_HEIGHT = 490;
 
 const char *kEDT_PATH_FIELD = "source_path";
 const char *kEDT_OUTPUT_FIELD = "target_path";
@@ -31,12 +32,19 @@ const char *kEDT_FPS_FIELD = "fps";
 const char *kCHE_BACKWARD_FIELD = "backward";
 const char *kCHE_REVERSE_FIELD = "reverse";
 const char *kSPN_TRANSITION_FIELD = "transitions";
+const char *kCMB_PROFILES_FIELD = "profile";
+const char *kSPN_THREADS_FIELD = "encoder_threads";
 const char *kEDT_START_FIELD = "start";
 const char *kEDT_END_FIELD = "end";
 const char *kORI_FPS_FIELD = "original_fps";
 const char *kCLIP_VAR_NAME = "clipping";
 const char *kPATH_VAR_NAME = "path";
 
+// the encoding speed of the last conversion with the format and the profile
+std::string measured_fps_key(const char *format, const char *profile) {
+    return std::string(kMEASURED_FPS_KEY) + "-" + format + "-" + profile;
+}
+
 }  // namespace
 
 bool should_replace(const char *path) {
@@ -113,12 +121,24 @@ void EncoderWindow::init(History* history, std::shared_ptr<ClippingRender> clip)
 
     btn_fps_ = new Fl_Button(edt_fps_->x() + edt_fps_->w() + 1,  edt_fps_->y(), 60, 25, "change");
 
-    edt_title_ = new Fl_Input(5, btn_fps_->y() + 25 + btn_fps_->h(), window_->w() - 37, 25, "Title:");
+    cmb_profiles_ = new Fl_Choice(5, btn_fps_->y() + 25 + btn_fps_->h(), 405, 25, "Encoder speed:");
+    cmb_profiles_->align(FL_ALIGN_TOP_LEFT);
+
+    spn_threads_ = new Fl_Spinner(cmb_profiles_->x() + cmb_profiles_->w() + 5, cmb_profiles_->y(), 70, 25, "Threads:");
+    spn_threads_->align(FL_ALIGN_TOP_LEFT);
+    spn_threads_->range(0, 64);
+    spn_threads_->step(1);
+    spn_threads_->value(0);
+    spn_threads_->tooltip("Encoder threads (0 = one by processor core)");
+
+    edt_title_ = new Fl_Input(5, cmb_profiles_->y() + 25 + cmb_profiles_->h(), window_->w() - 37, 25, "Title:");
     edt_title_->align(FL_ALIGN_TOP_LEFT);
     edt_author_ = new Fl_Input(5, edt_title_->y() + 25 + edt_title_->h(), window_->w() - 37, 25, "Author:");
     edt_author_->align(FL_ALIGN_TOP_LEFT);
     edt_tags_ = new Fl_Input(5, edt_author_->y() + 25 + edt_author_->h(), window_->w() - 37, 25, "Description:");
     edt_tags_->align(FL_ALIGN_TOP_LEFT);
+    box_stages_ = new Fl_Box(FL_NO_BOX, 5, edt_tags_->y() + edt_tags_->h() + 3, window_->w() - 10, 25, "");
+    box_stages_->align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
 
     components_group_->end();
 
@@ -154,6 +174,12 @@ void EncoderWindow::init(History* history, std::shared_ptr<ClippingRender> clip)
 
     cmb_formats_->value(webm_index);
 
+    for (const char **profiles = vs::encoder_profile_names(); *profiles; ++profiles) {
+        cmb_profiles_->add(*profiles);
+    }
+    cmb_profiles_->value(vs::default_encoder_options().profile);
+    update_profile_labels();
+
     btn_close_->callback(button_callback, this);
     btn_path_->callback(button_callback, this);
     btn_output_->callback(button_callback, this);
@@ -211,6 +237,12 @@ std::map<std::string, std::string> EncoderWindow::serialize() {
     snprintf(buffer, sizeof(buffer) - 1, "%d", static_cast<int>(spn_transitions_->value()));
     result[kSPN_TRANSITION_FIELD] = buffer;
 
+    snprintf(buffer, sizeof(buffer) - 1, "%d", cmb_profiles_->value());
+    result[kCMB_PROFILES_FIELD] = buffer;
+
+    snprintf(buffer, sizeof(buffer) - 1, "%d", static_cast<int>(spn_threads_->value()));
+    result[kSPN_THREADS_FIELD] = buffer;
+
     result[kEDT_START_FIELD] = edt_start_->value();
     result[kEDT_END_FIELD] = edt_end_->value();
 
@@ -272,6 +304,20 @@ bool EncoderWindow::deserialize(const string_map_t & data) {
         spn_transitions_->value(value);
     }
 
+    if (data.find(kCMB_PROFILES_FIELD) != data.end()) {
+        int value = 0;
+        sscanf(data.at(kCMB_PROFILES_FIELD).c_str(), "%d", &value);
+        if (value >= 0 && value < cmb_profiles_->size() - 1) {
+            cmb_profiles_->value(value);
+        }
+    }
+
+    if (data.find(kSPN_THREADS_FIELD) != data.end()) {
+        int value = 0;
+        sscanf(data.at(kSPN_THREADS_FIELD).c_str(), "%d", &value);
+        spn_threads_->value(value);
+    }
+
     if (data.find(kEDT_START_FIELD) != data.end())
         edt_start_->value(data.at(kEDT_START_FIELD).c_str());
 
@@ -342,6 +388,8 @@ void EncoderWindow::restore_session(History* history, Fl_Window *parent) {
         kCHE_BACKWARD_FIELD,
         kCHE_REVERSE_FIELD,
         kSPN_TRANSITION_FIELD,
+        kCMB_PROFILES_FIELD,
+        kSPN_THREADS_FIELD,
         kEDT_START_FIELD,
         kEDT_END_FIELD,
         kORI_FPS_FIELD,
@@ -520,6 +568,7 @@ void EncoderWindow::action_convert() {
     }
 
     ClippingConversion conv(prog, clip, 419430400, edt_title_->value(), edt_author_->value(), edt_tags_->value());
+    conv.encoder_options(choosen_encoder_options());
     conv.convert(
         format,
         edt_output_->value(),
@@ -529,6 +578,11 @@ void EncoderWindow::action_convert() {
         btn_append_reverse_->value() != 0,
         choosen_transitions());
 
+    if (!conv.error()) {
+        save_measured_fps(conv.stats());
+        show_stage_fps(conv.stats());
+    }
+
     if (conv.error()) {
         show_error(conv.error());
     } else if (clip_.get() == clip.get()) {
@@ -544,6 +598,52 @@ uint8_t EncoderWindow::choosen_transitions() {
     return 0;
 }
 
+vs::encoder_options_t EncoderWindow::choosen_encoder_options() {
+    vs::encoder_options_t options;
+    options.profile = static_cast<vs::encoder_profile>(cmb_profiles_->value());
+    options.thread_count = spn_threads_->value();
+    return options;
+}
+
+void EncoderWindow::update_profile_labels() {
+    const char **profiles = vs::encoder_profile_names();
+    for (int i = 0; profiles[i]; ++i) {
+        std::string fps = (*history_)[measured_fps_key(cmb_formats_->text(), profiles[i]).c_str()];
+        std::string label = profiles[i];
+        if (!fps.empty()) {
+            label += " (last conversion: " + fps + " fps)";
+        }
+        cmb_profiles_->replace(i, label.c_str());
+    }
+    cmb_profiles_->redraw();
+}
+
+void EncoderWindow::save_measured_fps(const pipeline_stats_t& stats) {
+    // the remuxed conversions do not encode
+    if (stats.encode.frames == 0 || stats.elapsed_seconds <= 0) {
+        return;
+    }
+
+    char fps[32] = "";
+    snprintf(fps, sizeof(fps), "%.1lf", stats.encode.frames / stats.elapsed_seconds);
+
+    const char *profile = vs::encoder_profile_names()[cmb_profiles_->value()];
+    history_->set(measured_fps_key(cmb_formats_->text(), profile).c_str(), fps);
+
+    update_profile_labels();
+}
+
+void EncoderWindow::show_stage_fps(const pipeline_stats_t& stats) {
+    // the frames a single thread of each stage handles by second, the slowest stage limits the conversion
+    char buffer[200] = "";
+    if (stats.decode.frames) {
+        snprintf(buffer, sizeof(buffer) - 1,
+            "Last conversion (fps by thread): decode %.1lf | render %.1lf x %u threads | encode %.1lf",
+            stage_fps(stats.decode), stage_fps(stats.render), stats.render_threads, stage_fps(stats.encode));
+    }
+    box_stages_->copy_label(buffer);
+}
+
 double EncoderWindow::choosen_fps() {
     double fps = 0;
     sscanf(edt_fps_->value(), "%lf", &fps);
@@ -620,6 +720,9 @@ uint32_t EncoderWindow::calc_bitrate() {
 
 void EncoderWindow::update_bitrate_cb(Fl_Widget* widget, void *userdata) {
     auto window = static_cast<EncoderWindow *>(userdata);
+    if (widget == window->cmb_formats_) {
+        window->update_profile_labels();
+    }
     window->bitrate_action_src_ = widget;
     window->update_bitrate();
     window->bitrate_action_src_ = NULL;
@@ -20,6 +20,7 @@
 #include <FL/Fl_Check_Button.H>
 
 #include "src/clippings/clipping.h"
+#include "src/clippings/clipping_pipeline.h"
 #include "src/vstream/video_stream.h"
 #include "src/data/json_file.h"
 #include "src/data/history.h"
@@ -62,6 +63,10 @@ class EncoderWindow {
     double choosen_fps();
     uint32_t choosen_bitrate();
     uint8_t choosen_transitions();
+    vs::encoder_options_t choosen_encoder_options();
+    void update_profile_labels();
+    void save_measured_fps(const pipeline_stats_t& stats);
+    void show_stage_fps(const pipeline_stats_t& stats);
     double calc_fps();
     double calc_duration();
     int64_t calc_filesize();
@@ -94,9 +99,12 @@ class EncoderWindow {
     Fl_Float_Input *edt_fps_;
     Fl_Button *btn_bit_;
     Fl_Box *box_file_size_;
+    Fl_Box *box_stages_;
     Fl_Check_Button *btn_start_backward_;
     Fl_Check_Button *btn_append_reverse_;
     Fl_Spinner *spn_transitions_;
+    Fl_Choice *cmb_profiles_;
+    Fl_Spinner *spn_threads_;
     Fl_Input *edt_start_;
     Fl_Input *edt_end_;
     Fl_Input *edt_title_;
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "tests/testing.h"
+#include "src/clippings/frame_store.h"
+
+namespace {
+
+const char *kSCRATCH_DIR = "data/tmp";
+const uint32_t kFRAME_SIZE = 64 * 48 * 3;
+const uint32_t kFRAME_COUNT = 12;
+
+std::vector<uint8_t> gradient_frame(uint32_t index) {
+    // smooth content with some noise, as a rendered frame would have
+    std::vector<uint8_t> frame(kFRAME_SIZE);
+    uint32_t seed = index * 7919 + 1;
+    for (uint32_t i = 0; i < kFRAME_SIZE; ++i) {
+        seed = seed * 1103515245 + 12345;
+        frame[i] = static_cast<uint8_t>((i / 3) % 64 + index * 3 + ((seed >> 16) % 4 == 0 ? 1 : 0));
+    }
+    return frame;
+}
+
+void check_round_trip(uint64_t max_memory, bool compress) {
+    vcutter::FrameStore store(kFRAME_SIZE, kFRAME_COUNT, max_memory, kSCRATCH_DIR, compress);
+
+    for (uint32_t i = 0; i < kFRAME_COUNT; ++i) {
+        std::vector<uint8_t> frame = gradient_frame(i);
+        BOOST_REQUIRE(store.put(i, &frame[0], kFRAME_SIZE, vcutter::frame_format_rgb24));
+    }
+
+    std::vector<uint8_t> buffer(kFRAME_SIZE);
+    for (uint32_t i = kFRAME_COUNT; i > 0; --i) {
+        vcutter::frame_format_t format = vcutter::frame_format_yuv420p;
+        BOOST_REQUIRE(store.get(i - 1, &buffer[0], &format));
+        BOOST_CHECK_EQUAL(format, vcutter::frame_format_rgb24);
+        BOOST_CHECK(buffer == gradient_frame(i - 1));
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(frame_store_tests)
+
+BOOST_AUTO_TEST_CASE(test_frame_store_memory_only) {
+    vcutter::FrameStore store(kFRAME_SIZE, kFRAME_COUNT, kFRAME_SIZE * kFRAME_COUNT, kSCRATCH_DIR);
+    BOOST_CHECK_EQUAL(store.memory_frames(), kFRAME_COUNT);
+    BOOST_CHECK_EQUAL(store.spilled_frames(), 0u);
+    check_round_trip(kFRAME_SIZE * kFRAME_COUNT, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_store_spills_to_disk) {
+    check_round_trip(kFRAME_SIZE * 4, false);
+    check_round_trip(0, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_store_compression) {
+    check_round_trip(kFRAME_SIZE * 4, true);
+
+    vcutter::FrameStore store(kFRAME_SIZE, 2, 0, kSCRATCH_DIR, true);
+    std::vector<uint8_t> flat(kFRAME_SIZE, 200);
+    BOOST_REQUIRE(store.put(0, &flat[0], kFRAME_SIZE, vcutter::frame_format_rgb24));
+    BOOST_CHECK(store.spilled_bytes() < kFRAME_SIZE / 10);
+
+    // yuv frames are smaller than the slots
+    std::vector<uint8_t> yuv = gradient_frame(5);
+    yuv.resize(kFRAME_SIZE / 2);
+    BOOST_REQUIRE(store.put(1, &yuv[0], yuv.size(), vcutter::frame_format_yuv420p));
+
+    std::vector<uint8_t> buffer(kFRAME_SIZE);
+    vcutter::frame_format_t format = vcutter::frame_format_rgb24;
+    BOOST_REQUIRE(store.get(1, &buffer[0], &format));
+    BOOST_CHECK_EQUAL(format, vcutter::frame_format_yuv420p);
+    BOOST_CHECK(memcmp(&buffer[0], &yuv[0], yuv.size()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_store_removes_the_scratch_file) {
+    std::vector<uint8_t> frame = gradient_frame(0);
+    std::string scratch_path;
+    {
+        vcutter::FrameStore store(kFRAME_SIZE, 1, 0, kSCRATCH_DIR);
+        BOOST_REQUIRE(store.put(0, &frame[0], kFRAME_SIZE, vcutter::frame_format_rgb24));
+        boost::filesystem::directory_iterator end;
+        for (boost::filesystem::directory_iterator it(kSCRATCH_DIR); it != end; ++it) {
+            if (it->path().extension() == ".frames") {
+                scratch_path = it->path().string();
+            }
+        }
+    }
+    BOOST_REQUIRE(!scratch_path.empty());
+    BOOST_CHECK(!boost::filesystem::exists(scratch_path));
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_store_rejects_missing_frames) {
+    vcutter::FrameStore store(kFRAME_SIZE, 2, kFRAME_SIZE * 2, kSCRATCH_DIR);
+    std::vector<uint8_t> buffer(kFRAME_SIZE);
+    vcutter::frame_format_t format;
+    BOOST_CHECK(!store.get(1, &buffer[0], &format));
+    BOOST_CHECK(store.error() != NULL);
+    BOOST_CHECK(!store.put(2, &buffer[0], kFRAME_SIZE, vcutter::frame_format_rgb24));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
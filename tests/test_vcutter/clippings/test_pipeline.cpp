@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <vector>
+#include "tests/testing.h"
+#include "src/clippings/clipping_pipeline.h"
+
+namespace {
+
+const uint32_t kFRAME_SIZE = 16;
+
+vcutter::frame_render_cb_t slow_render() {
+    return [] (const vcutter::ClippingKey& key, uint8_t *source_buffer, uint8_t *output_buffer) {
+        // out of order completion: the first frames take longer to render
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(source_buffer[0] % 3));
+        memcpy(output_buffer, source_buffer, kFRAME_SIZE);
+    };
+}
+
+void push_frames(vcutter::ClippingPipeline *pipeline, uint8_t count) {
+    uint8_t source[kFRAME_SIZE];
+    for (uint8_t i = 0; i < count; ++i) {
+        memset(source, i, sizeof(source));
+        pipeline->push(vcutter::ClippingKey(), source, i);
+    }
+}
+
+class FakeFrame: public vs::Frame {
+ public:
+    explicit FakeFrame(uint8_t value) : pixels_(kFRAME_SIZE, value) {}
+    uint32_t w() const override { return kFRAME_SIZE; }
+    uint32_t h() const override { return 1; }
+    vs::pixel_format format() const override { return vs::pixel_format_rgb24; }
+    const unsigned char *data(int plane) const override { return &pixels_[0]; }
+    int stride(int plane) const override { return kFRAME_SIZE; }
+    uint32_t position() const override { return pixels_[0]; }
+    int64_t pts() const override { return pixels_[0]; }
+    double time() const override { return pixels_[0]; }
+    bool key_frame() const override { return true; }
+ private:
+    std::vector<unsigned char> pixels_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(clipping_pipeline_tests)
+
+BOOST_AUTO_TEST_CASE(test_pipeline_keeps_the_sequence) {
+    std::vector<uint8_t> delivered;
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 8, 4, slow_render(), [&delivered] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        delivered.push_back(buffer[0]);
+        return true;
+    });
+
+    push_frames(&pipeline, 50);
+
+    BOOST_CHECK(pipeline.finish());
+    BOOST_REQUIRE_EQUAL(delivered.size(), 50u);
+    for (uint8_t i = 0; i < 50; ++i) {
+        BOOST_CHECK_EQUAL(delivered[i], i);
+    }
+
+    vcutter::pipeline_stats_t stats = pipeline.stats();
+    BOOST_CHECK_EQUAL(stats.decode.frames, 50u);
+    BOOST_CHECK_EQUAL(stats.render.frames, 50u);
+    BOOST_CHECK_EQUAL(stats.encode.frames, 50u);
+    BOOST_CHECK_EQUAL(stats.render_threads, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_push_rendered) {
+    std::vector<uint8_t> delivered;
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 4, 2, slow_render(), [&delivered] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        delivered.push_back(buffer[0]);
+        return true;
+    });
+
+    push_frames(&pipeline, 3);
+    BOOST_CHECK(pipeline.wait_delivered());
+
+    for (uint8_t i = 3; i < 6; ++i) {
+        BOOST_CHECK(pipeline.push_rendered([i] (uint8_t *buffer, vcutter::frame_format_t *format) -> bool {
+            memset(buffer, 5 - i, kFRAME_SIZE);
+            return true;
+        }, i));
+    }
+
+    BOOST_CHECK(pipeline.finish());
+
+    const uint8_t expected[] = {0, 1, 2, 2, 1, 0};
+    BOOST_REQUIRE_EQUAL(delivered.size(), sizeof(expected));
+    for (size_t i = 0; i < sizeof(expected); ++i) {
+        BOOST_CHECK_EQUAL(delivered[i], expected[i]);
+    }
+
+    vcutter::pipeline_stats_t stats = pipeline.stats();
+    BOOST_CHECK_EQUAL(stats.render.frames, 3u);
+    BOOST_CHECK_EQUAL(stats.encode.frames, 6u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_push_rendered_failure) {
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 4, 2, slow_render(), [] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        return true;
+    });
+
+    BOOST_CHECK(!pipeline.push_rendered([] (uint8_t *buffer, vcutter::frame_format_t *format) -> bool {
+        return false;
+    }, 0));
+    BOOST_CHECK(!pipeline.finish());
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_push_frame_handles) {
+    std::vector<uint8_t> delivered;
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 8, 2, slow_render(), [&delivered] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        delivered.push_back(buffer[0]);
+        return true;
+    });
+
+    std::vector<vs::frame_ref_t> frames;
+    for (uint8_t i = 0; i < 10; ++i) {
+        frames.push_back(vs::frame_ref_t(new FakeFrame(i)));
+        BOOST_CHECK(pipeline.push(vcutter::ClippingKey(), frames.back(), i));
+    }
+
+    BOOST_CHECK(pipeline.finish());
+    BOOST_REQUIRE_EQUAL(delivered.size(), 10u);
+    for (uint8_t i = 0; i < 10; ++i) {
+        BOOST_CHECK_EQUAL(delivered[i], i);
+        // the pipeline released its references once the frames were rendered
+        BOOST_CHECK_EQUAL(frames[i].use_count(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_source_memory) {
+    vcutter::frame_output_cb_t output_cb = [] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        return true;
+    };
+
+    // the frame handles are rendered in place, the whole budget goes to the output buffers
+    vcutter::ClippingPipeline handles(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 8, 4, slow_render(), output_cb);
+    for (uint8_t i = 0; i < 10; ++i) {
+        BOOST_CHECK(handles.push(vcutter::ClippingKey(), vs::frame_ref_t(new FakeFrame(i)), i));
+    }
+    BOOST_CHECK(handles.finish());
+    BOOST_CHECK_EQUAL(handles.output_slots(), 8u);
+
+    // the raw pixels are copied to source buffers that take their share of the budget
+    vcutter::ClippingPipeline copies(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 8, 4, slow_render(), output_cb);
+    push_frames(&copies, 10);
+    BOOST_CHECK(copies.finish());
+    BOOST_CHECK_LE(copies.output_slots(), 7u);
+    BOOST_CHECK_GE(copies.output_slots(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_cancel) {
+    uint32_t delivered = 0;
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 4, 2, slow_render(), [&delivered] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        ++delivered;
+        return delivered < 3;
+    });
+
+    uint8_t source[kFRAME_SIZE] = {0};
+    bool pushed = true;
+    for (uint32_t i = 0; pushed && i < 100; ++i) {
+        pushed = pipeline.push(vcutter::ClippingKey(), source, i);
+    }
+
+    BOOST_CHECK(!pushed);
+    BOOST_CHECK(!pipeline.finish());
+    BOOST_CHECK_EQUAL(delivered, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_yuv_crop) {
+    // 8x4 source planes, the pipeline crops the 4x2 area at (2, 2)
+    uint8_t luma[8 * 4];
+    uint8_t chroma_u[4 * 2];
+    uint8_t chroma_v[4 * 2];
+    for (uint8_t i = 0; i < sizeof(luma); ++i) {
+        luma[i] = i;
+    }
+    for (uint8_t i = 0; i < sizeof(chroma_u); ++i) {
+        chroma_u[i] = 100 + i;
+        chroma_v[i] = 200 + i;
+    }
+
+    vs::yuv_planes_t planes;
+    planes.data[0] = luma;
+    planes.data[1] = chroma_u;
+    planes.data[2] = chroma_v;
+    planes.linesize[0] = 8;
+    planes.linesize[1] = 4;
+    planes.linesize[2] = 4;
+
+    std::vector<uint8_t> delivered;
+    std::vector<vcutter::frame_format_t> formats;
+    vcutter::ClippingPipeline pipeline(kFRAME_SIZE, kFRAME_SIZE, kFRAME_SIZE * 8, 2, slow_render(), [&] (uint8_t *buffer, vcutter::frame_format_t format) -> bool {
+        formats.push_back(format);
+        delivered.insert(delivered.end(), buffer, buffer + (format == vcutter::frame_format_yuv420p ? 12 : 1));
+        return true;
+    });
+
+    uint8_t source[kFRAME_SIZE];
+    memset(source, 7, sizeof(source));
+    pipeline.push(vcutter::ClippingKey(), source, 1);
+    BOOST_CHECK(pipeline.push_yuv(planes, 2, 2, 4, 2, 0));
+    BOOST_CHECK(pipeline.finish());
+
+    const uint8_t expected[] = {18, 19, 20, 21, 26, 27, 28, 29, 105, 106, 205, 206, 7};
+    BOOST_REQUIRE_EQUAL(delivered.size(), sizeof(expected));
+    for (size_t i = 0; i < sizeof(expected); ++i) {
+        BOOST_CHECK_EQUAL(delivered[i], expected[i]);
+    }
+
+    BOOST_REQUIRE_EQUAL(formats.size(), 2u);
+    BOOST_CHECK_EQUAL(formats[0], vcutter::frame_format_yuv420p);
+    BOOST_CHECK_EQUAL(formats[1], vcutter::frame_format_rgb24);
+    BOOST_CHECK_EQUAL(pipeline.stats().render.frames, 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
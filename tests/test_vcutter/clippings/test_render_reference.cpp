@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <memory>
+#include <vector>
+
+#include "tests/testing.h"
+#include "benchmarks/render_reference.h"
+#include "src/clippings/clipping_render.h"
+
+namespace {
+
+const double kMIN_PSNR = 45;
+// the rotated clippings that are resized: the render interpolates once where the reference interpolates twice
+const double kMIN_RESIZED_PSNR = 35;
+
+void render(vcutter::ClippingRender *clipping, uint8_t *source, uint32_t w, uint32_t h, double angle, float scale,
+            std::vector<uint8_t> *expected, std::vector<uint8_t> *rendered, vcutter::ClippingKey *key) {
+    clipping->wh(w, h);
+
+    key->frame = 1;
+    key->px = clipping->player()->info()->w() / 2;
+    key->py = clipping->player()->info()->h() / 2;
+    key->scale = scale;
+    key->angle(angle);
+
+    expected->assign(w * h * 3, 0);
+    rendered->assign(expected->size(), 0);
+
+    vcutter::bench::reference_render(clipping, *key, source, &(*expected)[0]);
+    clipping->render(*key, source, &(*rendered)[0]);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(render_reference_tests)
+
+BOOST_AUTO_TEST_CASE(test_render_matches_the_reference) {
+    std::unique_ptr<vcutter::ClippingRender> clipping(
+        new vcutter::ClippingRender("data/sample_video.webm", true, vcutter::frame_callback_t()));
+
+    const uint32_t sizes[][2] = {{80, 180}, {320, 240}, {640, 360}};
+    const double angles[] = {0, 15, 90, 200};
+    const float scales[] = {1, 0.5};
+
+    std::vector<uint8_t> source = vcutter::bench::source_frame(clipping.get());
+    BOOST_REQUIRE_EQUAL(source.size(), clipping->player()->info()->w() * clipping->player()->info()->h() * 3);
+
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> rendered;
+    vcutter::ClippingKey key;
+
+    for (const auto& size : sizes) {
+        for (double angle : angles) {
+            for (float scale : scales) {
+                render(clipping.get(), &source[0], size[0], size[1], angle, scale, &expected, &rendered, &key);
+
+                if (angle == 0) {
+                    // crop and resize, as the reference does
+                    BOOST_CHECK_MESSAGE(expected == rendered,
+                        size[0] << "x" << size[1] << " scale " << scale << ": the render is not bit-exact");
+                    continue;
+                }
+
+                double min_psnr = scale != 1 ? kMIN_RESIZED_PSNR : kMIN_PSNR;
+                double value = vcutter::bench::render_psnr(key, &expected[0], &rendered[0], size[0], size[1]);
+                BOOST_CHECK_MESSAGE(value >= min_psnr,
+                    size[0] << "x" << size[1] << " angle " << angle << " scale " << scale << ": " << value << " dB");
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,7 @@
 /*
  * Copyright (C) 2018 by Rodrigo Antonio de Araujo
  */
+#include <string.h>
 #include "tests/testing.h"
 #include "src/common/buffers.h"
 
@@ -27,4 +28,74 @@ BOOST_AUTO_TEST_CASE(test_buffer_push_pop) {
     BOOST_CHECK(memcmp(temp2, first, 32) == 0);
 }
 
+BOOST_AUTO_TEST_CASE(test_pool_size_classes) {
+    BOOST_CHECK_EQUAL(vcutter::BufferPool::size_class(1), 4096u);
+    BOOST_CHECK_EQUAL(vcutter::BufferPool::size_class(4096), 4096u);
+    BOOST_CHECK_EQUAL(vcutter::BufferPool::size_class(4097), 5120u);
+    BOOST_CHECK_EQUAL(vcutter::BufferPool::size_class(1920 * 1080 * 3), 6291456u);
+    BOOST_CHECK_EQUAL(vcutter::BufferPool::size_class(640 * 360 * 3), 786432u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_reuses_buffers) {
+    vcutter::BufferPool pool;
+    uint32_t capacity = 0;
+
+    uint8_t *first = pool.acquire(1000000, &capacity);
+    BOOST_CHECK(capacity >= 1000000u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(first) % vcutter::BufferPool::kALIGNMENT, 0u);
+    pool.release(first, capacity);
+
+    // a slightly different size falls in the same class
+    uint8_t *second = pool.acquire(999000, &capacity);
+    BOOST_CHECK(first == second);
+
+    vcutter::buffer_pool_stats_t stats = pool.stats();
+    BOOST_CHECK_EQUAL(stats.allocations, 1u);
+    BOOST_CHECK_EQUAL(stats.reuses, 1u);
+    BOOST_CHECK_EQUAL(stats.live_bytes, capacity);
+    BOOST_CHECK_EQUAL(stats.pooled_bytes, 0u);
+
+    pool.release(second, capacity);
+}
+
+BOOST_AUTO_TEST_CASE(test_pool_counters) {
+    vcutter::BufferPool pool(8192);
+    uint32_t capacity1 = 0;
+    uint32_t capacity2 = 0;
+
+    uint8_t *buffer1 = pool.acquire(4096, &capacity1);
+    uint8_t *buffer2 = pool.acquire(4096, &capacity2);
+    BOOST_CHECK_EQUAL(pool.stats().live_bytes, 8192u);
+
+    pool.release(buffer1, capacity1);
+    pool.release(buffer2, capacity2);
+
+    uint8_t *buffer3 = pool.acquire(100000, &capacity1);
+    pool.release(buffer3, capacity1);
+
+    vcutter::buffer_pool_stats_t stats = pool.stats();
+    BOOST_CHECK_EQUAL(stats.live_bytes, 0u);
+    BOOST_CHECK_EQUAL(stats.peak_bytes, capacity1);
+    // the last buffer does not fit the limit of the pool
+    BOOST_CHECK_EQUAL(stats.pooled_bytes, 8192u);
+
+    pool.trim();
+    BOOST_CHECK_EQUAL(pool.stats().pooled_bytes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_char_buffer_resize) {
+    vcutter::CharBuffer buffer(5000);
+    uint8_t *data = buffer.data;
+    memset(data, 7, 5000);
+
+    buffer.resize(5100);
+    BOOST_CHECK(buffer.data == data);
+    BOOST_CHECK_EQUAL(buffer.data[4999], 7);
+    BOOST_CHECK_EQUAL(buffer.size(), 5100u);
+
+    buffer.resize(100000);
+    BOOST_CHECK_EQUAL(buffer.size(), 100000u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(buffer.data) % vcutter::BufferPool::kALIGNMENT, 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <boost/thread.hpp>
+#include "tests/testing.h"
+#include "src/common/triple_buffer.h"
+
+namespace {
+
+// the reader checks the fields were written together
+typedef struct {
+    uint64_t sequence;
+    uint64_t copy[16];
+} value_t;
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(triple_buffer_tests)
+
+BOOST_AUTO_TEST_CASE(test_triple_buffer_hands_the_last_value) {
+    vcutter::TripleBuffer<int> buffer;
+
+    BOOST_CHECK(!buffer.update());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    // the values not taken are skipped
+    BOOST_CHECK(buffer.update());
+    BOOST_CHECK_EQUAL(buffer.front(), 2);
+    BOOST_CHECK(!buffer.update());
+    BOOST_CHECK_EQUAL(buffer.front(), 2);
+
+    buffer.back() = 3;
+    buffer.publish();
+    BOOST_CHECK(buffer.update());
+    BOOST_CHECK_EQUAL(buffer.front(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_triple_buffer_does_not_tear) {
+    const uint64_t kVALUES = 200000;
+
+    vcutter::TripleBuffer<value_t> buffer;
+    buffer.front().sequence = 0;
+    for (uint64_t &copy : buffer.front().copy) {
+        copy = 0;
+    }
+
+    boost::thread writer([&buffer, kVALUES] () {
+        for (uint64_t i = 1; i <= kVALUES; ++i) {
+            value_t &value = buffer.back();
+            value.sequence = i;
+            for (uint64_t &copy : value.copy) {
+                copy = i;
+            }
+            buffer.publish();
+        }
+    });
+
+    bool intact = true;
+    bool in_order = true;
+    uint64_t last = 0;
+    while (last < kVALUES) {
+        if (!buffer.update()) {
+            continue;
+        }
+        const value_t &value = buffer.front();
+        for (uint64_t copy : value.copy) {
+            intact = intact && copy == value.sequence;
+        }
+        in_order = in_order && value.sequence > last;
+        last = value.sequence;
+    }
+
+    writer.join();
+
+    BOOST_CHECK(intact);
+    BOOST_CHECK(in_order);
+    BOOST_CHECK_EQUAL(last, kVALUES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
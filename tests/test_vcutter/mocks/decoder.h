@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef TESTS_TEST_VCUTTER_MOCKS_DECODER_H_
+#define TESTS_TEST_VCUTTER_MOCKS_DECODER_H_
+
+#include <vector>
+#include "src/vstream/video_stream.h"
+
+class FrameMock: public vs::Frame {
+ public:
+    FrameMock(uint32_t w, uint32_t h, uint32_t position) : w_(w), h_(h), position_(position), pixels_(w * h * 3, position) {}
+    uint32_t w() const override { return w_; }
+    uint32_t h() const override { return h_; }
+    vs::pixel_format format() const override { return vs::pixel_format_rgb24; }
+    const unsigned char *data(int plane) const override { return &pixels_[0]; }
+    int stride(int plane) const override { return w_ * 3; }
+    uint32_t position() const override { return position_; }
+    int64_t pts() const override { return position_ * 10; }
+    double time() const override { return position_ / 10.0; }
+    bool key_frame() const override { return true; }
+ private:
+    uint32_t w_;
+    uint32_t h_;
+    uint32_t position_;
+    std::vector<unsigned char> pixels_;
+};
+
+// counts the frames it decodes
+class DecoderMock: public vs::Decoder {
+ public:
+    DecoderMock(uint32_t w, uint32_t h, uint32_t count) : w_(w), h_(h), count_(count), position_(1), nexts_(0), seeks_(0), skipping_(false) {}
+    vs::source_type source() override { return vs::file_source; }
+    uint32_t w() override { return w_; }
+    uint32_t h() override { return h_; }
+    const char* error() override { return NULL; }
+    unsigned char *buffer() override { return NULL; }
+    uint32_t buffer_size() override { return w_ * h_ * 3; }
+    uint32_t position() override { return position_; }
+    uint32_t count() override { return count_; }
+    double fps() override { return 10; }
+    double duration() override { return count_ / 10.0; }
+    double time() override { return position_ / 10.0; }
+    int64_t pts() override { return position_ * 10; }
+    int ratio_den() override { return 1; }
+    int ratio_num() override { return 1; }
+    int time_den() override { return 1; }
+    int time_num() override { return 100; }
+    bool key_frame() override { return false; }
+    vs::decoder_thread_type thread_type() override { return vs::decoder_threads_none; }
+    int thread_count() override { return 1; }
+    void next() override { ++position_; ++nexts_; }
+    void prior() override { --position_; ++seeks_; }
+    void seek_frame(int64_t frame) override { position_ = frame; ++seeks_; }
+    void seek_time(int64_t ms_time) override { position_ = ms_time / 100 + 1; ++seeks_; }
+    void seek_keyframe(int64_t frame) override { seek_frame(frame); }
+    void interrupt_seek() override {}
+    uint32_t seek_generation() override { return 0; }
+    void claim_seek_generation(uint32_t generation) override {}
+    void skip_non_reference(bool skip) override { skipping_ = skip; }
+    void convert_threads(int count) override {}
+    bool save_keyframe_index(const char *path) override { return false; }
+    bool yuv_planes(vs::yuv_planes_t *planes) override { return false; }
+    vs::frame_ref_t frame() override { return vs::frame_ref_t(new FrameMock(w_, h_, position_)); }
+    vs::frame_ref_t partial_frame(const vs::frame_area_t& area) override { return frame(); }
+    vs::frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) override { return frame(); }
+    vs::frame_ref_t source_frame() override { return frame(); }
+
+    uint32_t decoded() { return nexts_ + seeks_; }
+    uint32_t nexts() { return nexts_; }
+    bool skipping() { return skipping_; }
+
+ private:
+    uint32_t w_;
+    uint32_t h_;
+    uint32_t count_;
+    uint32_t position_;
+    uint32_t nexts_;
+    uint32_t seeks_;
+    bool skipping_;
+};
+
+#endif // TESTS_TEST_VCUTTER_MOCKS_DECODER_H_
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <atomic>
+#include <vector>
+#include <boost/thread.hpp>
+#include "tests/testing.h"
+#include "src/player/command_queue.h"
+
+BOOST_AUTO_TEST_SUITE(command_queue_tests)
+
+BOOST_AUTO_TEST_CASE(test_command_queue_runs_in_order) {
+    vcutter::CommandQueue queue;
+    std::vector<int> ran;
+
+    BOOST_CHECK_EQUAL(queue.run_pending(), 0u);
+
+    for (int i = 0; i < 5; ++i) {
+        queue.push([&ran, i] () { ran.push_back(i); });
+    }
+
+    BOOST_CHECK_EQUAL(queue.run_pending(), 5u);
+    BOOST_REQUIRE_EQUAL(ran.size(), 5u);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(ran[i], i);
+    }
+    BOOST_CHECK_EQUAL(queue.run_pending(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_queue_keeps_the_last_of_a_key) {
+    vcutter::CommandQueue queue;
+    std::vector<int> ran;
+
+    queue.push([&ran] () { ran.push_back(1); }, 7);
+    queue.push([&ran] () { ran.push_back(2); });
+    queue.push([&ran] () { ran.push_back(3); }, 7);
+    queue.push([&ran] () { ran.push_back(4); }, 9);
+    queue.push([&ran] () { ran.push_back(5); }, 7);
+
+    BOOST_CHECK_EQUAL(queue.run_pending(), 3u);
+    BOOST_REQUIRE_EQUAL(ran.size(), 3u);
+    BOOST_CHECK_EQUAL(ran[0], 2);
+    BOOST_CHECK_EQUAL(ran[1], 4);
+    BOOST_CHECK_EQUAL(ran[2], 5);
+
+    // a key runs again once the former one ran
+    queue.push([&ran] () { ran.push_back(6); }, 7);
+    BOOST_CHECK_EQUAL(queue.run_pending(), 1u);
+    BOOST_CHECK_EQUAL(ran.back(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_queue_takes_many_producers) {
+    const int kPRODUCERS = 4;
+    const int kCOMMANDS = 10000;
+
+    vcutter::CommandQueue queue;
+    std::vector<int> last(kPRODUCERS, -1);
+    bool in_order = true;
+    int total = 0;
+
+    std::vector<std::shared_ptr<boost::thread> > producers;
+    for (int p = 0; p < kPRODUCERS; ++p) {
+        producers.push_back(std::shared_ptr<boost::thread>(new boost::thread([&, p] () {
+            for (int i = 0; i < kCOMMANDS; ++i) {
+                queue.push([&, p, i] () {
+                    in_order = in_order && last[p] + 1 == i;
+                    last[p] = i;
+                    ++total;
+                });
+            }
+        })));
+    }
+
+    while (total < kPRODUCERS * kCOMMANDS) {
+        queue.wait(10);
+        queue.run_pending();
+    }
+
+    for (auto producer : producers) {
+        producer->join();
+    }
+
+    BOOST_CHECK_EQUAL(queue.run_pending(), 0u);
+    BOOST_CHECK_EQUAL(total, kPRODUCERS * kCOMMANDS);
+    BOOST_CHECK(in_order);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_queue_wakes_the_consumer) {
+    vcutter::CommandQueue queue;
+    bool ran = false;
+
+    boost::thread producer([&queue, &ran] () {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+        queue.push([&ran] () { ran = true; });
+    });
+
+    // the push ends the wait long before the timeout
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    while (!ran) {
+        queue.wait(10000);
+        queue.run_pending();
+    }
+    boost::chrono::steady_clock::duration elapsed = boost::chrono::steady_clock::now() - start;
+    producer.join();
+
+    BOOST_CHECK(elapsed < boost::chrono::seconds(5));
+}
+
+BOOST_AUTO_TEST_CASE(test_command_queue_does_not_lose_wake_ups) {
+    vcutter::CommandQueue queue;
+    const int kCOMMANDS = 2000;
+    std::atomic_int ran(0);
+
+    // the pushes race with the consumer going to sleep
+    boost::thread producer([&queue, &ran] () {
+        for (int i = 0; i < kCOMMANDS; ++i) {
+            if (i % 4 == 0) {
+                boost::this_thread::sleep_for(boost::chrono::microseconds(50));
+            }
+            queue.push([&ran] () { ++ran; });
+        }
+    });
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    while (ran.load() < kCOMMANDS) {
+        queue.wait(10000);
+        queue.run_pending();
+    }
+    boost::chrono::steady_clock::duration elapsed = boost::chrono::steady_clock::now() - start;
+    producer.join();
+
+    BOOST_CHECK(elapsed < boost::chrono::seconds(5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <atomic>
+#include <boost/thread.hpp>
+#include "tests/testing.h"
+#include "tests/test_vcutter/mocks/decoder.h"
+#include "src/player/decode_ahead.h"
+
+namespace {
+
+// every frame is late
+class FarClock: public vcutter::PlaybackClock {
+ public:
+    FarClock() : now_(0) {}
+    void jump() { now_ = 3600000000LL; }
+ protected:
+    int64_t now_us() override { return now_; }
+ private:
+    int64_t now_;
+};
+
+bool advance(vs::Decoder *decoder) {
+    if (decoder->position() >= decoder->count()) {
+        return false;
+    }
+    decoder->next();
+    return true;
+}
+
+void wait_finished(vcutter::DecodeAhead *ahead) {
+    for (int i = 0; i < 5000 && !ahead->finished(); ++i) {
+        if (ahead->front()) {
+            return;
+        }
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    }
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(decode_ahead_tests)
+
+BOOST_AUTO_TEST_CASE(test_decode_ahead_queues_the_frames_in_order) {
+    std::shared_ptr<DecoderMock> decoder(new DecoderMock(64, 36, 30));
+    vcutter::PlaybackClock clock;
+    std::atomic_int ready(0);
+    {
+        vcutter::DecodeAhead ahead(decoder, &clock, 4, true, advance, [] (vs::Decoder *decoder) {
+            return decoder->frame();
+        }, [&ready] () {
+            ++ready;
+        });
+
+        uint32_t expected = 2;
+        while (!ahead.finished()) {
+            wait_finished(&ahead);
+            vs::frame_ref_t frame = ahead.front();
+            if (frame) {
+                BOOST_CHECK_EQUAL(frame->position(), expected);
+                ++expected;
+                ahead.pop();
+            }
+        }
+
+        BOOST_CHECK_EQUAL(expected, 31u);
+        BOOST_CHECK_EQUAL(ahead.dropped(), 0u);
+        BOOST_CHECK(ready.load() > 0);
+    }
+    // the codec decodes all the frames again
+    BOOST_CHECK(!decoder->skipping());
+    BOOST_CHECK_EQUAL(decoder->position(), 30u);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_ahead_does_not_convert_late_frames) {
+    std::shared_ptr<DecoderMock> decoder(new DecoderMock(64, 36, 50));
+    FarClock clock;
+    clock.start(1, 25, 1.0);
+    clock.jump();
+    std::atomic_int converted(0);
+
+    vcutter::DecodeAhead ahead(decoder, &clock, 8, false, advance, [&converted] (vs::Decoder *decoder) {
+        ++converted;
+        return decoder->frame();
+    }, [] () {});
+
+    while (!ahead.finished() && ahead.dropped() + converted < 49u) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+    }
+
+    // the first one is kept to be shown, the others are dropped
+    BOOST_CHECK_EQUAL(converted.load(), 1);
+    BOOST_CHECK_EQUAL(ahead.dropped(), 48u);
+    BOOST_REQUIRE(ahead.front());
+    BOOST_CHECK_EQUAL(ahead.front()->position(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <vector>
+#include "tests/testing.h"
+#include "src/player/frame_cache.h"
+
+namespace {
+
+const uint32_t kFRAME_SIZE = 100;
+
+void put_frame(vcutter::FrameCache *cache, uint32_t position) {
+    uint8_t buffer[kFRAME_SIZE];
+    memset(buffer, position, sizeof(buffer));
+    cache->put(position, position * 10, position / 10.0, false, buffer, sizeof(buffer));
+}
+
+class FakeFrame: public vs::Frame {
+ public:
+    FakeFrame(uint32_t position, uint8_t value) : position_(position), pixels_(kFRAME_SIZE, value) {}
+    uint32_t w() const override { return kFRAME_SIZE / 3; }
+    uint32_t h() const override { return 1; }
+    vs::pixel_format format() const override { return vs::pixel_format_rgb24; }
+    const unsigned char *data(int plane) const override { return &pixels_[0]; }
+    int stride(int plane) const override { return kFRAME_SIZE; }
+    uint32_t position() const override { return position_; }
+    int64_t pts() const override { return position_ * 10; }
+    double time() const override { return position_ / 10.0; }
+    bool key_frame() const override { return true; }
+ private:
+    uint32_t position_;
+    std::vector<unsigned char> pixels_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(frame_cache_tests)
+
+BOOST_AUTO_TEST_CASE(test_frame_cache_hit_miss) {
+    vcutter::FrameCache cache(kFRAME_SIZE * 10);
+    put_frame(&cache, 5);
+
+    vcutter::cached_frame_t frame = cache.get(5);
+    BOOST_REQUIRE(frame);
+    BOOST_CHECK_EQUAL(frame->position, 5u);
+    BOOST_CHECK_EQUAL(frame->pts, 50);
+    BOOST_CHECK_EQUAL(frame->data()[kFRAME_SIZE - 1], 5);
+
+    BOOST_CHECK(!cache.get(6));
+    BOOST_CHECK_EQUAL(cache.hits(), 1u);
+    BOOST_CHECK_EQUAL(cache.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_cache_evicts_least_recently_used) {
+    vcutter::FrameCache cache(kFRAME_SIZE * 3);
+    put_frame(&cache, 1);
+    put_frame(&cache, 2);
+    put_frame(&cache, 3);
+
+    BOOST_CHECK(cache.get(1));  // 2 becomes the least recently used
+
+    put_frame(&cache, 4);
+
+    BOOST_CHECK(cache.contains(1));
+    BOOST_CHECK(!cache.contains(2));
+    BOOST_CHECK(cache.contains(3));
+    BOOST_CHECK(cache.contains(4));
+    BOOST_CHECK_EQUAL(cache.bytes(), kFRAME_SIZE * 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_cache_replace_and_clear) {
+    vcutter::FrameCache cache(kFRAME_SIZE * 3);
+    put_frame(&cache, 1);
+    put_frame(&cache, 1);
+    BOOST_CHECK_EQUAL(cache.bytes(), kFRAME_SIZE);
+
+    vcutter::cached_frame_t frame = cache.get(1);
+    cache.clear();
+    BOOST_CHECK(!cache.contains(1));
+    BOOST_CHECK_EQUAL(cache.bytes(), 0u);
+    BOOST_CHECK_EQUAL(frame->data()[0], 1);  // still valid for who holds it
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_cache_shares_frames) {
+    vcutter::FrameCache cache(kFRAME_SIZE * 2);
+    vs::frame_ref_t decoded(new FakeFrame(7, 3));
+
+    cache.put(decoded);
+    vcutter::cached_frame_t frame = cache.get(7);
+    BOOST_REQUIRE(frame);
+    BOOST_CHECK(frame->data() == decoded->data());
+    BOOST_CHECK_EQUAL(frame->pts, 70);
+    BOOST_CHECK(frame->key_frame);
+    BOOST_CHECK_EQUAL(cache.bytes(), kFRAME_SIZE);
+
+    put_frame(&cache, 8);
+    put_frame(&cache, 9);
+    BOOST_CHECK(!cache.contains(7));
+    BOOST_CHECK_EQUAL(decoded.use_count(), 2);  // the test and the evicted frame it still holds
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "tests/testing.h"
+#include "tests/test_vcutter/mocks/decoder.h"
+#include "src/player/frame_prefetcher.h"
+
+namespace {
+
+const uint64_t kCACHE_BYTES = 64 * 36 * 3 * 200;
+
+uint32_t prefetch_all(vcutter::FramePrefetcher *prefetcher) {
+    uint32_t steps = 0;
+    while (prefetcher->step()) {
+        ++steps;
+    }
+    return steps;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(frame_prefetcher_tests)
+
+BOOST_AUTO_TEST_CASE(test_frame_prefetcher_fills_the_window) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<vcutter::CachedDecoder> decoder(new vcutter::CachedDecoder(source, kCACHE_BYTES));
+    vcutter::FramePrefetcher prefetcher(decoder, 6, 3);
+
+    decoder->seek_frame(50);
+    prefetcher.key_frames({80});
+    BOOST_CHECK_EQUAL(prefetch_all(&prefetcher), 11u);
+
+    vcutter::FrameCache *cache = decoder->cache();
+    for (uint32_t frame = 47; frame <= 56; ++frame) {
+        BOOST_CHECK(cache->contains(frame));
+    }
+    BOOST_CHECK(cache->contains(80));
+    BOOST_CHECK(cache->contains(81));
+    BOOST_CHECK(!cache->contains(57));
+    BOOST_CHECK(!cache->contains(46));
+
+    // the current frame did not change
+    BOOST_CHECK_EQUAL(decoder->position(), 50u);
+    BOOST_CHECK_EQUAL(decoder->frame()->position(), 50u);
+
+    // the steps do not decode
+    uint32_t decoded = source->decoded();
+    decoder->next();
+    decoder->prior();
+    decoder->prior();
+    decoder->seek_frame(80);
+    decoder->next();
+    BOOST_CHECK_EQUAL(decoder->position(), 81u);
+    BOOST_CHECK_EQUAL(source->decoded(), decoded);
+
+    // the window follows the current frame
+    BOOST_CHECK(prefetcher.step());
+    BOOST_CHECK(cache->contains(82));
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_prefetcher_starts_over_on_moves) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<vcutter::CachedDecoder> decoder(new vcutter::CachedDecoder(source, kCACHE_BYTES));
+    vcutter::FramePrefetcher prefetcher(decoder, 2, 2);
+
+    decoder->seek_frame(1);
+    BOOST_CHECK_EQUAL(prefetch_all(&prefetcher), 2u);
+    BOOST_CHECK(decoder->cache()->contains(3));
+
+    decoder->seek_frame(100);
+    BOOST_CHECK_EQUAL(prefetch_all(&prefetcher), 2u);
+    BOOST_CHECK(decoder->cache()->contains(98));
+    BOOST_CHECK(decoder->cache()->contains(99));
+    BOOST_CHECK(!decoder->cache()->contains(101));
+
+    prefetcher.key_frames({20});
+    BOOST_CHECK_EQUAL(prefetch_all(&prefetcher), 2u);
+    BOOST_CHECK(decoder->cache()->contains(21));
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_prefetcher_uses_half_the_cache) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<vcutter::CachedDecoder> decoder(new vcutter::CachedDecoder(source, 64 * 36 * 3 * 8));
+    vcutter::FramePrefetcher prefetcher(decoder, 16, 8);
+
+    decoder->seek_frame(50);
+    BOOST_CHECK_EQUAL(prefetch_all(&prefetcher), 4u);
+    BOOST_CHECK(decoder->cache()->contains(51));
+    BOOST_CHECK(decoder->cache()->contains(54));
+    BOOST_CHECK(decoder->cache()->contains(50));
+}
+
+BOOST_AUTO_TEST_CASE(test_cached_decoder_follows_the_source) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<vcutter::CachedDecoder> decoder(new vcutter::CachedDecoder(source, kCACHE_BYTES));
+
+    decoder->seek_frame(50);
+    BOOST_CHECK_EQUAL(decoder->frame()->position(), 50u);
+    uint64_t bytes = decoder->cache()->bytes();
+
+    // the frames read from the source directly are not cached
+    source->seek_frame(70);
+    source->next();
+    source->frame();
+    decoder->follow_source();
+    BOOST_CHECK_EQUAL(decoder->cache()->bytes(), bytes);
+    BOOST_CHECK_EQUAL(decoder->position(), 71u);
+    BOOST_CHECK(!decoder->cache()->contains(71));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
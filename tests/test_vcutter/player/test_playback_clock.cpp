@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "tests/testing.h"
+#include "src/player/playback_clock.h"
+
+namespace {
+
+class ManualClock: public vcutter::PlaybackClock {
+ public:
+    ManualClock() : now_(0) {}
+    void advance_ms(int64_t ms) { now_ += ms * 1000; }
+ protected:
+    int64_t now_us() override { return now_; }
+ private:
+    int64_t now_;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(playback_clock_tests)
+
+BOOST_AUTO_TEST_CASE(test_playback_clock_stopped) {
+    ManualClock clock;
+    BOOST_CHECK(!clock.running());
+    BOOST_CHECK_EQUAL(clock.wait_time(100), 0);
+    BOOST_CHECK(!clock.late(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_playback_clock_due_frames) {
+    ManualClock clock;
+    clock.advance_ms(5000);
+    clock.start(10, 25, 1.0);
+    BOOST_CHECK(clock.running());
+
+    BOOST_CHECK_SMALL(clock.wait_time(10), 0.0001);
+    BOOST_CHECK_CLOSE(clock.wait_time(35), 1.0, 0.0001);
+
+    // the time decoding does not delay the next frames
+    clock.advance_ms(500);
+    BOOST_CHECK_CLOSE(clock.wait_time(35), 0.5, 0.0001);
+    BOOST_CHECK(clock.wait_time(20) < 0);
+
+    // late once past due by more than a frame (40 ms)
+    BOOST_CHECK(clock.late(10));
+    BOOST_CHECK(!clock.late(22));
+    BOOST_CHECK(!clock.late(30));
+
+    clock.stop();
+    BOOST_CHECK(!clock.late(10));
+}
+
+BOOST_AUTO_TEST_CASE(test_playback_clock_speed) {
+    ManualClock clock;
+    clock.start(1, 25, 2.0);
+    BOOST_CHECK_CLOSE(clock.speed(), 2.0, 0.0001);
+    BOOST_CHECK_CLOSE(clock.wait_time(51), 1.0, 0.0001);
+
+    clock.start(1, 25, 0.2);
+    BOOST_CHECK_CLOSE(clock.wait_time(6), 1.0, 0.0001);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
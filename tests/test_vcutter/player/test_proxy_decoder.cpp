@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include "tests/testing.h"
+#include "tests/test_vcutter/mocks/decoder.h"
+#include "src/player/proxy_decoder.h"
+
+namespace {
+
+// the proxy container has another time base
+class ProxyFrameMock: public FrameMock {
+ public:
+    ProxyFrameMock(uint32_t w, uint32_t h, uint32_t position) : FrameMock(w, h, position) {}
+    int64_t pts() const override { return position() * 1000; }
+};
+
+class ProxyMock: public DecoderMock {
+ public:
+    ProxyMock(uint32_t w, uint32_t h, uint32_t count) : DecoderMock(w, h, count) {}
+    int64_t pts() override { return position() * 1000; }
+    vs::frame_ref_t frame() override { return vs::frame_ref_t(new ProxyFrameMock(w(), h(), position())); }
+    vs::frame_ref_t scaled_frame(uint32_t max_w, uint32_t max_h) override { return frame(); }
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(proxy_decoder_tests)
+
+BOOST_AUTO_TEST_CASE(test_proxy_decoder_without_proxy) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    vcutter::ProxyDecoder decoder(source);
+
+    decoder.seek_frame(10);
+    decoder.next();
+    BOOST_CHECK_EQUAL(source->position(), 11u);
+    BOOST_CHECK_EQUAL(decoder.position(), 11u);
+    BOOST_CHECK(!decoder.has_proxy());
+    BOOST_CHECK(!decoder.proxy_frame(11));
+    BOOST_CHECK_EQUAL(decoder.scaled_frame(32, 18)->w(), 64u);
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_decoder_moves_without_decoding) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<DecoderMock> proxy(new ProxyMock(32, 18, 100));
+    vcutter::ProxyDecoder decoder(source);
+    BOOST_REQUIRE(decoder.attach(proxy));
+
+    decoder.seek_frame(50);
+    decoder.next();
+    decoder.prior();
+    decoder.prior();
+    BOOST_CHECK_EQUAL(decoder.position(), 49u);
+    BOOST_CHECK_EQUAL(source->decoded(), 0u);
+    BOOST_CHECK_EQUAL(proxy->decoded(), 0u);
+
+    // the display frames come from the proxy
+    vs::frame_ref_t frame = decoder.scaled_frame(640, 360);
+    BOOST_CHECK_EQUAL(frame->w(), 32u);
+    BOOST_CHECK_EQUAL(frame->position(), 49u);
+    // the presented frame has the timing of the original
+    BOOST_CHECK_EQUAL(frame->pts(), 490);
+    BOOST_CHECK(!frame->key_frame());
+    BOOST_CHECK_CLOSE(decoder.time(), 4.9, 0.001);
+    BOOST_CHECK_EQUAL(decoder.pts(), 490);
+    BOOST_CHECK(!decoder.key_frame());
+    BOOST_CHECK_EQUAL(source->decoded(), 0u);
+
+    // the full frame comes from the original
+    frame = decoder.frame();
+    BOOST_CHECK_EQUAL(frame->w(), 64u);
+    BOOST_CHECK_EQUAL(frame->position(), 49u);
+    BOOST_CHECK_EQUAL(source->position(), 49u);
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_decoder_reads_the_original_in_sequence) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    std::shared_ptr<DecoderMock> proxy(new DecoderMock(32, 18, 100));
+    vcutter::ProxyDecoder decoder(source);
+    BOOST_REQUIRE(decoder.attach(proxy));
+
+    decoder.seek_frame(20);
+    BOOST_CHECK_EQUAL(decoder.frame()->position(), 20u);
+    for (int i = 0; i < 10; ++i) {
+        decoder.next();
+        BOOST_CHECK_EQUAL(decoder.frame()->position(), 21u + i);
+    }
+
+    // a single seek, then one step by frame
+    BOOST_CHECK_EQUAL(source->decoded(), 11u);
+    BOOST_CHECK_EQUAL(source->nexts(), 10u);
+    BOOST_CHECK_EQUAL(proxy->decoded(), 0u);
+
+    BOOST_CHECK_EQUAL(decoder.proxy_frame(30)->w(), 32u);
+    BOOST_CHECK_EQUAL(proxy->position(), 30u);
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_decoder_rejects_other_videos) {
+    std::shared_ptr<DecoderMock> source(new DecoderMock(64, 36, 100));
+    vcutter::ProxyDecoder decoder(source);
+
+    BOOST_CHECK(!decoder.attach(std::shared_ptr<DecoderMock>(new DecoderMock(32, 18, 50))));
+    BOOST_CHECK(!decoder.attach(std::shared_ptr<DecoderMock>(new DecoderMock(32, 32, 100))));
+    BOOST_CHECK(!decoder.has_proxy());
+    BOOST_CHECK(decoder.attach(std::shared_ptr<DecoderMock>(new DecoderMock(32, 18, 99))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include "tests/testing.h"
+#include "src/player/thumbnail_strip.h"
+
+namespace {
+
+const char *kVIDEO_PATH = "data/sample_video.webm";
+const char *kSTRIP_PATH = "data/tmp/test_thumbnail_strip.thumbnails";
+const uint32_t kSLOTS = 16;
+
+std::shared_ptr<vcutter::ThumbnailStrip> open_strip(uint32_t slots) {
+    return vcutter::ThumbnailStrip::open(kVIDEO_PATH, kSTRIP_PATH, slots, 64, 36);
+}
+
+bool wait_finished(vcutter::ThumbnailStrip *strip) {
+    for (int i = 0; i < 200 && !strip->finished(); ++i) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    }
+    return strip->finished();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(thumbnail_strip_tests)
+
+BOOST_AUTO_TEST_CASE(test_thumbnail_strip_cache_round_trip) {
+    boost::filesystem::create_directories("data/tmp");
+    boost::filesystem::remove(kSTRIP_PATH);
+
+    std::shared_ptr<vcutter::ThumbnailStrip> decoded = open_strip(kSLOTS);
+    BOOST_REQUIRE(wait_finished(decoded.get()));
+    BOOST_REQUIRE(decoded->frame_count() > 0);
+    BOOST_CHECK(boost::filesystem::exists(kSTRIP_PATH));
+
+    // loaded at once, a single version
+    std::shared_ptr<vcutter::ThumbnailStrip> loaded = open_strip(kSLOTS);
+    BOOST_REQUIRE(wait_finished(loaded.get()));
+    BOOST_CHECK_EQUAL(loaded->version(), 1u);
+    BOOST_CHECK_EQUAL(loaded->frame_count(), decoded->frame_count());
+
+    for (uint32_t frame = 1; frame <= decoded->frame_count(); ++frame) {
+        vcutter::thumbnail_ref_t expected = decoded->thumbnail(frame);
+        vcutter::thumbnail_ref_t thumbnail = loaded->thumbnail(frame);
+        BOOST_REQUIRE_EQUAL(!expected, !thumbnail);
+        if (!expected) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(thumbnail->position, expected->position);
+        BOOST_REQUIRE_EQUAL(thumbnail->w, expected->w);
+        BOOST_REQUIRE_EQUAL(thumbnail->h, expected->h);
+        BOOST_CHECK(memcmp(thumbnail->pixels->data, expected->pixels->data, expected->w * expected->h * 3) == 0);
+    }
+
+    // another layout decodes the video again
+    std::shared_ptr<vcutter::ThumbnailStrip> other = open_strip(kSLOTS / 2);
+    BOOST_REQUIRE(wait_finished(other.get()));
+    BOOST_CHECK(other->thumbnail(1));
+    BOOST_CHECK_EQUAL(other->slots(), kSLOTS / 2);
+
+    boost::filesystem::remove(kSTRIP_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(test_thumbnail_strip_released_while_decoding) {
+    boost::filesystem::remove(kSTRIP_PATH);
+
+    // the thread keeps decoding on its own copy and stops soon
+    open_strip(kSLOTS);
+    std::shared_ptr<vcutter::ThumbnailStrip> strip = open_strip(kSLOTS);
+    BOOST_CHECK(wait_finished(strip.get()));
+
+    boost::filesystem::remove(kSTRIP_PATH);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <stdlib.h>
+#include <vector>
+#include <FL/Fl.H>
+#include <FL/Fl_Gl_Window.H>
+#include <FL/gl.h>
+#include "tests/testing.h"
+#include "src/viewer/texture_stream.h"
+
+namespace {
+
+// the gl tests need a display (run them with xvfb-run on the headless machines)
+bool has_display() {
+    if (getenv("DISPLAY")) {
+        return true;
+    }
+    BOOST_TEST_MESSAGE("no DISPLAY, skipping the texture stream test");
+    return false;
+}
+
+std::vector<uint8_t> pattern(uint32_t w, uint32_t h, bool rgba, uint8_t seed) {
+    std::vector<uint8_t> result(w * h * (rgba ? 4 : 3));
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = static_cast<uint8_t>(i * 7 + seed);
+    }
+    return result;
+}
+
+std::vector<uint8_t> texture_pixels(vcutter::TextureStream *texture, bool rgba) {
+    std::vector<uint8_t> result(texture->w() * texture->h() * (rgba ? 4 : 3));
+    texture->bind();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, rgba ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, &result[0]);
+    return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(texture_stream_tests)
+
+BOOST_AUTO_TEST_CASE(test_texture_stream_uploads_the_frames) {
+    if (!has_display()) {
+        return;
+    }
+
+    Fl_Gl_Window window(0, 0, 64, 64);
+    window.show();
+    Fl::check();
+    window.make_current();
+
+    vcutter::TextureStream texture;
+
+    // odd sizes use the byte alignment, the same size twice reuses the texture storage
+    uint32_t sizes[][2] = {{7, 5}, {7, 5}, {64, 32}, {64, 32}, {3, 3}};
+    for (int i = 0; i < 5; ++i) {
+        for (int rgba = 0; rgba < 2; ++rgba) {
+            std::vector<uint8_t> frame = pattern(sizes[i][0], sizes[i][1], rgba, i);
+            BOOST_REQUIRE(texture.upload(&frame[0], sizes[i][0], sizes[i][1], rgba));
+            BOOST_CHECK_EQUAL(texture.w(), sizes[i][0]);
+            BOOST_CHECK_EQUAL(texture.h(), sizes[i][1]);
+            BOOST_CHECK(texture_pixels(&texture, rgba) == frame);
+        }
+    }
+
+    BOOST_TEST_MESSAGE("pixel buffers: " << texture.uses_pixel_buffers());
+    BOOST_CHECK_EQUAL(glGetError(), GL_NO_ERROR);
+
+    texture.release();
+    BOOST_CHECK(!texture.bind());
+    window.hide();
+}
+
+BOOST_AUTO_TEST_CASE(test_texture_stream_rejects_empty_frames) {
+    if (!has_display()) {
+        return;
+    }
+
+    Fl_Gl_Window window(0, 0, 64, 64);
+    window.show();
+    Fl::check();
+    window.make_current();
+
+    vcutter::TextureStream texture;
+    uint8_t pixel[3] = {1, 2, 3};
+    BOOST_CHECK(!texture.upload(NULL, 1, 1));
+    BOOST_CHECK(!texture.upload(pixel, 0, 1));
+    BOOST_CHECK(!texture.bind());
+
+    window.hide();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
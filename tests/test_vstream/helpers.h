@@ -0,0 +1,17 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#ifndef TESTS_TEST_VSTREAM_HELPERS_H_
+#define TESTS_TEST_VSTREAM_HELPERS_H_
+
+#include <vector>
+#include "src/vstream/video_stream.h"
+
+const char *const kVIDEO_PATH = "data/sample_video.webm";
+
+// the rgb pixels of the current frame, they change when the decoder moves
+inline std::vector<unsigned char> frame_copy(vs::Decoder *decoder) {
+    return std::vector<unsigned char>(decoder->buffer(), decoder->buffer() + decoder->w() * decoder->h() * 3);
+}
+
+#endif  // TESTS_TEST_VSTREAM_HELPERS_H_
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <vector>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+namespace {
+
+std::shared_ptr<vs::Decoder> open_video(vs::decoder_thread_type thread_type, int thread_count) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = thread_type;
+    options.thread_count = thread_count;
+    return vs::open_file(kVIDEO_PATH, NULL, options);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(decoder_threads_tests)
+
+BOOST_AUTO_TEST_CASE(test_thread_type_is_reported) {
+    std::shared_ptr<vs::Decoder> decoder = open_video(vs::decoder_threads_none, 0);
+    BOOST_REQUIRE(decoder->error() == NULL);
+    BOOST_CHECK_EQUAL(decoder->thread_type(), vs::decoder_threads_none);
+    BOOST_CHECK_EQUAL(decoder->thread_count(), 1);
+
+    decoder = open_video(vs::decoder_threads_frame, 4);
+    BOOST_REQUIRE(decoder->error() == NULL);
+    BOOST_CHECK_EQUAL(decoder->thread_type(), vs::decoder_threads_frame);
+    BOOST_CHECK_EQUAL(decoder->thread_count(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_threads_keep_the_frame_numbers) {
+    std::shared_ptr<vs::Decoder> single = open_video(vs::decoder_threads_none, 0);
+    std::shared_ptr<vs::Decoder> threaded = open_video(vs::decoder_threads_frame, 4);
+    BOOST_REQUIRE(single->error() == NULL);
+    BOOST_REQUIRE(threaded->error() == NULL);
+
+    // the frames held by the threads are returned at the end of the file
+    std::vector<std::vector<unsigned char> > frames;
+    frames.push_back(frame_copy(single.get()));
+    BOOST_CHECK(frame_copy(threaded.get()) == frames.back());
+    while (single->position() < single->count()) {
+        uint32_t position = single->position();
+        single->next();
+        threaded->next();
+        if (single->position() == position) {
+            break;
+        }
+        BOOST_CHECK_EQUAL(threaded->position(), single->position());
+        BOOST_CHECK_EQUAL(threaded->pts(), single->pts());
+        frames.push_back(frame_copy(single.get()));
+        BOOST_CHECK(frame_copy(threaded.get()) == frames.back());
+    }
+    BOOST_CHECK_EQUAL(threaded->position(), single->position());
+
+    // the seeks flush the decoder
+    const int64_t targets[] = {25, 2, 17, 18, 30, 5, 29, 1};
+    for (int64_t target : targets) {
+        threaded->seek_frame(target);
+        BOOST_CHECK_EQUAL(threaded->position(), target);
+        BOOST_CHECK(frame_copy(threaded.get()) == frames[target - 1]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "tests/testing.h"
+#include "src/vstream/video_stream.h"
+
+namespace {
+
+const char *kOUTPUT_PATH = "data/tmp/test_encoder_profiles.webm";
+const unsigned int kWIDTH = 320;
+const unsigned int kHEIGHT = 240;
+const int kFRAMES = 12;
+
+bool encode(vs::encoder_profile profile, int thread_count) {
+    boost::filesystem::remove(kOUTPUT_PATH);
+
+    vs::encoder_options_t options;
+    options.profile = profile;
+    options.thread_count = thread_count;
+
+    std::shared_ptr<vs::Encoder> encoder = vs::encoder(
+        "webm", kOUTPUT_PATH, kWIDTH, kHEIGHT, 1000, 24000,
+        vs::Encoder::default_bitrate("webm", kWIDTH, kHEIGHT, 24), NULL, NULL, NULL, 0, options);
+    if (encoder->error()) {
+        return false;
+    }
+
+    std::vector<unsigned char> buffer(kWIDTH * kHEIGHT * 3);
+    for (int i = 0; i < kFRAMES; ++i) {
+        for (size_t p = 0; p < buffer.size(); ++p) {
+            buffer[p] = static_cast<unsigned char>(p + i * 7);
+        }
+        if (!encoder->frame(&buffer[0])) {
+            return false;
+        }
+    }
+
+    return encoder->finish();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(encoder_profiles_tests)
+
+BOOST_AUTO_TEST_CASE(test_profile_names) {
+    const char **names = vs::encoder_profile_names();
+    BOOST_CHECK_EQUAL(std::string(names[vs::encoder_profile_draft]), "draft");
+    BOOST_CHECK_EQUAL(std::string(names[vs::encoder_profile_balanced]), "balanced");
+    BOOST_CHECK_EQUAL(std::string(names[vs::encoder_profile_archival]), "archival");
+    BOOST_CHECK(names[3] == NULL);
+}
+
+BOOST_AUTO_TEST_CASE(test_every_profile_encodes) {
+    const vs::encoder_profile profiles[] = {
+        vs::encoder_profile_draft, vs::encoder_profile_balanced, vs::encoder_profile_archival
+    };
+
+    for (vs::encoder_profile profile : profiles) {
+        BOOST_REQUIRE(encode(profile, profile == vs::encoder_profile_draft ? 2 : 0));
+
+        std::shared_ptr<vs::Decoder> decoder = vs::open_file(kOUTPUT_PATH);
+        BOOST_REQUIRE(decoder->error() == NULL);
+        BOOST_CHECK_EQUAL(decoder->w(), kWIDTH);
+        BOOST_CHECK_EQUAL(decoder->h(), kHEIGHT);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
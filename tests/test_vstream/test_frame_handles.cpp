@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <vector>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+namespace {
+
+std::vector<unsigned char> handle_copy(vs::frame_ref_t frame) {
+    return std::vector<unsigned char>(frame->data(), frame->data() + frame->stride() * frame->h());
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(frame_handle_tests)
+
+BOOST_AUTO_TEST_CASE(test_frame_handle_survives_the_next_frames) {
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(kVIDEO_PATH);
+    BOOST_REQUIRE(decoder->error() == NULL);
+
+    vs::frame_ref_t first = decoder->frame();
+    BOOST_REQUIRE(first);
+    BOOST_CHECK_EQUAL(first->w(), decoder->w());
+    BOOST_CHECK_EQUAL(first->h(), decoder->h());
+    BOOST_CHECK_EQUAL(first->format(), vs::pixel_format_rgb24);
+    BOOST_CHECK_EQUAL(first->stride(), static_cast<int>(decoder->w() * 3));
+    BOOST_CHECK_EQUAL(first->position(), 1u);
+    BOOST_CHECK(first->data() == decoder->buffer());
+
+    std::vector<unsigned char> expected = frame_copy(decoder.get());
+
+    for (int i = 0; i < 10; ++i) {
+        decoder->next();
+        BOOST_CHECK(decoder->buffer() != first->data());
+    }
+
+    BOOST_CHECK(handle_copy(first) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_handle_backwards) {
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(kVIDEO_PATH);
+    BOOST_REQUIRE(decoder->error() == NULL);
+
+    decoder->seek_frame(20);
+    decoder->prior();
+    vs::frame_ref_t frame = decoder->frame();
+    BOOST_REQUIRE(frame);
+    BOOST_CHECK_EQUAL(frame->position(), 19u);
+    BOOST_CHECK(frame->data() == decoder->buffer());
+    // the frames stepped backwards are kept in rgb only
+    BOOST_CHECK(!decoder->source_frame());
+
+    std::vector<unsigned char> expected = handle_copy(frame);
+    decoder->seek_frame(3);
+    BOOST_CHECK(handle_copy(frame) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_source_frame_has_the_codec_strides) {
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(kVIDEO_PATH);
+    BOOST_REQUIRE(decoder->error() == NULL);
+
+    vs::frame_ref_t frame = decoder->source_frame();
+    BOOST_REQUIRE(frame);
+    BOOST_REQUIRE_EQUAL(frame->format(), vs::pixel_format_yuv420p);
+    BOOST_CHECK(frame->stride(0) >= static_cast<int>(decoder->w()));
+    BOOST_CHECK(frame->stride(1) >= static_cast<int>(decoder->w() / 2));
+
+    vs::yuv_planes_t planes;
+    BOOST_REQUIRE(decoder->yuv_planes(&planes));
+    BOOST_CHECK(planes.data[0] == frame->data(0));
+
+    decoder->next();
+    decoder->next();
+    BOOST_CHECK(decoder->yuv_planes(&planes));
+    BOOST_CHECK(planes.data[0] != frame->data(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
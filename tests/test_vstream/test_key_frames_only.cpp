@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <vector>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+BOOST_AUTO_TEST_SUITE(key_frames_only_tests)
+
+BOOST_AUTO_TEST_CASE(test_key_frames_only_decoder_skips_to_the_key_frames) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = vs::decoder_threads_none;
+    std::shared_ptr<vs::Decoder> all = vs::open_file(kVIDEO_PATH, NULL, options);
+    options.key_frames_only = true;
+    std::shared_ptr<vs::Decoder> keys = vs::open_file(kVIDEO_PATH, NULL, options);
+    BOOST_REQUIRE(all->error() == NULL);
+    BOOST_REQUIRE(keys->error() == NULL);
+    BOOST_CHECK_EQUAL(keys->count(), all->count());
+
+    std::vector<uint32_t> positions;
+    std::vector<std::vector<unsigned char> > frames;
+    for (;;) {
+        if (all->key_frame()) {
+            positions.push_back(all->position());
+            frames.push_back(frame_copy(all.get()));
+        }
+        uint32_t position = all->position();
+        all->next();
+        if (all->position() <= position) {
+            break;
+        }
+    }
+    BOOST_REQUIRE(!positions.empty());
+
+    // the same frames, numbered as in the whole video
+    for (size_t i = 0; i < positions.size(); ++i) {
+        BOOST_CHECK_EQUAL(keys->position(), positions[i]);
+        BOOST_CHECK(keys->key_frame());
+        BOOST_CHECK(frame_copy(keys.get()) == frames[i]);
+        uint32_t position = keys->position();
+        keys->next();
+        if (keys->position() <= position) {
+            break;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_key_frames_only_seek_stops_at_the_key_frame_before) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = vs::decoder_threads_none;
+    std::shared_ptr<vs::Decoder> exact = vs::open_file(kVIDEO_PATH, NULL, options);
+    options.key_frames_only = true;
+    std::shared_ptr<vs::Decoder> keys = vs::open_file(kVIDEO_PATH, NULL, options);
+    BOOST_REQUIRE(exact->error() == NULL);
+    BOOST_REQUIRE(keys->error() == NULL);
+
+    const int64_t targets[] = {25, 2, 17, 30, 5};
+    for (int64_t target : targets) {
+        keys->seek_frame(target);
+        BOOST_CHECK(keys->key_frame());
+        BOOST_CHECK_LE(keys->position(), target);
+
+        exact->seek_frame(keys->position());
+        BOOST_CHECK(exact->key_frame());
+        BOOST_CHECK(frame_copy(keys.get()) == frame_copy(exact.get()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_seek_keyframe_stops_at_the_key_frame_before) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = vs::decoder_threads_none;
+    std::shared_ptr<vs::Decoder> exact = vs::open_file(kVIDEO_PATH, NULL, options);
+    std::shared_ptr<vs::Decoder> scrub = vs::open_file(kVIDEO_PATH, NULL, options);
+    BOOST_REQUIRE(exact->error() == NULL);
+    BOOST_REQUIRE(scrub->error() == NULL);
+
+    const int64_t targets[] = {25, 2, 17, 30, 5, 1};
+    for (int64_t target : targets) {
+        scrub->seek_keyframe(target);
+        BOOST_CHECK(scrub->key_frame());
+        BOOST_CHECK_LE(scrub->position(), target);
+
+        exact->seek_frame(scrub->position());
+        BOOST_CHECK(frame_copy(scrub.get()) == frame_copy(exact.get()));
+    }
+
+    // an interruption without a seek in progress does not reach the next one
+    scrub->interrupt_seek();
+    scrub->seek_frame(27);
+    BOOST_CHECK_EQUAL(scrub->position(), 27u);
+
+    // unless the seek was requested before it: it stops where it lands (before a frame that is not a key one)
+    scrub->seek_keyframe(27);
+    uint32_t target = scrub->position() == 27 ? 26 : 27;
+    scrub->seek_frame(1);
+    uint32_t generation = scrub->seek_generation();
+    scrub->interrupt_seek();
+    scrub->claim_seek_generation(generation);
+    scrub->seek_frame(target);
+    BOOST_CHECK_LT(scrub->position(), target);
+
+    scrub->claim_seek_generation(scrub->seek_generation());
+    scrub->seek_frame(target);
+    BOOST_CHECK_EQUAL(scrub->position(), target);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+namespace {
+
+const char *kINDEX_PATH = "data/tmp/test_keyframe_index.keyframes";
+
+bool wait_index_file() {
+    for (int i = 0; i < 100 && !boost::filesystem::exists(kINDEX_PATH); ++i) {
+        boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+    }
+    return boost::filesystem::exists(kINDEX_PATH);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(keyframe_index_tests)
+
+BOOST_AUTO_TEST_CASE(test_index_is_stored) {
+    boost::filesystem::remove(kINDEX_PATH);
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(kVIDEO_PATH, kINDEX_PATH);
+    BOOST_REQUIRE(decoder->error() == NULL);
+    BOOST_CHECK(wait_index_file());
+    BOOST_CHECK(decoder->save_keyframe_index("data/tmp/test_keyframe_index_copy.keyframes"));
+    BOOST_CHECK(boost::filesystem::exists("data/tmp/test_keyframe_index_copy.keyframes"));
+    boost::filesystem::remove("data/tmp/test_keyframe_index_copy.keyframes");
+}
+
+BOOST_AUTO_TEST_CASE(test_indexed_seek_matches_sequential_decoding) {
+    std::shared_ptr<vs::Decoder> sequential = vs::open_file(kVIDEO_PATH);
+    BOOST_REQUIRE(sequential->error() == NULL);
+
+    std::vector<std::vector<unsigned char> > frames;
+    frames.push_back(frame_copy(sequential.get()));
+    for (int i = 1; i < 30; ++i) {
+        sequential->next();
+        frames.push_back(frame_copy(sequential.get()));
+    }
+
+    std::shared_ptr<vs::Decoder> indexed = vs::open_file(kVIDEO_PATH, kINDEX_PATH);
+    BOOST_REQUIRE(wait_index_file());
+
+    const int64_t targets[] = {25, 2, 17, 18, 30, 5, 29};
+    for (int64_t target : targets) {
+        indexed->seek_frame(target);
+        BOOST_CHECK_EQUAL(indexed->position(), target);
+        BOOST_CHECK(frame_copy(indexed.get()) == frames[target - 1]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <string.h>
+#include <vector>
+#include "tests/testing.h"
+#include "src/vstream/ffmpeg_stream.h"
+#include "tests/test_vstream/helpers.h"
+
+namespace {
+
+std::shared_ptr<vs::Decoder> open_video(int convert_threads) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.convert_threads = convert_threads;
+    return vs::open_file(kVIDEO_PATH, NULL, options);
+}
+
+vs::AVFramePtr gray_picture(int convert_threads) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.convert_threads = convert_threads;
+    vs::FFMpegStream stream(vs::video_color_gray);
+    stream.set_decoder_options(options);
+    if (!stream.open(kVIDEO_PATH) || !stream.next_frame()) {
+        return vs::AVFramePtr();
+    }
+    return stream.get_picture_ref();
+}
+
+bool same_area(const unsigned char *a, const unsigned char *b, uint32_t w, const vs::frame_area_t& area) {
+    for (int y = area.y; y < area.y + area.h; ++y) {
+        uint32_t offset = (y * w + area.x) * 3;
+        if (memcmp(a + offset, b + offset, area.w * 3)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(picture_conversion_tests)
+
+BOOST_AUTO_TEST_CASE(test_bands_match_the_single_conversion) {
+    std::shared_ptr<vs::Decoder> single = open_video(1);
+    std::shared_ptr<vs::Decoder> bands = open_video(4);
+    BOOST_REQUIRE(single->error() == NULL);
+    BOOST_REQUIRE(bands->error() == NULL);
+
+    for (int i = 0; i < 10; ++i) {
+        BOOST_CHECK(frame_copy(bands.get()) == frame_copy(single.get()));
+        single->next();
+        bands->next();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_gray_pictures_have_one_byte_by_pixel) {
+    vs::AVFramePtr single = gray_picture(1);
+    vs::AVFramePtr bands = gray_picture(4);
+    BOOST_REQUIRE(single);
+    BOOST_REQUIRE(bands);
+    BOOST_CHECK_EQUAL(single->format, AV_PIX_FMT_GRAY8);
+    BOOST_CHECK_EQUAL(single->linesize[0], single->width);
+    BOOST_CHECK(memcmp(single->data[0], bands->data[0], single->width * single->height) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_frame_converts_the_area) {
+    std::shared_ptr<vs::Decoder> full = open_video(1);
+    std::shared_ptr<vs::Decoder> partial = open_video(1);
+    BOOST_REQUIRE(full->error() == NULL);
+    BOOST_REQUIRE(partial->error() == NULL);
+
+    full->seek_frame(10);
+    partial->seek_frame(10);
+
+    const vs::frame_area_t area = {
+        static_cast<int>(full->w() / 3) + 1, static_cast<int>(full->h() / 3) + 1, 45, 37};
+
+    vs::frame_ref_t frame = partial->partial_frame(area);
+    BOOST_REQUIRE(frame);
+    BOOST_CHECK_EQUAL(frame->position(), 10u);
+    BOOST_CHECK_EQUAL(frame->stride(), static_cast<int>(full->w() * 3));
+    BOOST_CHECK(same_area(frame->data(), full->buffer(), full->w(), area));
+
+    // the partial frame is not taken as the full one
+    BOOST_CHECK(frame_copy(partial.get()) == frame_copy(full.get()));
+    BOOST_CHECK(partial->frame() != frame);
+    BOOST_CHECK(partial->partial_frame(area) == partial->frame());
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_frame_at_the_borders) {
+    std::shared_ptr<vs::Decoder> full = open_video(1);
+    std::shared_ptr<vs::Decoder> partial = open_video(4);
+    BOOST_REQUIRE(full->error() == NULL);
+    BOOST_REQUIRE(partial->error() == NULL);
+
+    const vs::frame_area_t area = {
+        static_cast<int>(full->w()) - 11, static_cast<int>(full->h()) - 7, 11, 7};
+
+    BOOST_CHECK(same_area(partial->partial_frame(area)->data(), full->buffer(), full->w(), area));
+}
+
+BOOST_AUTO_TEST_CASE(test_scaled_frame_fits_the_size) {
+    std::shared_ptr<vs::Decoder> decoder = open_video(1);
+    BOOST_REQUIRE(decoder->error() == NULL);
+
+    uint32_t max_w = decoder->w() / 2;
+    vs::frame_ref_t scaled = decoder->scaled_frame(max_w, decoder->h());
+    BOOST_REQUIRE(scaled);
+    BOOST_CHECK_EQUAL(scaled->w(), max_w);
+    BOOST_CHECK(scaled->h() <= decoder->h() / 2);
+    BOOST_CHECK(scaled->h() + 1 >= decoder->h() / 2);
+    BOOST_CHECK_EQUAL(scaled->stride(), static_cast<int>(scaled->w() * 3));
+    BOOST_CHECK_EQUAL(scaled->position(), decoder->position());
+
+    // the same frame is not resized again
+    BOOST_CHECK(decoder->scaled_frame(max_w, decoder->h())->data() == scaled->data());
+
+    decoder->next();
+    vs::frame_ref_t next = decoder->scaled_frame(max_w, decoder->h());
+    BOOST_CHECK(next->data() != scaled->data());
+    BOOST_CHECK_EQUAL(next->position(), 2u);
+
+    // the frames that fit are not resized
+    BOOST_CHECK(decoder->scaled_frame(decoder->w(), decoder->h()) == decoder->frame());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
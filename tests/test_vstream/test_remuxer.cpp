@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <boost/filesystem.hpp>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+namespace {
+
+const char *kOUTPUT_PATH = "data/tmp/test_remuxer.webm";
+
+uint32_t remux(int64_t first_frame, int64_t last_frame) {
+    boost::filesystem::remove(kOUTPUT_PATH);
+
+    std::shared_ptr<vs::Remuxer> remuxer = vs::remuxer("webm", kVIDEO_PATH, kOUTPUT_PATH);
+    BOOST_REQUIRE(remuxer->error() == NULL);
+    BOOST_REQUIRE(remuxer->can_remux(first_frame, last_frame));
+
+    uint32_t copied = 0;
+    BOOST_CHECK(remuxer->remux(first_frame, last_frame, [&copied] (uint32_t copied_frames) -> bool {
+        copied = copied_frames;
+        return true;
+    }));
+
+    return copied;
+}
+
+void check_output(int64_t frame_count) {
+    std::shared_ptr<vs::Decoder> source = vs::open_file(kVIDEO_PATH);
+    std::shared_ptr<vs::Decoder> output = vs::open_file(kOUTPUT_PATH);
+
+    BOOST_REQUIRE(output->error() == NULL);
+    BOOST_CHECK_EQUAL(output->w(), source->w());
+    BOOST_CHECK_EQUAL(output->h(), source->h());
+
+    // every copied frame must be decodable
+    for (int64_t i = 1; i < frame_count; ++i) {
+        output->next();
+    }
+
+    BOOST_CHECK_EQUAL(output->position(), frame_count);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(remuxer_tests)
+
+BOOST_AUTO_TEST_CASE(test_remux_from_key_frame) {
+    BOOST_CHECK_EQUAL(remux(1, 20), 20u);
+    check_output(20);
+}
+
+BOOST_AUTO_TEST_CASE(test_remux_encodes_the_head) {
+    BOOST_CHECK_EQUAL(remux(3, 24), 22u);
+    check_output(22);
+}
+
+BOOST_AUTO_TEST_CASE(test_remux_rejects_other_formats) {
+    std::shared_ptr<vs::Remuxer> remuxer = vs::remuxer("mp4-x264", kVIDEO_PATH, kOUTPUT_PATH);
+    BOOST_CHECK(!remuxer->can_remux(1, 20));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <vector>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+BOOST_AUTO_TEST_SUITE(reverse_decoding_tests)
+
+BOOST_AUTO_TEST_CASE(test_prior_matches_sequential_decoding) {
+    std::shared_ptr<vs::Decoder> decoder = vs::open_file(kVIDEO_PATH);
+    BOOST_REQUIRE(decoder->error() == NULL);
+
+    std::vector<std::vector<unsigned char> > frames;
+    frames.push_back(frame_copy(decoder.get()));
+    for (int i = 1; i < 30; ++i) {
+        decoder->next();
+        frames.push_back(frame_copy(decoder.get()));
+    }
+
+    BOOST_REQUIRE_EQUAL(decoder->position(), 30u);
+
+    for (uint32_t frame = 29; frame > 0; --frame) {
+        decoder->prior();
+        BOOST_CHECK_EQUAL(decoder->position(), frame);
+        BOOST_CHECK(frame_copy(decoder.get()) == frames[frame - 1]);
+    }
+
+    // going forward again after stepping backwards
+    for (uint32_t frame = 2; frame <= 30; ++frame) {
+        decoder->next();
+        BOOST_CHECK_EQUAL(decoder->position(), frame);
+        BOOST_CHECK(frame_copy(decoder.get()) == frames[frame - 1]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <vector>
+#include "tests/testing.h"
+#include "tests/test_vstream/helpers.h"
+
+BOOST_AUTO_TEST_SUITE(skip_non_reference_tests)
+
+BOOST_AUTO_TEST_CASE(test_seek_frame_is_exact_while_skipping) {
+    vs::decoder_options_t options = vs::default_decoder_options();
+    options.thread_type = vs::decoder_threads_none;
+    std::shared_ptr<vs::Decoder> exact = vs::open_file(kVIDEO_PATH, NULL, options);
+    std::shared_ptr<vs::Decoder> skipping = vs::open_file(kVIDEO_PATH, NULL, options);
+    BOOST_REQUIRE(exact->error() == NULL);
+    BOOST_REQUIRE(skipping->error() == NULL);
+
+    skipping->skip_non_reference(true);
+
+    const int64_t targets[] = {25, 2, 17, 30, 5, 1, 26};
+    for (int64_t target : targets) {
+        exact->seek_frame(target);
+        skipping->seek_frame(target);
+        BOOST_CHECK_EQUAL(skipping->position(), exact->position());
+        BOOST_CHECK_EQUAL(skipping->pts(), exact->pts());
+        BOOST_CHECK(frame_copy(skipping.get()) == frame_copy(exact.get()));
+    }
+
+    // the frames after the seek are still numbered by their timestamps
+    uint32_t position = skipping->position();
+    skipping->next();
+    BOOST_CHECK_GT(skipping->position(), position);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
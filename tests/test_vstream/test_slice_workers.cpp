@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 by Rodrigo Antonio de Araujo
+ */
+#include <atomic>
+#include <vector>
+#include "tests/testing.h"
+#include "src/vstream/slice_workers.h"
+
+BOOST_AUTO_TEST_SUITE(slice_workers_tests)
+
+BOOST_AUTO_TEST_CASE(test_every_slice_runs_once) {
+    vs::SliceWorkers workers(3);
+    BOOST_CHECK_EQUAL(workers.threads(), 3);
+
+    for (int job = 0; job < 100; ++job) {
+        std::vector<std::atomic_int> calls(7);
+        for (auto & c : calls) {
+            c = 0;
+        }
+
+        workers.run(calls.size(), [&calls] (int slice) {
+            ++calls[slice];
+        });
+
+        for (auto & c : calls) {
+            BOOST_CHECK_EQUAL(c.load(), 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_slices_run_in_parallel) {
+    vs::SliceWorkers workers(1);
+    std::atomic_int arrived(0);
+    bool met = true;
+
+    // each slice waits the other one: a single thread would give up
+    workers.run(2, [&arrived, &met] (int slice) {
+        ++arrived;
+        for (int i = 0; i < 2000 && arrived.load() < 2; ++i) {
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+        }
+        if (arrived.load() < 2) {
+            met = false;
+        }
+    });
+
+    BOOST_CHECK(met);
+}
+
+BOOST_AUTO_TEST_CASE(test_without_threads) {
+    vs::SliceWorkers workers(0);
+    std::vector<int> order;
+
+    workers.run(3, [&order] (int slice) {
+        order.push_back(slice);
+    });
+
+    BOOST_REQUIRE_EQUAL(order.size(), 3u);
+    BOOST_CHECK_EQUAL(order[0], 0);
+    BOOST_CHECK_EQUAL(order[2], 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()